@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/asset/archive_format.h>
+#include <root/core/buffer_slice.h>
+#include <root/core/error.h>
+#include <root/core/primitives.h>
+#include <root/core/string_view.h>
+#include <root/io/mapped_buffer.h>
+
+namespace root {
+
+/**
+ * Read-only view of a packed asset archive mapped into memory. Finding an
+ * asset is a hash and usually a single probe, with no file system access.
+ */
+class archive {
+public:
+    inline archive() {}
+
+    /**
+     * Map the archive at path. The archive is invalid if it can't be mapped or
+     * its header and index don't fit the file.
+     */
+    explicit archive(const string_view& path);
+
+    archive(const archive&) = delete;
+    archive(archive&&) = default;
+
+    auto operator=(const archive&) -> archive& = delete;
+    auto operator=(archive&&) -> archive& = default;
+
+    inline operator bool() const {
+        return m_mapping;
+    }
+
+    inline auto count() const -> u64 {
+        return *this ? header()->m_entry_count : 0;
+    }
+
+    /**
+     * @return the asset's bytes inside the mapping, or an empty slice if the
+     * archive has no asset called id or it is compressed. Valid while the
+     * archive is alive.
+     */
+    auto find(const string_view& id) const -> buffer_slice;
+
+    /**
+     * @return size of the asset once read, NOT_FOUND if there is none called id.
+     */
+    auto size(const string_view& id) const -> value_or_error<u64>;
+
+    /**
+     * Copy the asset into dst, which must hold size(id) bytes, decompressing
+     * it if need be. Assets of several chunks are decompressed in parallel on
+     * the job system.
+     */
+    auto read(const string_view& id, void* dst) const -> error;
+
+    /**
+     * Check every asset against its checksum.
+     * @return true if all of them match.
+     */
+    auto verify() const -> bool;
+
+private:
+    inline auto header() const -> const archive_format::header* {
+        return static_cast<const archive_format::header*>(m_mapping.data());
+    }
+
+    inline auto index() const -> const archive_format::entry* {
+        return reinterpret_cast<const archive_format::entry*>(static_cast<const u8*>(m_mapping.data()) + header()->m_index_offset);
+    }
+
+    inline auto stored(const archive_format::entry& e) const -> const u8* {
+        return static_cast<const u8*>(m_mapping.data()) + e.m_offset;
+    }
+
+    inline auto name(const archive_format::entry& e) const -> string_view {
+        return string_view(static_cast<const i8*>(m_mapping.data()) + e.m_name_offset, 0, e.m_name_size);
+    }
+
+    auto find_entry(const string_view& id) const -> const archive_format::entry*;
+    auto validate() const -> bool;
+    auto decompress(const archive_format::entry& e, u8* dst) const -> error;
+
+    mapped_buffer m_mapping;
+};
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/asset/archive_format.h>
+#include <root/core/buffer.h>
+#include <root/core/error.h>
+#include <root/core/primitives.h>
+#include <root/core/string.h>
+#include <root/core/string_view.h>
+#include <root/io/stream.h>
+
+namespace root {
+
+/**
+ * Collects assets and writes them out as a packed archive for archive to
+ * read. Used by the root_pack tool.
+ */
+class archive_builder {
+public:
+    explicit archive_builder(allocator* alloc = allocator::get_default(),
+                             const u64& chunk_size = archive_format::DEFAULT_CHUNK_SIZE);
+
+    archive_builder(const archive_builder&) = delete;
+    auto operator=(const archive_builder&) -> archive_builder& = delete;
+
+    /**
+     * Take data as the asset called id, compressing it if asked to and it
+     * ends up any smaller.
+     * @return false if id is empty or already added.
+     */
+    auto add(const string_view& id, buffer&& data, const bool& compress = false) -> bool;
+
+    /**
+     * @return bytes the assets will take in the archive.
+     */
+    inline auto stored_size() const -> u64 {
+        return m_stored_size;
+    }
+
+    inline auto count() const -> u64 {
+        return m_count;
+    }
+
+    /**
+     * Write the archive from the stream's current position, which is taken to
+     * be the start of the file.
+     */
+    auto write(stream& out) const -> error;
+
+    ~archive_builder();
+
+private:
+    struct pending_asset {
+        pending_asset(string&& id, const u64& hash, buffer&& data, const u64& size, const u32& flags)
+        :   m_id(std::move(id)), m_hash(hash), m_data(std::move(data)), m_size(size), m_flags(flags) {}
+
+        string m_id;
+        u64 m_hash;
+        // As stored in the archive
+        buffer m_data;
+        u64 m_size;
+        u32 m_flags;
+        pending_asset* m_next{nullptr};
+    };
+
+    /**
+     * @return data as a chunk table and chunks, or an empty buffer if that
+     * isn't smaller.
+     */
+    auto compress_chunks(const buffer& data) const -> buffer;
+
+    allocator* m_allocator;
+    u64 m_chunk_size;
+    u64 m_stored_size{0};
+    pending_asset* m_first{nullptr};
+    pending_asset* m_last{nullptr};
+    u64 m_count{0};
+};
+
+} // namespace root
\ No newline at end of file
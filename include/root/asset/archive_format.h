@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+
+namespace root {
+
+/**
+ * On disk layout of a packed asset archive, little endian throughout:
+ *
+ *  header
+ *  index    bucket_count entries, an open addressing hash table on the FNV-1a
+ *           hash of the id with linear probing. Empty buckets have no name.
+ *  names    ids of every asset, not null terminated
+ *  data     every asset's bytes, each starting on a DATA_ALIGNMENT boundary
+ *
+ * Offsets are from the start of the file.
+ *
+ * A COMPRESSED asset is stored as one u32 per chunk_size bytes of the asset,
+ * the stored size of that chunk, followed by the chunks themselves. Each chunk
+ * is an LZ4 block, or the chunk's bytes as they are when RAW_CHUNK is set, so
+ * chunks can be decompressed independently.
+ */
+namespace archive_format {
+
+constexpr u32 MAGIC = 0x4b415052; // "RPAK"
+constexpr u32 VERSION = 2;
+constexpr u64 DATA_ALIGNMENT = 16;
+constexpr u64 DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+// entry::m_flags
+constexpr u32 COMPRESSED = 1u << 0;
+
+// Chunk sizes in a compressed asset's chunk table
+constexpr u32 RAW_CHUNK = 1u << 31;
+
+struct header {
+    u32 m_magic;
+    u32 m_version;
+    u64 m_entry_count;
+    u64 m_bucket_count;
+    u64 m_index_offset;
+    u64 m_names_offset;
+    u64 m_names_size;
+    u64 m_chunk_size;
+};
+
+struct entry {
+    u64 m_hash;
+    u64 m_offset;
+    // Size of the asset once decompressed
+    u64 m_size;
+    // Bytes taken in the archive
+    u64 m_stored_size;
+    // FNV-1a of the stored bytes
+    u64 m_checksum;
+    u64 m_name_offset;
+    u32 m_name_size;
+    u32 m_flags;
+};
+
+static_assert(sizeof(header) == 56);
+static_assert(sizeof(entry) == 56);
+
+inline auto chunk_count(const u64& size, const u64& chunk_size) -> u64 {
+    return (size + chunk_size - 1) / chunk_size;
+}
+
+} // namespace archive_format
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/buffer.h>
+#include <root/core/primitives.h>
+#include <root/core/string.h>
+#include <root/core/string_view.h>
+#include <root/memory/intrusive_ptr.h>
+#include <root/memory/intrusive_ref_counted.h>
+
+#include <mutex>
+
+namespace root {
+
+class asset_cache;
+
+/**
+ * An asset's contents as held by the asset_cache.
+ */
+class cached_asset final : public intrusive_ref_counted<cached_asset> {
+public:
+    cached_asset(string&& id, const u64& hash, buffer&& data);
+
+    cached_asset(const cached_asset&) = delete;
+    auto operator=(const cached_asset&) -> cached_asset& = delete;
+
+    inline auto id() const -> string_view {
+        return m_id;
+    }
+
+    inline auto data() const -> const buffer& {
+        return m_data;
+    }
+
+    inline auto size() const -> u64 {
+        return m_data.size();
+    }
+
+private:
+    string m_id;
+    u64 m_hash;
+    buffer m_data;
+
+    // Owned by the asset_cache while the asset is in it
+    intrusive_ptr<cached_asset> m_cache_reference;
+    cached_asset* m_next_in_bucket{nullptr};
+    cached_asset* m_newer{nullptr};
+    cached_asset* m_older{nullptr};
+
+    friend class asset_cache;
+};
+
+using asset_ref = intrusive_ptr<cached_asset>;
+
+/**
+ * Assets by id, kept within a byte budget by evicting the least recently used
+ * first. An asset somebody still holds an asset_ref to is skipped by eviction
+ * until it is released, so the budget can be overrun while everything in the
+ * cache is in use.
+ */
+class asset_cache {
+public:
+    constexpr static u64 INITIAL_BUCKETS = 64;
+
+    explicit asset_cache(const u64& budget, allocator* alloc = allocator::get_default());
+
+    asset_cache(const asset_cache&) = delete;
+    auto operator=(const asset_cache&) -> asset_cache& = delete;
+
+    /**
+     * @return the asset, marked as most recently used, or a null asset_ref.
+     * Counts as a hit or a miss.
+     */
+    auto find(const string_view& id) -> asset_ref;
+
+    /**
+     * Add data under id, evicting to make room. If id is already cached the
+     * existing asset is returned and data dropped.
+     */
+    auto insert(const string_view& id, buffer&& data) -> asset_ref;
+
+    /**
+     * Evict least recently used assets nobody holds until within budget.
+     */
+    auto trim() -> void;
+
+    /**
+     * Evict everything nobody holds.
+     */
+    auto clear() -> void;
+
+    auto set_budget(const u64& budget) -> void;
+
+    inline auto budget() const -> u64 {
+        return m_budget;
+    }
+
+    /**
+     * @return bytes of the assets in the cache.
+     */
+    auto bytes() const -> u64;
+
+    auto count() const -> u64;
+
+    auto hits() const -> u64;
+
+    auto misses() const -> u64;
+
+    auto evictions() const -> u64;
+
+    ~asset_cache();
+
+private:
+    auto lookup(const string_view& id, const u64& hash) const -> cached_asset*;
+    auto unlink(cached_asset* asset) -> void;
+    auto push_newest(cached_asset* asset) -> void;
+    auto grow() -> void;
+    auto evict_until(const u64& bytes) -> void;
+
+    allocator* m_allocator;
+    mutable std::mutex m_lock;
+    cached_asset** m_buckets;
+    u64 m_bucket_count;
+    // Most and least recently used ends of the LRU list
+    cached_asset* m_newest{nullptr};
+    cached_asset* m_oldest{nullptr};
+    u64 m_budget;
+    u64 m_bytes{0};
+    u64 m_count{0};
+    u64 m_hits{0};
+    u64 m_misses{0};
+    u64 m_evictions{0};
+};
+
+} // namespace root
\ No newline at end of file
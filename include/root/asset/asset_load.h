@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/buffer.h>
+#include <root/core/primitives.h>
+#include <root/core/string.h>
+#include <root/core/string_view.h>
+#include <root/jobs/job.h>
+#include <root/memory/intrusive_ptr.h>
+#include <root/memory/intrusive_ref_counted.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace root {
+
+class asset_streamer;
+
+/**
+ * An asset being read in the background, shared by everyone who asked for the
+ * same file while it was in flight. Poll done() or attach a continuation with
+ * then(); data() is only valid once the load is ready.
+ */
+class asset_load final : public intrusive_ref_counted<asset_load> {
+public:
+    enum class state : u8 {
+        pending = 0,
+        ready = 1,
+        failed = 2
+    };
+
+    /**
+     * path must be null terminated. destination is read into if it is big
+     * enough, otherwise a buffer is taken from alloc.
+     */
+    asset_load(string&& path, buffer&& destination, allocator* alloc);
+
+    asset_load(const asset_load&) = delete;
+    auto operator=(const asset_load&) -> asset_load& = delete;
+
+    inline auto status() const -> state {
+        return m_state.load(std::memory_order_acquire);
+    }
+
+    inline auto done() const -> bool {
+        return status() != state::pending;
+    }
+
+    inline auto path() const -> string_view {
+        return m_path;
+    }
+
+    /**
+     * @return the buffer holding the file, valid while status() is ready. It
+     * may be bigger than the file if the caller supplied it.
+     */
+    auto data() -> buffer&;
+
+    /**
+     * @return size of the file in bytes, valid while status() is ready.
+     */
+    inline auto size() const -> u64 {
+        return m_size;
+    }
+
+    /**
+     * Run j on the job system once the load is done, straight away if it
+     * already is. j must stay alive until it has run.
+     */
+    auto then(jobs::job* j) -> void;
+
+    /**
+     * Block until the load is done, helping the job system meanwhile.
+     */
+    auto wait() -> void;
+
+private:
+    struct continuation {
+        jobs::job* m_job;
+        continuation* m_next;
+    };
+
+    auto complete(const state& result) -> void;
+
+    string m_path;
+    buffer m_buffer;
+    allocator* m_buffer_allocator;
+    std::atomic<state> m_state{state::pending};
+    std::mutex m_lock;
+    continuation* m_continuations{nullptr};
+
+    // Owned by the asset_streamer while the load is pending
+    intrusive_ptr<asset_load> m_self;
+    jobs::counter* m_jobs{nullptr};
+    asset_load* m_next_loading{nullptr};
+    asset_load* m_next_queued{nullptr};
+    int m_fd{-1};
+    u64 m_size{0};
+    u64 m_offset{0};
+
+    friend class asset_streamer;
+};
+
+using asset_handle = intrusive_ptr<asset_load>;
+
+} // namespace root
\ No newline at end of file
@@ -19,32 +19,86 @@
 
 #pragma once
 
+#include <root/asset/archive.h>
+#include <root/asset/asset_cache.h>
+#include <root/asset/asset_load.h>
+#include <root/asset/private/asset_streamer.h>
 #include <root/core/buffer.h>
 #include <root/core/string.h>
 #include <root/core/string_view.h>
+#include <root/io/mapped_buffer.h>
 #include <root/io/path.h>
 
 namespace root {
 
 class asset_manager {
 public:
+    constexpr static u64 DEFAULT_CACHE_BUDGET = 64 * 1024 * 1024;
+
+    /**
+     * Set up the manager, otherwise it is made on first use with the defaults.
+     */
+    static auto init(const string_view& asset_root = path::binary_location(), 
+                     allocator* alloc = allocator::get_default(),
+                     const u64& cache_budget = DEFAULT_CACHE_BUDGET) -> void;
+
+    static auto deinit() -> void;
+
+    /**
+     * Serve assets out of the packed archive archive_id under the asset root,
+     * falling back to loose files for ids it doesn't have.
+     * @return false if the archive couldn't be opened.
+     */
+    static auto mount(const string_view& archive_id) -> bool;
+
+    /**
+     * @return the asset from the cache, only reading it from disk on a miss.
+     */
+    static auto load(const string_view& id) -> asset_ref;
+
+    static auto cache() -> asset_cache&;
+
     // TODO: May be temporary
     static auto raw_load(const string_view& id) -> buffer;
 
+    /**
+     * Read the asset in the background into a buffer from the manager's
+     * allocator. Asking again for an asset still loading returns the same
+     * handle.
+     */
+    static auto load_async(const string_view& id) -> asset_handle;
+
+    /**
+     * Like load_async(id) but reads into destination when it is big enough.
+     * destination is left alone if the asset was already loading.
+     */
+    static auto load_async(const string_view& id, buffer&& destination) -> asset_handle;
+
+    /**
+     * Map the asset read-only instead of copying it into a buffer. The data
+     * stays valid for as long as the returned mapped_buffer.
+     */
+    static auto raw_map(const string_view& id, const access_pattern& pattern = access_pattern::sequential) -> mapped_buffer;
+
     // Might need to uncomment this if all default parameters are removed
     //asset_manager() = delete;
     asset_manager(const asset_manager&) = delete;
     asset_manager(asset_manager&&) = delete;
 private:
     explicit asset_manager(const string_view& asset_root = path::binary_location(), 
-                           allocator* alloc = allocator::get_default());
+                           allocator* alloc = allocator::get_default(),
+                           const u64& cache_budget = DEFAULT_CACHE_BUDGET);
 
     auto load_buffer(const string_view& id) -> buffer;
+    auto map_buffer(const string_view& id, const access_pattern& pattern) -> mapped_buffer;
 
     static asset_manager* m_manager;
 
     allocator* m_alloc;
     string m_asset_root;
+    asset_streamer m_streamer;
+    asset_cache m_cache;
+    archive m_archive;
 };
 
 } // namespace root
\ No newline at end of file
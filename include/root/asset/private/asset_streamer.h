@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/asset/asset_load.h>
+#include <root/core/primitives.h>
+#include <root/jobs/job.h>
+#include <root/memory/allocator.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace root {
+
+struct io_ring;
+
+/**
+ * Reads whole files in the background for asset_manager::load_async.
+ *
+ * On Linux one I/O thread batches reads through io_uring, opening the files
+ * itself so the caller never touches the disk. Where io_uring isn't available,
+ * or once it has failed, every load becomes a job that reads the file on a
+ * worker instead.
+ *
+ * Loads of a path that is still pending are coalesced into one.
+ */
+class asset_streamer {
+public:
+    constexpr static u32 QUEUE_DEPTH = 64;
+
+    explicit asset_streamer(allocator* alloc = allocator::get_default(), const bool& use_io_uring = true);
+
+    asset_streamer(const asset_streamer&) = delete;
+    auto operator=(const asset_streamer&) -> asset_streamer& = delete;
+
+    /**
+     * Start reading the null terminated path, or join the load already
+     * reading it. destination is only moved from when a new load is started.
+     */
+    auto load(string&& path, buffer&& destination) -> asset_handle;
+
+    /**
+     * @return true when reads go through io_uring rather than jobs.
+     */
+    inline auto uses_io_uring() const -> bool {
+        return m_ring && !m_ring_failed.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Finishes every pending load before returning.
+     */
+    ~asset_streamer();
+
+private:
+    auto finish(asset_load* load, const asset_load::state& result) -> void;
+    auto open(asset_load* load) -> bool;
+    auto read_blocking(asset_load* load) -> asset_load::state;
+    auto io_loop() -> void;
+    auto fail_ring() -> void;
+
+    allocator* m_allocator;
+    io_ring* m_ring{nullptr};
+    std::thread m_io_thread;
+
+    std::mutex m_lock;
+    std::condition_variable m_wake;
+    bool m_running{true};
+    // Set under m_lock when io_uring_enter fails, loads go to jobs from then on
+    std::atomic<bool> m_ring_failed{false};
+    // Every pending load, searched to coalesce requests
+    asset_load* m_loading{nullptr};
+    // Loads the I/O thread hasn't submitted yet, oldest first
+    asset_load* m_queued_head{nullptr};
+    asset_load* m_queued_tail{nullptr};
+    // Reads running as jobs when there is no ring
+    jobs::counter m_jobs;
+
+    friend struct read_job;
+};
+
+} // namespace root
\ No newline at end of file
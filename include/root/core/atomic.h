@@ -19,8 +19,23 @@
 
 #pragma once
 
+#include <root/core/primitives.h>
+
 namespace root {
 
+/**
+ * Size that keeps data touched by different threads from sharing a cache line.
+ * Twice the usual line size as adjacent line prefetchers pull lines in pairs.
+ */
+constexpr u64 CACHE_LINE_SIZE = 64;
+constexpr u64 FALSE_SHARING_RANGE = 2 * CACHE_LINE_SIZE;
 
+/**
+ * T alone on its own cache lines.
+ */
+template<typename T>
+struct alignas(FALSE_SHARING_RANGE) cache_padded {
+    T m_value;
+};
 
 } // namespace root
\ No newline at end of file
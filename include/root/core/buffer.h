@@ -55,6 +55,10 @@ public:
 
     inline auto operator=(const buffer& other) -> buffer& = delete;
     inline auto operator=(buffer&& other) -> buffer&{
+        if(this == &other) return *this;
+        if(m_data && m_allocator && m_byte_size) {
+            m_allocator->free(m_data);
+        }
         m_data = std::move(other.m_data);
         m_byte_size = std::move(other.m_byte_size);
         m_alignment = std::move(other.m_alignment);
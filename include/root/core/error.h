@@ -17,6 +17,8 @@
  * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#pragma once
+
 #include <root/core/assert.h>
 #include <root/core/primitives.h>
 
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/core/string_view.h>
+
+namespace root {
+
+constexpr u64 FNV1A_OFFSET_BASIS = 14695981039346656037ull;
+constexpr u64 FNV1A_PRIME = 1099511628211ull;
+
+/**
+ * 64 bit FNV-1a. Cheap for short keys such as asset ids and stable across
+ * runs, so it can be stored on disk. Pass a previous result as seed to hash
+ * data in pieces.
+ */
+inline auto fnv1a(const void* data, const u64& size, const u64& seed = FNV1A_OFFSET_BASIS) -> u64 {
+    const u8* bytes = static_cast<const u8*>(data);
+    u64 hash = seed;
+    for(u64 i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV1A_PRIME;
+    }
+    return hash;
+}
+
+inline auto fnv1a(const string_view& str) -> u64 {
+    return fnv1a(str.data(), str.size());
+}
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/assert.h>
+#include <root/core/atomic.h>
+#include <root/core/primitives.h>
+#include <root/memory/allocator.h>
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace root {
+
+/**
+ * Bounded lock-free multi-producer multi-consumer FIFO queue.
+ *
+ * Each cell carries a sequence number telling producers and consumers whose
+ * turn it is, so claiming a cell is a single CAS on the enqueue or dequeue
+ * position and nobody ever waits on another thread (D. Vyukov's design).
+ * Capacity must be a power of two.
+ */
+template<typename T>
+class mpmc_queue final {
+public:
+    explicit mpmc_queue(const u64& capacity, allocator* alloc = allocator::get_default())
+    :   m_cells(nullptr),
+        m_mask(capacity - 1),
+        m_allocator(alloc) {
+        root_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+        m_cells = static_cast<cell*>(m_allocator->malloc(sizeof(cell) * capacity, alignof(cell)));
+        for(u64 i = 0; i < capacity; i++) {
+            new (&m_cells[i]) cell;
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+        m_enqueue_pos.m_value.store(0, std::memory_order_relaxed);
+        m_dequeue_pos.m_value.store(0, std::memory_order_relaxed);
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    auto operator=(const mpmc_queue&) -> mpmc_queue& = delete;
+
+    ~mpmc_queue() {
+        const u64 end = m_enqueue_pos.m_value.load(std::memory_order_relaxed);
+        for(u64 pos = m_dequeue_pos.m_value.load(std::memory_order_relaxed); pos != end; pos++) {
+            reinterpret_cast<T*>(m_cells[pos & m_mask].m_storage)->~T();
+        }
+        for(u64 i = 0; i <= m_mask; i++) {
+            m_cells[i].~cell();
+        }
+        m_allocator->free(m_cells);
+    }
+
+    /**
+     * @return false iff the queue is full.
+     */
+    inline auto try_push(const T& value) -> bool {
+        return emplace(value);
+    }
+
+    /**
+     * @return false iff the queue is full, value is left untouched then.
+     */
+    inline auto try_push(T&& value) -> bool {
+        return emplace(std::move(value));
+    }
+
+    /**
+     * @return false iff the queue is empty.
+     */
+    inline auto try_pop(T& value) -> bool {
+        u64 pos = m_dequeue_pos.m_value.load(std::memory_order_relaxed);
+        cell* c;
+        for(;;) {
+            c = &m_cells[pos & m_mask];
+            const u64 sequence = c->m_sequence.load(std::memory_order_acquire);
+            const i64 diff = static_cast<i64>(sequence) - static_cast<i64>(pos + 1);
+            if(diff == 0) {
+                if(m_dequeue_pos.m_value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if(diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeue_pos.m_value.load(std::memory_order_relaxed);
+            }
+        }
+        T* stored = reinterpret_cast<T*>(c->m_storage);
+        value = std::move(*stored);
+        stored->~T();
+        c->m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    inline auto capacity() const -> u64 {
+        return m_mask + 1;
+    }
+
+    /**
+     * @return number of elements at some point during the call. Only a hint
+     * while other threads push or pop.
+     */
+    inline auto size_hint() const -> u64 {
+        const u64 dequeued = m_dequeue_pos.m_value.load(std::memory_order_relaxed);
+        const u64 enqueued = m_enqueue_pos.m_value.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    struct cell {
+        std::atomic<u64> m_sequence;
+        alignas(T) u8 m_storage[sizeof(T)];
+    };
+
+    template<typename U>
+    inline auto emplace(U&& value) -> bool {
+        u64 pos = m_enqueue_pos.m_value.load(std::memory_order_relaxed);
+        cell* c;
+        for(;;) {
+            c = &m_cells[pos & m_mask];
+            const u64 sequence = c->m_sequence.load(std::memory_order_acquire);
+            const i64 diff = static_cast<i64>(sequence) - static_cast<i64>(pos);
+            if(diff == 0) {
+                if(m_enqueue_pos.m_value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if(diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueue_pos.m_value.load(std::memory_order_relaxed);
+            }
+        }
+        new (c->m_storage) T(std::forward<U>(value));
+        c->m_sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producers and consumers each hammer their own position, keep them apart
+    // from each other and from the read-mostly fields.
+    cache_padded<std::atomic<u64>> m_enqueue_pos;
+    cache_padded<std::atomic<u64>> m_dequeue_pos;
+    cell* m_cells;
+    u64 m_mask;
+    allocator* m_allocator;
+};
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/io/log.h>
+
+#include <chrono>
+
+#ifdef ROOT_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace root {
+
+/**
+ * Keep the compiler from optimising away a value the benchmark computes.
+ */
+template<typename T>
+inline auto do_not_optimize(T& value) -> void {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * Time body(iterations) and log the cost per iteration under name.
+ * @return nanoseconds per iteration.
+ */
+template<typename F>
+inline auto benchmark(const char* name, const u64& iterations, F&& body) -> u64 {
+    body(iterations / 10 + 1); // Warm up caches and lazily initialised state
+    const auto start = std::chrono::steady_clock::now();
+    body(iterations);
+    const auto end = std::chrono::steady_clock::now();
+    const u64 total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    const u64 ns_per_op = total_ns / iterations;
+    log::i("benchmark", "{}: {} ns/op, {} ops/s"_fmt, name, ns_per_op, total_ns ? (iterations * 1000000000ull) / total_ns : 0ull);
+    return ns_per_op;
+}
+
+/**
+ * Counts last level cache misses of the calling thread between start() and
+ * stop() using perf events. Reads as zero where perf events are unavailable.
+ */
+class cache_miss_counter final {
+public:
+    cache_miss_counter() {
+#ifdef ROOT_LINUX
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    cache_miss_counter(const cache_miss_counter&) = delete;
+    auto operator=(const cache_miss_counter&) -> cache_miss_counter& = delete;
+
+    inline auto available() const -> bool {
+        return m_fd >= 0;
+    }
+
+    inline auto start() -> void {
+#ifdef ROOT_LINUX
+        if(!available()) return;
+        ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    inline auto stop() -> u64 {
+        u64 count = 0;
+#ifdef ROOT_LINUX
+        if(!available()) return 0;
+        ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if(read(m_fd, &count, sizeof(count)) != sizeof(count)) count = 0;
+#endif
+        return count;
+    }
+
+    ~cache_miss_counter() {
+#ifdef ROOT_LINUX
+        if(available()) close(m_fd);
+#endif
+    }
+
+private:
+    int m_fd{-1};
+};
+
+} // namespace root
\ No newline at end of file
@@ -78,7 +78,7 @@ public:
         VkResult res = vkCreateGraphicsPipelines(m_device_handle, VK_NULL_HANDLE, 1, &pipeline_create, nullptr, &m_handle);
 
         if(res != VK_SUCCESS) {
-            log::e("pipeline", "vkCreateGraphicsPipelines failed with {}", res);
+            log::e("pipeline", "vkCreateGraphicsPipelines failed with {}"_fmt, res);
             abort();
         }
 
@@ -33,7 +33,7 @@ class shader_module {
 public:
     explicit shader_module(const device& d, const buffer& b);
     explicit shader_module(const device& d, const string_view& asset_id) 
-    :   shader_module(d, asset_manager::raw_load(asset_id)) {}
+    :   shader_module(d, asset_manager::load(asset_id)->data()) {}
 
     VkShaderModule handle;
 };
@@ -27,7 +27,7 @@
     { \
         VkResult res = _func_call_; \
         if (res != VK_SUCCESS) { \
-            log::e(__FUNCTION__, #_func_call_ " failed with {}", res); \
+            log::e(__FUNCTION__, #_func_call_ " failed with {}"_fmt, res); \
             abort(); \
         } \
     }
\ No newline at end of file
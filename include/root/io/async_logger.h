@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/io/dynamic_buffer_stream.h>
+#include <root/io/formatter.h>
+#include <root/io/log_level.h>
+#include <root/io/private/log_argument.h>
+#include <root/io/private/log_ring.h>
+#include <root/io/writer.h>
+#include <root/memory/allocator.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace root {
+
+/**
+ * Logger that keeps formatting and writing off the calling thread. A call
+ * copies a timestamp, the level, the tag and the arguments' bytes into a ring
+ * owned by the calling thread, no locks and no allocations, and a background
+ * thread formats the records of every ring in timestamp order and writes them
+ * out in batches.
+ *
+ * When a thread's ring is full the message is dropped and the background
+ * thread reports how many were. Nothing may log through the logger while it
+ * is being destroyed.
+ */
+class async_logger {
+public:
+    static constexpr u64 DEFAULT_RING_CAPACITY = 64 * 1024;
+
+    explicit async_logger(writer* out, const u64& ring_capacity = DEFAULT_RING_CAPACITY,
+                          allocator* alloc = allocator::get_default());
+
+    async_logger(const async_logger&) = delete;
+    auto operator=(const async_logger&) -> async_logger& = delete;
+
+    /**
+     * Writes out whatever is still queued.
+     */
+    ~async_logger();
+
+    template<char... Chars, typename... Args>
+    inline auto i(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        log(log_level::info, tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline auto e(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        log(log_level::error, tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline auto d(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        log(log_level::debug, tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline auto w(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        log(log_level::warn, tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline auto log(const log_level& level, const string_view& tag, const static_format_string<Chars...>&, Args... args) -> void {
+        using F = static_format_string<Chars...>;
+        static_assert(F::PLACEHOLDERS == sizeof...(Args), "Format string placeholders don't match the number of arguments");
+        log_ring* ring = thread_ring();
+        const u64 size = sizeof(record_header) + tag.size() + arguments_size<F>(std::index_sequence_for<Args...>(), args...);
+        u8* record = ring->reserve(size);
+        if(!record) return;
+        const record_header header = {now(), &format_record<F, Args...>, static_cast<u32>(tag.size()), level};
+        memcpy(record, &header, sizeof(header));
+        memcpy(record + sizeof(header), tag.data(), tag.size());
+        encode_arguments<F>(record + sizeof(header) + tag.size(), std::index_sequence_for<Args...>(), args...);
+        ring->commit();
+    }
+
+    /**
+     * Block until everything logged before the call has been written.
+     */
+    auto flush() -> void;
+
+private:
+    using format_fn = auto (*)(buffer_writer& dst, const u8* arguments) -> void;
+
+    struct record_header {
+        u64 m_timestamp;
+        format_fn m_format;
+        u32 m_tag_size;
+        log_level m_level;
+    };
+
+    inline static auto now() -> u64 {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    template<typename F, std::size_t... I, typename... Args>
+    inline static auto arguments_size(std::index_sequence<I...>, const Args&... args) -> u64 {
+        return (log_argument<Args>::size(args, F::format_args(I)) + ... + 0);
+    }
+
+    template<typename F, std::size_t... I, typename... Args>
+    inline static auto encode_arguments([[maybe_unused]] u8* dst, std::index_sequence<I...>, const Args&... args) -> void {
+        ((dst = log_argument<Args>::encode(dst, args, F::format_args(I))), ...);
+    }
+
+    /**
+     * Runs on the background thread, decodes the arguments in order while
+     * formatting them.
+     */
+    template<typename F, typename... Args>
+    static auto format_record(buffer_writer& dst, const u8* arguments) -> void {
+        format_decoded<F, Args...>(dst, arguments, std::index_sequence_for<Args...>());
+    }
+
+    template<typename F, typename... Args, std::size_t... I>
+    inline static auto format_decoded(buffer_writer& dst, [[maybe_unused]] const u8* arguments, std::index_sequence<I...>) -> void {
+        (format_placeholder<F, I>(dst, log_argument<Args>::decode(arguments)), ...);
+        format_literal_tail<F>(dst);
+    }
+
+    /**
+     * The calling thread's ring, made on its first message.
+     */
+    auto thread_ring() -> log_ring*;
+    auto register_thread() -> log_ring*;
+
+    auto run() -> void;
+    auto drain() -> void;
+    auto format_line(const u8* record) -> void;
+    auto write_batch() -> void;
+
+    writer* const m_writer;
+    const u64 m_ring_capacity;
+    const u64 m_id;
+    allocator* m_allocator;
+    // Newest first, pushed under m_lock by threads on their first message
+    log_ring* m_rings;
+    dynamic_buffer_stream m_batch;
+    buffer_writer m_batch_writer;
+    std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::condition_variable m_flushed;
+    u64 m_flush_requests;
+    u64 m_flushes_done;
+    bool m_stop;
+    std::thread m_thread;
+};
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/error.h>
+#include <root/core/primitives.h>
+#include <root/io/writer.h>
+
+namespace root {
+
+/**
+ * Reading back what binary_logger wrote.
+ */
+namespace binary_log {
+
+/**
+ * Write the records of a binary log file, oldest first, as text lines the
+ * way the text loggers would, each prefixed with seconds since the logger
+ * was made. Records that were being written when the file was captured are
+ * skipped. Every read is bounds checked, so any file is safe to decode.
+ * @return error::INVALID_OPERATION if data is not a binary log.
+ */
+auto decode(const void* data, const u64& size, writer& out) -> error;
+
+} // namespace binary_log
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/core/string_view.h>
+#include <root/io/log_level.h>
+#include <root/io/private/binary_log_argument.h>
+#include <root/io/private/binary_log_format.h>
+#include <root/io/private/static_format_string.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+namespace root {
+
+/**
+ * Logger that skips formatting altogether. Each call stores its format
+ * string's id, a timestamp, the level, the tag and the arguments' raw bytes
+ * into a ring in a memory mapped file, and root_logdecode turns the file back
+ * into text later with the same format_to() specialisations. A format string
+ * is written to the file's dictionary the first time it is used.
+ *
+ * Any number of threads may log at once, claiming space with a single atomic
+ * add. Once the ring is full the oldest records are overwritten. As the file
+ * is shared with the kernel, what was logged up to a crash survives it.
+ *
+ * A file that could not be created gives an invalid binary_logger, which
+ * drops everything.
+ */
+class binary_logger {
+public:
+    static constexpr u64 DEFAULT_RING_CAPACITY = 16 * 1024 * 1024;
+    static constexpr u64 DEFAULT_DICTIONARY_CAPACITY = 1024 * 1024;
+    // Format strings a logger can tell apart, the rest are dropped
+    static constexpr u32 MAX_FORMATS = binary_log_format::MAX_FORMATS;
+
+    /**
+     * ring_capacity is rounded up to a power of two of at least two blocks.
+     */
+    explicit binary_logger(const string_view& path, const u64& ring_capacity = DEFAULT_RING_CAPACITY,
+                           const u64& dictionary_capacity = DEFAULT_DICTIONARY_CAPACITY);
+
+    binary_logger(const binary_logger&) = delete;
+    auto operator=(const binary_logger&) -> binary_logger& = delete;
+
+    ~binary_logger();
+
+    template<char... Chars, typename... Args>
+    inline auto i(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        log(log_level::info, tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline auto e(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        log(log_level::error, tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline auto d(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        log(log_level::debug, tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline auto w(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        log(log_level::warn, tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline auto log(const log_level& level, const string_view& tag, const static_format_string<Chars...>&, Args... args) -> void {
+        using F = static_format_string<Chars...>;
+        static_assert(F::PLACEHOLDERS == sizeof...(Args), "Format string placeholders don't match the number of arguments");
+        if(!m_header) return;
+        const u32 id = format_id<F, Args...>();
+        if(id >= MAX_FORMATS || !m_defined[id].load(std::memory_order_acquire)) {
+            static constexpr binary_log_format::type TYPES[] = {binary_log_argument<Args>::TYPE..., binary_log_format::type::text};
+            if(!define(id, F::TEXT, F::SIZE, TYPES, sizeof...(Args))) return;
+        }
+        const u64 tag_size = tag.size() < binary_log_format::MAX_TAG_SIZE ? tag.size() : binary_log_format::MAX_TAG_SIZE;
+        const u64 size = binary_log_format::align(sizeof(binary_log_format::record) + binary_log_format::RECORD_BODY_SIZE + tag_size
+                                                  + arguments_size<F>(std::index_sequence_for<Args...>(), args...));
+        u64 position;
+        binary_log_format::record* record = claim(size, position);
+        if(!record) return;
+        u8* body = reinterpret_cast<u8*>(record + 1);
+        const u64 timestamp = now() - m_start;
+        const u8 level_byte = static_cast<u8>(level);
+        const u8 tag_size_byte = static_cast<u8>(tag_size);
+        memcpy(body, &timestamp, sizeof(timestamp));
+        body[sizeof(timestamp)] = level_byte;
+        body[sizeof(timestamp) + 1] = tag_size_byte;
+        memcpy(body + binary_log_format::RECORD_BODY_SIZE, tag.data(), tag_size);
+        encode_arguments<F>(body + binary_log_format::RECORD_BODY_SIZE + tag_size, std::index_sequence_for<Args...>(), args...);
+        commit(record, size, id, position);
+    }
+
+    inline operator bool() const {
+        return m_header != nullptr;
+    }
+
+private:
+    inline static auto now() -> u64 {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Process wide id of a format string and argument types, from 1 as 0
+     * marks padding.
+     */
+    template<typename F, typename... Args>
+    inline static auto format_id() -> u32 {
+        static const u32 id = next_format_id();
+        return id;
+    }
+
+    static auto next_format_id() -> u32;
+
+    template<typename F, std::size_t... I, typename... Args>
+    inline static auto arguments_size(std::index_sequence<I...>, const Args&... args) -> u64 {
+        return (binary_log_argument<Args>::size(args, F::format_args(I)) + ... + 0);
+    }
+
+    template<typename F, std::size_t... I, typename... Args>
+    inline static auto encode_arguments([[maybe_unused]] u8* dst, std::index_sequence<I...>, const Args&... args) -> void {
+        ((dst = binary_log_argument<Args>::encode(dst, args, F::format_args(I))), ...);
+    }
+
+    /**
+     * Add format id to the dictionary unless it is there already.
+     * @return false if there was no room for it.
+     */
+    auto define(const u32& id, const char* text, const u64& size, const binary_log_format::type* types, const u64& count) -> bool;
+
+    /**
+     * size bytes of ring that don't cross a block, filling the ends of blocks
+     * that claims straddle with padding.
+     * @return nullptr if size is more than a block.
+     */
+    inline auto claim(const u64& size, u64& position) -> binary_log_format::record* {
+        if(size > binary_log_format::BLOCK_SIZE) {
+            m_header->m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        for(;;) {
+            position = m_header->m_write_position.fetch_add(size, std::memory_order_relaxed);
+            const u64 block_end = (position | (binary_log_format::BLOCK_SIZE - 1)) + 1;
+            if(position + size <= block_end) return record_at(position);
+            commit(record_at(position), block_end - position, binary_log_format::PADDING_FORMAT_ID, position);
+            commit(record_at(block_end), position + size - block_end, binary_log_format::PADDING_FORMAT_ID, block_end);
+        }
+    }
+
+    /**
+     * The record is complete once its position is written, which goes last.
+     */
+    inline static auto commit(binary_log_format::record* record, const u64& size, const u32& id, const u64& position) -> void {
+        record->m_size = static_cast<u32>(size);
+        record->m_format_id = id;
+        record->m_position.store(position, std::memory_order_release);
+    }
+
+    inline auto record_at(const u64& position) const -> binary_log_format::record* {
+        return reinterpret_cast<binary_log_format::record*>(m_ring + (position & m_ring_mask));
+    }
+
+    void* m_mapping;
+    u64 m_mapping_size;
+    binary_log_format::header* m_header;
+    u8* m_dictionary;
+    u8* m_ring;
+    u64 m_ring_mask;
+    u64 m_start;
+    std::atomic<bool> m_defined[MAX_FORMATS];
+    std::mutex m_dictionary_lock;
+};
+
+} // namespace root
\ No newline at end of file
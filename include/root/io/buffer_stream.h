@@ -40,6 +40,8 @@ public:
     auto write(const void* src, const u64& len) -> value_or_error<u64> override;
     auto seek(const i64& offset, const relative_to& relative_to = relative_to::start) -> error override;
     auto tell(const relative_to& relative_to = relative_to::start) const -> value_or_error<i64> override;
+    auto readv(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> override;
+    auto writev(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> override;
     
     ~buffer_stream() {}
 
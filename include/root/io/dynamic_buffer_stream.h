@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/buffer.h>
+#include <root/io/stream.h>
+#include <root/memory/allocator.h>
+
+namespace root {
+
+/**
+ * stream writing into memory that grows as needed, for output whose size is
+ * not known up front. The first INLINE_CAPACITY bytes live inside the object
+ * itself so short output never allocates. Past that storage comes from the
+ * allocator and doubles in size each time it runs out.
+ *
+ * Seeking past the end is allowed, a write there fills the gap with zeros.
+ * tell(relative_to::end) follows buffer_stream and is position - size().
+ */
+class dynamic_buffer_stream final : public stream {
+public:
+    constexpr static u64 INLINE_CAPACITY = 256;
+
+    explicit dynamic_buffer_stream(allocator* alloc = allocator::get_default());
+
+    dynamic_buffer_stream(const dynamic_buffer_stream&) = delete;
+    dynamic_buffer_stream(dynamic_buffer_stream&& other);
+    auto operator=(const dynamic_buffer_stream&) -> dynamic_buffer_stream& = delete;
+
+    auto read(void* dst, const u64& len) -> value_or_error<u64> override;
+    auto write(const void* src, const u64& len) -> value_or_error<u64> override;
+    auto seek(const i64& offset, const relative_to& relative_to = relative_to::start) -> error override;
+    auto tell(const relative_to& relative_to = relative_to::start) const -> value_or_error<i64> override;
+    auto writev(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> override;
+
+    /**
+     * Make room for at least capacity bytes without further allocations.
+     */
+    auto reserve(const u64& capacity) -> error;
+
+    /**
+     * Copy everything written so far into a buffer of exactly size() bytes,
+     * one allocation. size() must not be 0.
+     */
+    auto to_buffer(const u64& alignment = alignof(u8)) const -> buffer;
+
+    /**
+     * Forget the contents but keep the storage.
+     */
+    inline auto clear() -> void {
+        m_size = 0;
+        m_position = 0;
+    }
+
+    inline auto data() const -> const void* {
+        return m_data;
+    }
+
+    inline auto size() const -> u64 {
+        return m_size;
+    }
+
+    inline auto capacity() const -> u64 {
+        return m_capacity;
+    }
+
+    inline operator buffer_slice() const {
+        return buffer_slice(m_data, 0, m_size);
+    }
+
+    ~dynamic_buffer_stream();
+
+private:
+    inline auto is_inline() const -> bool {
+        return m_data == m_inline;
+    }
+
+    /**
+     * Grow so bytes fit from the current position, zero filling any gap
+     * between the end of the data and the position.
+     */
+    auto prepare_write(const u64& bytes) -> error;
+
+    alignas(u64) u8 m_inline[INLINE_CAPACITY];
+    u8* m_data;
+    u64 m_capacity;
+    u64 m_size;
+    u64 m_position;
+    allocator* m_alloc;
+};
+
+} // namespace root
\ No newline at end of file
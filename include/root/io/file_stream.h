@@ -36,6 +36,12 @@ public:
     auto seek(const i64& offset, const relative_to& relative_to = relative_to::start) -> error override;
     auto tell(const relative_to& relative_to = relative_to::start) const -> value_or_error<i64> override;
 
+    /**
+     * Flushes stdio and hands every slice to a single writev(). readv() stays
+     * on stdio, reading the descriptor directly would skip what it buffered.
+     */
+    auto writev(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> override;
+
     ~file_stream() {}
 
 private:
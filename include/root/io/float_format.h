@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+
+namespace root {
+
+/**
+ * Float to text conversion. Without a precision the output is the shortest
+ * string that reads back as the same value (the Ryu algorithm). With one it is
+ * the exact value rounded half to even to that many digits, same as printf.
+ * Neither path touches the locale or the heap.
+ */
+namespace float_format {
+
+enum class style : u8 {
+    general,    // Shortest of fixed and scientific, fixed on ties
+    fixed,      // 123.45
+    scientific  // 1.2345e+02
+};
+
+constexpr i32 SHORTEST = -1;
+constexpr i32 MAX_PRECISION = 128;
+
+/**
+ * Enough for any f64 at up to MAX_PRECISION digits after the point.
+ */
+constexpr u64 MAX_CHARS = 512;
+
+/**
+ * Write f into dst, which must hold MAX_CHARS. A precision with general style
+ * means fixed. Precisions over MAX_PRECISION are clamped.
+ * @return characters written, no null terminator.
+ */
+auto to_chars(char* dst, const f64& f, const style& s = style::general, const i32& precision = SHORTEST) -> u64;
+
+/**
+ * As the f64 overload, but shortest output is the shortest that reads back as
+ * the same f32.
+ */
+auto to_chars(char* dst, const f32& f, const style& s = style::general, const i32& precision = SHORTEST) -> u64;
+
+} // namespace float_format
+
+} // namespace root
\ No newline at end of file
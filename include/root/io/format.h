@@ -33,4 +33,9 @@ inline auto format(const format_string& fmt, Args... args) -> string {
     return formatter::get_default_formatter()->format(fmt, args...);
 }
 
+template<char... Chars, typename... Args>
+inline auto format(const static_format_string<Chars...>& fmt, Args... args) -> string {
+    return formatter::get_default_formatter()->format(fmt, args...);
+}
+
 } // namespace root
\ No newline at end of file
@@ -19,16 +19,23 @@
 
 #pragma once
 
+#include <root/io/dynamic_buffer_stream.h>
 #include <root/io/writer.h>
 #include <root/memory/allocator.h>
 #include <root/core/string.h>
 #include <root/io/private/format_string.h>
+#include <root/io/private/static_format_string.h>
 
 #include <cstring>
 #include <cwchar>
+#include <utility>
 
 namespace root {
 
+/**
+ * Length object formats to. formatter does not need it since it went single
+ * pass, it stays for code that wants to size output up front.
+ */
 template<typename T> 
 auto strlen(const T& object, const string_view& format_args = string_view()) -> u64;
 
@@ -153,6 +160,80 @@ inline auto format_to<>(buffer_writer& dst,const format_string& fmt) -> void {
     if(fmt.size()) dst.write(fmt.data(), fmt.size());
 }
 
+template<typename F, std::size_t I, typename T>
+inline auto strlen_placeholder(const T& object) -> u64 {
+    return strlen(object, F::format_args(I));
+}
+
+template<typename F, std::size_t... I, typename... Args>
+inline auto strlen_placeholders(std::index_sequence<I...>, Args... args) -> u64 {
+    return F::literal_size() + (strlen_placeholder<F, I>(args) + ... + 0);
+}
+
+template<char... Chars, typename... Args>
+inline auto strlen(const static_format_string<Chars...>&, Args... args) -> u64 {
+    using F = static_format_string<Chars...>;
+    static_assert(F::PLACEHOLDERS == sizeof...(Args), "Format string placeholders don't match the number of arguments");
+    return strlen_placeholders<F>(std::index_sequence_for<Args...>(), args...);
+}
+
+// Otherwise strlen(const T&, const string_view&) is the better match for one string_view
+template<char... Chars>
+inline auto strlen(const static_format_string<Chars...>&, const string_view& object) -> u64 {
+    using F = static_format_string<Chars...>;
+    static_assert(F::PLACEHOLDERS == 1, "Format string placeholders don't match the number of arguments");
+    return strlen_placeholders<F>(std::index_sequence<0>(), object);
+}
+
+/**
+ * The literal text before placeholder I, then object.
+ */
+template<typename F, std::size_t I, typename T>
+inline auto format_placeholder(buffer_writer& dst, const T& object) -> void {
+    static_assert(format_args_check<T>::valid(F::TEXT, F::TABLE.m_placeholders[I].m_open + 1, F::TABLE.m_placeholders[I].m_close),
+                  "Format args don't apply to the argument's type");
+    constexpr u64 begin = F::literal_begin(I);
+    constexpr u64 end = F::literal_end(I);
+    if constexpr(end > begin) dst.write(F::TEXT + begin, end - begin);
+    format_to(dst, object, F::format_args(I));
+}
+
+/**
+ * The literal text after the last placeholder.
+ */
+template<typename F>
+inline auto format_literal_tail(buffer_writer& dst) -> void {
+    constexpr u64 begin = F::literal_begin(F::PLACEHOLDERS);
+    if constexpr(F::SIZE > begin) dst.write(F::TEXT + begin, F::SIZE - begin);
+}
+
+template<typename F, std::size_t... I, typename... Args>
+inline auto format_placeholders(buffer_writer& dst, std::index_sequence<I...>, Args... args) -> void {
+    (format_placeholder<F, I>(dst, args), ...);
+    format_literal_tail<F>(dst);
+}
+
+template<char... Chars, typename... Args>
+inline auto format_to(buffer_writer& dst, const static_format_string<Chars...>&, Args... args) -> void {
+    using F = static_format_string<Chars...>;
+    static_assert(F::PLACEHOLDERS == sizeof...(Args), "Format string placeholders don't match the number of arguments");
+    format_placeholders<F>(dst, std::index_sequence_for<Args...>(), args...);
+}
+
+// Otherwise format_to(buffer_writer&, const T&, const string_view&) is the better match for one string_view
+template<char... Chars>
+inline auto format_to(buffer_writer& dst, const static_format_string<Chars...>&, const string_view& object) -> void {
+    using F = static_format_string<Chars...>;
+    static_assert(F::PLACEHOLDERS == 1, "Format string placeholders don't match the number of arguments");
+    format_placeholders<F>(dst, std::index_sequence<0>(), object);
+}
+
+/**
+ * Formats in a single pass: arguments are written straight into a
+ * dynamic_buffer_stream, which keeps short output on the stack, and the
+ * result is copied once into a string of exactly the right size. Types
+ * format through their format_to() specialisation, strlen() is not needed.
+ */
 class formatter {
 public:
     explicit formatter(allocator* alloc = allocator::get_default())
@@ -160,26 +241,33 @@ public:
 
     template<typename T>
     auto to_string(const T& object) -> string {
-        u64 len = strlen(object);
-        buffer buf(len+1, alignof(i8), m_allocator);
-        buffer_stream stream(buf);
+        dynamic_buffer_stream stream(m_allocator);
         buffer_writer writer(&stream);
         format_to(writer, object);
         format_to(writer, '\0');
-        auto str = string(std::move(buf));
-        return str;
+        return string(stream.to_buffer(alignof(i8)));
     }
 
+    /**
+     * For format strings only known at run time, placeholders are searched
+     * for on every call.
+     */
     template<typename... Args>
     auto format(const format_string& fmt, Args... args) -> string {
-        u64 len = strlen(fmt, args...);
-        buffer buf(len+1, alignof(i8), m_allocator);
-        buffer_stream stream(buf);
+        dynamic_buffer_stream stream(m_allocator);
+        buffer_writer writer(&stream);
+        format_to(writer, fmt, args...);
+        format_to(writer, '\0');
+        return string(stream.to_buffer(alignof(i8)));
+    }
+
+    template<char... Chars, typename... Args>
+    auto format(const static_format_string<Chars...>& fmt, Args... args) -> string {
+        dynamic_buffer_stream stream(m_allocator);
         buffer_writer writer(&stream);
         format_to(writer, fmt, args...);
         format_to(writer, '\0');
-        auto str = string(std::move(buf));
-        return str;
+        return string(stream.to_buffer(alignof(i8)));
     }
 
     inline static auto set_default_formatter(formatter* fmtr) -> void {
@@ -19,33 +19,182 @@
 
 #pragma once
 
+#include <root/io/async_logger.h>
+#include <root/io/binary_logger.h>
+#include <root/io/log_level.h>
+#include <root/io/log_rate_limiter.h>
 #include <root/io/logger.h>
 
+#include <atomic>
+
+/*
+ * Log through a macro where the arguments are costly to compute. Below
+ * ROOT_LOG_LEVEL the statement compiles to nothing, otherwise the arguments
+ * are only evaluated when _tag_'s level lets the message through. _tag_ is
+ * looked up once per call site so it must be the same on every call.
+ */
+#define root_log(_level_, _tag_, ...) \
+    do { \
+        if constexpr(root::log::compiled_in(_level_)) { \
+            static const std::atomic<root::log_level>& _root_log_tag_level_ = root::log::tag_level(_tag_); \
+            if(_level_ >= _root_log_tag_level_.load(std::memory_order_relaxed)) { \
+                root::log::write<_level_>(_tag_, __VA_ARGS__); \
+            } \
+        } \
+    } while(0)
+
+#define root_log_d(_tag_, ...) root_log(root::log_level::debug, _tag_, __VA_ARGS__)
+#define root_log_i(_tag_, ...) root_log(root::log_level::info, _tag_, __VA_ARGS__)
+#define root_log_w(_tag_, ...) root_log(root::log_level::warn, _tag_, __VA_ARGS__)
+#define root_log_e(_tag_, ...) root_log(root::log_level::error, _tag_, __VA_ARGS__)
+
 namespace root {
 
 class log {
 public:
-    // TODO control log level printing depending on build type
-    template<typename... Args>
-    inline static auto i(const string_view& tag, const format_string& fmt, Args... args) -> void {
-        m_logger->i(tag, fmt, args...);
+    template<char... Chars, typename... Args>
+    inline static auto i(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        if(enabled<log_level::info>(tag)) write<log_level::info>(tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline static auto d(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        if(enabled<log_level::debug>(tag)) write<log_level::debug>(tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline static auto e(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        if(enabled<log_level::error>(tag)) write<log_level::error>(tag, fmt, args...);
+    }
+
+    template<char... Chars, typename... Args>
+    inline static auto w(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        if(enabled<log_level::warn>(tag)) write<log_level::warn>(tag, fmt, args...);
+    }
+
+    /**
+     * Whether a message of level under tag would be written, for skipping
+     * work done only to be logged.
+     */
+    template<log_level level>
+    inline static auto enabled(const string_view& tag) -> bool {
+        if constexpr(!compiled_in(level)) {
+            return false;
+        } else {
+            return level >= find_tag_level(tag).load(std::memory_order_relaxed);
+        }
+    }
+
+    constexpr static auto compiled_in(const log_level& level) -> bool {
+        return level >= MIN_LOG_LEVEL;
     }
-    template<typename... Args>
-    inline static auto d(const string_view& tag, const format_string& fmt, Args... args) -> void {
-        m_logger->d(tag, fmt, args...);
+
+    /**
+     * Least important level written for tags without a level of their own.
+     * Starts at MIN_LOG_LEVEL.
+     */
+    static auto set_level(const log_level& level) -> void;
+
+    /**
+     * Least important level written for tag from now on.
+     */
+    static auto set_level(const string_view& tag, const log_level& level) -> void;
+
+    /**
+     * The level tag is filtered at, registering it if needed. What root_log
+     * caches per call site.
+     */
+    static auto tag_level(const string_view& tag) -> const std::atomic<log_level>&;
+
+    /**
+     * Write without checking the level. Goes through the rate limiter if one
+     * is set, which may hold the message back, or write how many of its kind
+     * were held back before it.
+     */
+    template<log_level level, char... Chars, typename... Args>
+    inline static auto write(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        if(m_rate_limiter) {
+            const log_rate_limiter::admission admitted = m_rate_limiter->admit(level, tag, fmt.TEXT);
+            if(!admitted.m_write) return;
+            if(admitted.m_suppressed) {
+                write_suppressed<level>(tag, admitted.m_suppressed, fmt.TEXT);
+            }
+        }
+        dispatch<level>(tag, fmt, args...);
+    }
+
+    /**
+     * Send messages to async instead of the platform logger until it is set
+     * back to nullptr. Not to be called while other threads log.
+     */
+    inline static auto set_async_logger(async_logger* async) -> void {
+        m_async_logger = async;
     }
 
-    template<typename... Args>
-    inline static auto e(const string_view& tag, const format_string& fmt, Args... args) -> void {
-        m_logger->e(tag, fmt, args...);
+    /**
+     * Send messages to binary instead, ahead of any async_logger, until it is
+     * set back to nullptr. Not to be called while other threads log.
+     */
+    inline static auto set_binary_logger(binary_logger* binary) -> void {
+        m_binary_logger = binary;
     }
 
-    template<typename... Args>
-    inline static auto w(const string_view& tag, const format_string& fmt, Args... args) -> void {
-        m_logger->w(tag, fmt, args...);
+    /**
+     * Hold back repeats through limiter until it is set back to nullptr. Not
+     * to be called while other threads log.
+     */
+    inline static auto set_rate_limiter(log_rate_limiter* limiter) -> void {
+        m_rate_limiter = limiter;
     }
+
+    /**
+     * Write how many messages the rate limiter held back that were not
+     * reported yet, then block until queued messages are written, before
+     * aborting for example.
+     */
+    static auto flush() -> void;
+
 private:
+    /**
+     * The line standing in for count messages of format the rate limiter held
+     * back.
+     */
+    template<log_level level>
+    inline static auto write_suppressed(const string_view& tag, const u64& count, const char* format) -> void {
+        dispatch<level>(tag, "suppressed {} messages like \"{}\""_fmt, count, format);
+    }
+
+    template<log_level level, char... Chars, typename... Args>
+    inline static auto dispatch(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
+        if(m_binary_logger) {
+            m_binary_logger->log(level, tag, fmt, args...);
+            return;
+        }
+        if(m_async_logger) {
+            m_async_logger->log(level, tag, fmt, args...);
+            return;
+        }
+        if constexpr(level == log_level::debug) {
+            m_logger->d(tag, fmt, args...);
+        } else if constexpr(level == log_level::info) {
+            m_logger->i(tag, fmt, args...);
+        } else if constexpr(level == log_level::warn) {
+            m_logger->w(tag, fmt, args...);
+        } else {
+            m_logger->e(tag, fmt, args...);
+        }
+    }
+
+    /**
+     * Like tag_level but tags not seen before get the default level without
+     * being registered.
+     */
+    static auto find_tag_level(const string_view& tag) -> const std::atomic<log_level>&;
+
     static logger* m_logger;
+    static async_logger* m_async_logger;
+    static binary_logger* m_binary_logger;
+    static log_rate_limiter* m_rate_limiter;
 };
 
 } // namespace root
\ No newline at end of file
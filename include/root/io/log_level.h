@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+
+/*
+ * Messages below this level are compiled out, set from CMake's ROOT_LOG_LEVEL:
+ * 0 debug, 1 info, 2 warn, 3 error.
+ */
+#if !defined(ROOT_LOG_LEVEL)
+#if defined(ROOT_DEBUG)
+#define ROOT_LOG_LEVEL 0
+#else
+#define ROOT_LOG_LEVEL 1
+#endif
+#endif
+
+namespace root {
+
+/**
+ * Message priority, from least to most important.
+ */
+enum class log_level : u8 {
+    debug,
+    info,
+    warn,
+    error
+};
+
+constexpr log_level MIN_LOG_LEVEL = static_cast<log_level>(ROOT_LOG_LEVEL);
+
+/**
+ * @return the text lines of level are prefixed with, "INFO: " etc.
+ */
+constexpr auto log_level_prefix(const log_level& level) -> const char* {
+    switch(level) {
+        case log_level::debug: return "DEBUG: ";
+        case log_level::info: return "INFO: ";
+        case log_level::warn: return "WARN: ";
+        case log_level::error: return "ERROR: ";
+    }
+    return "";
+}
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/core/string_view.h>
+#include <root/io/log_level.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace root {
+
+/**
+ * Keeps one repeating message from flooding the log, such as an error hit
+ * every frame. Each tag and format string pair gets a token bucket holding
+ * burst messages and refilled with per_second of them, and messages that find
+ * it empty are counted instead of written. The count is handed back with the
+ * next message of that pair let through, or to report().
+ *
+ * Checking a message takes a few atomics and no locks. Messages below
+ * least_limited are never held back, nor are pairs past the first MAX_KEYS.
+ */
+class log_rate_limiter {
+public:
+    static constexpr u64 MAX_KEYS = 256;
+
+    /**
+     * Longer tags are cut short in what report() gives back.
+     */
+    static constexpr u64 MAX_TAG_SIZE = 24;
+
+    static constexpr u64 DEFAULT_BURST = 64;
+    static constexpr u64 DEFAULT_PER_SECOND = 4;
+
+    struct admission {
+        bool m_write;
+        // Messages of the same pair held back since the last one written
+        u64 m_suppressed;
+    };
+
+    explicit log_rate_limiter(const u64& burst = DEFAULT_BURST, const u64& per_second = DEFAULT_PER_SECOND,
+                              const log_level& least_limited = log_level::warn);
+
+    log_rate_limiter(const log_rate_limiter&) = delete;
+    auto operator=(const log_rate_limiter&) -> log_rate_limiter& = delete;
+
+    /**
+     * Take a token for a message. format must outlive the limiter, which
+     * holds for the text of a static_format_string.
+     * @param now in nanoseconds, never going backwards.
+     */
+    auto admit(const log_level& level, const string_view& tag, const char* format, const u64& now) -> admission;
+
+    inline auto admit(const log_level& level, const string_view& tag, const char* format) -> admission {
+        const auto since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+        return admit(level, tag, format, std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count());
+    }
+
+    /**
+     * Call f(level, tag, format, count) for every pair with messages held back
+     * that no admission has handed back yet, and reset their counts. level is
+     * that of the pair's first message.
+     */
+    template<typename F>
+    inline auto report(F f) -> void {
+        for(entry& e : m_entries) {
+            if(!e.m_ready.load(std::memory_order_acquire)) continue;
+            if(!e.m_suppressed.load(std::memory_order_relaxed)) continue;
+            const u64 suppressed = e.m_suppressed.exchange(0, std::memory_order_relaxed);
+            if(suppressed) f(e.m_level, string_view(e.m_tag, 0, e.m_tag_size), e.m_format, suppressed);
+        }
+    }
+
+private:
+    /**
+     * A cache line each, as a storm hammers one entry from many threads.
+     */
+    struct alignas(64) entry {
+        // 0 while free
+        std::atomic<u64> m_key;
+        // When the bucket holds burst tokens again
+        std::atomic<u64> m_full_at;
+        std::atomic<u64> m_suppressed;
+        // Set once m_format, m_level and m_tag are
+        std::atomic<bool> m_ready;
+        log_level m_level;
+        u8 m_tag_size;
+        char m_tag[MAX_TAG_SIZE];
+        const char* m_format;
+    };
+
+    /**
+     * @return the entry for the pair, claiming a free one if it has none, or
+     * nullptr if the table is full.
+     */
+    auto find(const log_level& level, const string_view& tag, const char* format) -> entry*;
+
+    entry m_entries[MAX_KEYS];
+    // Nanoseconds per token
+    u64 m_interval;
+    // How far m_full_at may be ahead of now with a token left
+    u64 m_tolerance;
+    log_level m_least_limited;
+};
+
+} // namespace root
\ No newline at end of file
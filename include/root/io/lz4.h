@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+
+namespace root {
+
+/**
+ * Compression in the LZ4 block format: a greedy single pass compressor and a
+ * bounds checked decompressor that never reads or writes outside the buffers
+ * it is given, so it is safe to run on untrusted data.
+ */
+namespace lz4 {
+
+constexpr u64 MAX_INPUT_SIZE = 0x7E000000;
+
+/**
+ * @return the most bytes compress() can produce for size bytes of input.
+ */
+constexpr auto compress_bound(const u64& size) -> u64 {
+    return size + size / 255 + 16;
+}
+
+/**
+ * Compress src into dst.
+ * @return bytes written, 0 if dst is too small or src too big.
+ */
+auto compress(const void* src, const u64& src_size, void* dst, const u64& dst_capacity) -> u64;
+
+/**
+ * Decompress src, which must decode to exactly dst_size bytes.
+ * @return false if src is malformed or doesn't decode to dst_size bytes.
+ */
+auto decompress(const void* src, const u64& src_size, void* dst, const u64& dst_size) -> bool;
+
+} // namespace lz4
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/core/buffer_slice.h>
+#include <root/core/error.h>
+#include <root/core/string_view.h>
+
+namespace root {
+
+/**
+ * How the contents of a mapping are going to be read, passed to the kernel as
+ * an madvise() hint so it can tune read-ahead.
+ */
+enum class access_pattern : u8 {
+    normal = 0,
+    sequential = 1,
+    random = 2,
+    will_need = 3
+};
+
+/**
+ * Read-only view of a whole file mapped into memory. Pages are faulted in on
+ * first touch so opening is a fixed handful of syscalls whatever the size of
+ * the file, and nothing is copied onto the heap. The mapping lives as long as
+ * the mapped_buffer that owns it.
+ *
+ * Empty files and platforms without mmap give an invalid mapped_buffer.
+ */
+class mapped_buffer {
+public:
+    inline mapped_buffer()
+    :   m_data(nullptr),
+        m_byte_size(0) {}
+
+    explicit mapped_buffer(const string_view& path, const access_pattern& pattern = access_pattern::sequential);
+
+    mapped_buffer(const mapped_buffer&) = delete;
+    inline mapped_buffer(mapped_buffer&& other)
+    :   m_data(other.m_data),
+        m_byte_size(other.m_byte_size) {
+        other.clear();
+    }
+
+    auto operator=(const mapped_buffer&) -> mapped_buffer& = delete;
+    inline auto operator=(mapped_buffer&& other) -> mapped_buffer& {
+        if(this != &other) {
+            unmap();
+            m_data = other.m_data;
+            m_byte_size = other.m_byte_size;
+            other.clear();
+        }
+        return *this;
+    }
+
+    inline auto data() const -> const void* {
+        return m_data;
+    }
+
+    inline auto size() const -> u64 {
+        return m_byte_size;
+    }
+
+    inline operator bool() const {
+        return m_data && m_byte_size;
+    }
+
+    /**
+     * The slice must only be read from, writes fault.
+     */
+    inline operator buffer_slice() const {
+        return buffer_slice(m_data, 0, m_byte_size);
+    }
+
+    /**
+     * Change the access hint for [offset, offset + len) of the mapping, or all
+     * of it if len is 0.
+     */
+    auto advise(const access_pattern& pattern, const u64& offset = 0, const u64& len = 0) -> error;
+
+    ~mapped_buffer() {
+        unmap();
+    }
+
+private:
+    auto unmap() -> void;
+
+    inline auto clear() -> void {
+        m_data = nullptr;
+        m_byte_size = 0;
+    }
+
+    void* m_data;
+    u64 m_byte_size;
+};
+
+} // namespace root
\ No newline at end of file
@@ -70,7 +70,7 @@ auto binary_name() -> const string_view&;
 
 inline auto join(const string_view& lhs, const string_view& rhs, allocator* alloc = allocator::get_default()) -> string {
     formatter formatter(alloc);
-    return formatter.format("{}{}{}", lhs, FOLDER_DELIMITER, rhs);
+    return formatter.format("{}{}{}"_fmt, lhs, FOLDER_DELIMITER, rhs);
 }
 
 } // namespace path
@@ -26,29 +26,29 @@ namespace root {
 
 class logger {
 public:
-    template<typename... Args>
-    inline auto i(const string_view& tag, const format_string& fmt, Args... args) -> void {
+    template<char... Chars, typename... Args>
+    inline auto i(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
         log<ANDROID_LOG_INFO>(tag, fmt, args...);
     }
 
-    template<typename... Args>
-    inline auto e(const string_view& tag, const format_string& fmt, Args... args) -> void {
+    template<char... Chars, typename... Args>
+    inline auto e(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
         log<ANDROID_LOG_ERROR>(tag, fmt, args...);
     }
 
-    template<typename... Args>
-    inline auto d(const string_view& tag, const format_string& fmt, Args... args) -> void {
+    template<char... Chars, typename... Args>
+    inline auto d(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
         log<ANDROID_LOG_DEBUG>(tag, fmt, args...);
     }
 
-    template<typename... Args>
-    inline auto w(const string_view& tag, const format_string& fmt, Args... args) -> void {
+    template<char... Chars, typename... Args>
+    inline auto w(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
         log<ANDROID_LOG_WARN>(tag, fmt, args...);
     }
 
 private:
-    template<int p, typename... Args> 
-    inline auto log(const string_view& tag, const format_string& fmt, Args... args) -> void {
+    template<int p, char... Chars, typename... Args>
+    inline auto log(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
         string str = format(fmt, args...);
         __android_log_buf_write(LOG_ID_MAIN, p, tag.size()? tag.data(): "", str.data());
     }
@@ -28,64 +28,63 @@ class logger {
 public:
     explicit logger(writer* out) : m_writer(out) {}
 
-    template<typename... Args>
-    inline auto i(const string_view& tag, const format_string& fmt, Args... args) -> void {
+    template<char... Chars, typename... Args>
+    inline auto i(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
         constexpr char const* PRIO_TAG = "INFO: ";
         constexpr u64 PRIO_LEN = strlen(PRIO_TAG);
-        m_writer->write(PRIO_TAG, PRIO_LEN);
-        print_tag(tag);
         string str = format(fmt, args...);
-        m_writer->write(str.data(), str.size());
-        endl();
+        print_line(PRIO_TAG, PRIO_LEN, tag, str);
     }
 
-    template<typename... Args>
-    inline auto e(const string_view& tag, const format_string& fmt, Args... args) -> void {
+    template<char... Chars, typename... Args>
+    inline auto e(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
         constexpr char const* PRIO_TAG = "ERROR: ";
         constexpr u64 PRIO_LEN = strlen(PRIO_TAG);
-        m_writer->write(PRIO_TAG, PRIO_LEN);
-        print_tag(tag);
         string str = format(fmt, args...);
-        m_writer->write(str.data(), str.size());
-        endl();
+        print_line(PRIO_TAG, PRIO_LEN, tag, str);
     }
 
-    template<typename... Args>
-    inline auto d(const string_view& tag, const format_string& fmt, Args... args) -> void {
+    template<char... Chars, typename... Args>
+    inline auto d(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
         constexpr char const* PRIO_TAG = "DEBUG: ";
         constexpr u64 PRIO_LEN = strlen(PRIO_TAG);
-        m_writer->write(PRIO_TAG, PRIO_LEN);
-        print_tag(tag);
         string str = format(fmt, args...);
-        m_writer->write(str.data(), str.size());
-        endl();
+        print_line(PRIO_TAG, PRIO_LEN, tag, str);
     }
 
-    template<typename... Args>
-    inline auto w(const string_view& tag, const format_string& fmt, Args... args) -> void {
+    template<char... Chars, typename... Args>
+    inline auto w(const string_view& tag, const static_format_string<Chars...>& fmt, Args... args) -> void {
         constexpr char const* PRIO_TAG = "WARN: ";
         constexpr u64 PRIO_LEN = strlen(PRIO_TAG);
-        m_writer->write(PRIO_TAG, PRIO_LEN);
-        print_tag(tag);
         string str = format(fmt, args...);
-        m_writer->write(str.data(), str.size());
-        endl();
+        print_line(PRIO_TAG, PRIO_LEN, tag, str);
     }
 
 private:
-    inline auto print_tag(const string_view& tag) -> void {
+    /**
+     * Hand the whole line to the writer at once, a single writev() syscall on
+     * file backed streams.
+     */
+    inline auto print_line(const char* prio_tag, const u64& prio_len, const string_view& tag, const string& str) -> void {
         constexpr char const * COLON = ": ";
         constexpr u64 COLON_LEN = strlen(COLON);
+        constexpr char const * ENDL = "\n";
+        constexpr u64 ENDL_LEN = strlen(ENDL);
+        buffer_slice line[5];
+        u64 count = 0;
+        line[count++] = slice(prio_tag, prio_len);
         if(tag.size()) {
-            m_writer->write(tag.data(), tag.size());
-            m_writer->write(COLON, COLON_LEN);
+            line[count++] = slice(tag.data(), tag.size());
+            line[count++] = slice(COLON, COLON_LEN);
         }
+        line[count++] = slice(str.data(), str.size());
+        line[count++] = slice(ENDL, ENDL_LEN);
+        m_writer->writev(array_slice<buffer_slice>(line, count));
     }
 
-    inline auto endl() -> void {
-        constexpr char const * ENDL = "\n";
-        constexpr u64 ENDL_LEN = strlen(ENDL);
-        m_writer->write(ENDL, ENDL_LEN);
+    // The slices are only ever read from
+    inline static auto slice(const void* data, const u64& size) -> buffer_slice {
+        return buffer_slice(const_cast<void*>(data), 0, size);
     }
 
     writer * const  m_writer;
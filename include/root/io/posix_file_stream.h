@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/buffer.h>
+#include <root/core/string_view.h>
+#include <root/io/stream.h>
+
+namespace root {
+
+enum class file_mode : u8 {
+    read = 0,
+    // Creates the file if needed and truncates it
+    write = 1,
+    // Creates the file if needed, keeps its contents
+    read_write = 2,
+    // Read only, bypassing the page cache with O_DIRECT where supported
+    direct_read = 3
+};
+
+/**
+ * stream over a raw file descriptor. Unlike file_stream there is no stdio
+ * locking underneath: reads and writes go through a buffer taken from an
+ * engine allocator and hit the file with pread()/pwrite() at an offset the
+ * stream tracks itself. The file size is cached so seeking or telling from
+ * the end never touches the file.
+ *
+ * The buffer holds either read ahead or pending writes, never both. Pending
+ * writes reach the file on flush(), when the buffer fills, on a
+ * non-contiguous write or read and on destruction. Reads or writes at least
+ * as big as the buffer, or reading up to the end of the file, skip it.
+ *
+ * file_mode::direct_read asks for O_DIRECT, meant for large sequential asset
+ * reads that would otherwise evict more useful pages. The buffer is then
+ * aligned to DIRECT_ALIGNMENT and refilled at aligned offsets. Filesystems
+ * that refuse O_DIRECT get a normal buffered descriptor, see direct().
+ */
+class posix_file_stream final : public stream {
+public:
+    constexpr static u64 DEFAULT_BUFFER_SIZE = 64 * 1024;
+    constexpr static u64 DIRECT_ALIGNMENT = 4096;
+
+    explicit posix_file_stream(const string_view& path, 
+                               const file_mode& mode = file_mode::read, 
+                               const u64& buffer_size = DEFAULT_BUFFER_SIZE, 
+                               allocator* alloc = allocator::get_default());
+
+    posix_file_stream(const posix_file_stream&) = delete;
+    auto operator=(const posix_file_stream&) -> posix_file_stream& = delete;
+
+    auto read(void* dst, const u64& len) -> value_or_error<u64> override;
+    auto write(const void* src, const u64& len) -> value_or_error<u64> override;
+    auto seek(const i64& offset, const relative_to& relative_to = relative_to::start) -> error override;
+    auto tell(const relative_to& relative_to = relative_to::start) const -> value_or_error<i64> override;
+    auto readv(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> override;
+    auto writev(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> override;
+
+    /**
+     * Write out anything left in the buffer.
+     */
+    auto flush() -> error;
+
+    inline operator bool() const {
+        return m_fd >= 0;
+    }
+
+    inline auto size() const -> u64 {
+        return m_size;
+    }
+
+    /**
+     * @return whether the descriptor was opened with O_DIRECT.
+     */
+    inline auto direct() const -> bool {
+        return m_direct;
+    }
+
+    ~posix_file_stream();
+
+private:
+    auto reserve_buffer() -> void;
+    auto fill(const u64& offset) -> error;
+
+    // Allocated on first use, a stream read whole in one go never needs it
+    buffer m_buffer;
+    allocator* m_alloc;
+    u64 m_buffer_size;
+    int m_fd;
+    file_mode m_mode;
+    bool m_direct;
+    bool m_dirty;
+    u64 m_position;
+    u64 m_size;
+    // File offset of the first byte in m_buffer and how many bytes are valid
+    u64 m_buffer_offset;
+    u64 m_buffer_length;
+};
+
+} // namespace root
\ No newline at end of file
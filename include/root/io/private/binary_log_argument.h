@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/core/string_view.h>
+#include <root/io/formatter.h>
+#include <root/io/private/binary_log_format.h>
+
+#include <cstring>
+#include <type_traits>
+
+namespace root {
+
+/**
+ * Formats T while logging and stores the text, so it works for any type with
+ * strlen() and format_to() but costs what formatting does.
+ */
+template<typename T>
+struct binary_log_formatted_argument {
+    static constexpr binary_log_format::type TYPE = binary_log_format::type::text;
+
+    static inline auto size(const T& object, const string_view& format_args) -> u64 {
+        return sizeof(u32) + strlen(object, format_args);
+    }
+
+    static inline auto encode(u8* dst, const T& object, const string_view& format_args) -> u8* {
+        const u32 length = static_cast<u32>(strlen(object, format_args));
+        memcpy(dst, &length, sizeof(length));
+        buffer_stream stream(buffer_slice(dst + sizeof(length), 0, length));
+        buffer_writer writer(&stream);
+        format_to(writer, object, format_args);
+        return dst + sizeof(length) + length;
+    }
+};
+
+/**
+ * How binary_logger stores an argument of type T: TYPE tells the decoder how
+ * to read back the size() bytes encode() writes and which format_to() to
+ * hand them to. Types without a specialisation are stored as text.
+ */
+template<typename T, typename = void>
+struct binary_log_argument : binary_log_formatted_argument<T> {};
+
+template<typename T, binary_log_format::type Type>
+struct binary_log_number_argument {
+    static constexpr binary_log_format::type TYPE = Type;
+
+    static inline auto size(const T&, const string_view&) -> u64 {
+        return sizeof(T);
+    }
+
+    static inline auto encode(u8* dst, const T& object, const string_view&) -> u8* {
+        memcpy(dst, &object, sizeof(T));
+        return dst + sizeof(T);
+    }
+};
+
+struct binary_log_text_argument {
+    static constexpr binary_log_format::type TYPE = binary_log_format::type::text;
+
+    static inline auto size(const char*, const u64& length) -> u64 {
+        return sizeof(u32) + length;
+    }
+
+    static inline auto encode(u8* dst, const char* data, const u64& length) -> u8* {
+        const u32 length32 = static_cast<u32>(length);
+        memcpy(dst, &length32, sizeof(length32));
+        memcpy(dst + sizeof(length32), data, length);
+        return dst + sizeof(length32) + length;
+    }
+};
+
+template<> struct binary_log_argument<i8> : binary_log_number_argument<i8, binary_log_format::type::int8> {};
+template<> struct binary_log_argument<i16> : binary_log_number_argument<i16, binary_log_format::type::int16> {};
+template<> struct binary_log_argument<i32> : binary_log_number_argument<i32, binary_log_format::type::int32> {};
+template<> struct binary_log_argument<i64> : binary_log_number_argument<i64, binary_log_format::type::int64> {};
+template<> struct binary_log_argument<u8> : binary_log_number_argument<u8, binary_log_format::type::uint8> {};
+template<> struct binary_log_argument<u16> : binary_log_number_argument<u16, binary_log_format::type::uint16> {};
+template<> struct binary_log_argument<u32> : binary_log_number_argument<u32, binary_log_format::type::uint32> {};
+template<> struct binary_log_argument<u64> : binary_log_number_argument<u64, binary_log_format::type::uint64> {};
+template<> struct binary_log_argument<f32> : binary_log_number_argument<f32, binary_log_format::type::float32> {};
+template<> struct binary_log_argument<f64> : binary_log_number_argument<f64, binary_log_format::type::float64> {};
+template<> struct binary_log_argument<bool> : binary_log_number_argument<bool, binary_log_format::type::boolean> {};
+
+/**
+ * Pointers format as their address.
+ */
+template<typename T>
+struct binary_log_argument<T*> {
+    static constexpr binary_log_format::type TYPE = binary_log_format::type::uint64;
+
+    static inline auto size(T* const&, const string_view&) -> u64 {
+        return sizeof(u64);
+    }
+
+    static inline auto encode(u8* dst, T* const& object, const string_view&) -> u8* {
+        const u64 address = reinterpret_cast<u64>(object);
+        memcpy(dst, &address, sizeof(address));
+        return dst + sizeof(address);
+    }
+};
+
+template<>
+struct binary_log_argument<string_view> {
+    static constexpr binary_log_format::type TYPE = binary_log_format::type::text;
+
+    static inline auto size(const string_view& object, const string_view&) -> u64 {
+        return binary_log_text_argument::size(object.data(), object.size());
+    }
+
+    static inline auto encode(u8* dst, const string_view& object, const string_view&) -> u8* {
+        return binary_log_text_argument::encode(dst, object.data(), object.size());
+    }
+};
+
+template<>
+struct binary_log_argument<const char*> {
+    static constexpr binary_log_format::type TYPE = binary_log_format::type::text;
+
+    static inline auto size(const char* const& object, const string_view&) -> u64 {
+        return binary_log_text_argument::size(object, strlen(object));
+    }
+
+    static inline auto encode(u8* dst, const char* const& object, const string_view&) -> u8* {
+        return binary_log_text_argument::encode(dst, object, strlen(object));
+    }
+};
+
+template<>
+struct binary_log_argument<char*> : binary_log_argument<const char*> {};
+
+// Converted to text while logging, the decoder only deals in char
+template<>
+struct binary_log_argument<const wchar_t*> : binary_log_formatted_argument<const wchar_t*> {};
+
+template<>
+struct binary_log_argument<wchar_t*> : binary_log_formatted_argument<const wchar_t*> {};
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+
+#include <atomic>
+
+namespace root {
+
+/**
+ * Layout of the files binary_logger writes:
+ *
+ * - A binary_log_header, alone on the first page.
+ * - The dictionary: binary_log_format_entry records, each followed by its
+ *   argument types and format text, appended as call sites are first used.
+ * - The ring: binary_log_record records, each followed by a timestamp, level,
+ *   tag and argument bytes. The ring is split in blocks of BLOCK_SIZE that
+ *   always start with a record, and a record never crosses into the next
+ *   block, so a reader can resynchronise at any block boundary.
+ *
+ * Positions in the ring grow forever, offset is position % ring capacity. A
+ * record is complete once its m_position matches where it sits.
+ */
+namespace binary_log_format {
+
+constexpr u32 MAGIC = 0x474F4C52; // "RLOG"
+constexpr u32 VERSION = 1;
+constexpr u64 HEADER_SIZE = 4096;
+constexpr u64 BLOCK_SIZE = 16 * 1024;
+constexpr u64 RECORD_ALIGNMENT = 16;
+constexpr u32 PADDING_FORMAT_ID = 0;
+// Format ids are below this, so readers can size their tables by it
+constexpr u32 MAX_FORMATS = 8192;
+constexpr u64 MAX_TAG_SIZE = 255;
+
+static_assert(std::atomic<u64>::is_always_lock_free, "The header is shared through a file mapping");
+
+/**
+ * How an argument was stored, so a reader knows which format_to() to use.
+ * Numbers are stored raw, text as a u32 length and its bytes.
+ */
+enum class type : u8 {
+    int8,
+    int16,
+    int32,
+    int64,
+    uint8,
+    uint16,
+    uint32,
+    uint64,
+    float32,
+    float64,
+    boolean,
+    text
+};
+
+struct header {
+    u32 m_magic;
+    u32 m_version;
+    u64 m_dictionary_offset;
+    u64 m_dictionary_capacity;
+    u64 m_ring_offset;
+    u64 m_ring_capacity;
+    // Messages that didn't fit in a block or whose format the dictionary had
+    // no room for
+    std::atomic<u64> m_dropped;
+    std::atomic<u64> m_dictionary_size;
+    std::atomic<u64> m_write_position;
+};
+
+struct format_entry {
+    // Whole entry, a multiple of RECORD_ALIGNMENT
+    u32 m_size;
+    u32 m_id;
+    u32 m_argument_count;
+    u32 m_format_size;
+};
+
+struct record {
+    // Whole record, a multiple of RECORD_ALIGNMENT
+    u32 m_size;
+    u32 m_format_id;
+    std::atomic<u64> m_position;
+};
+
+/**
+ * After a record's header: u64 nanoseconds since the logger was made, u8
+ * level, u8 tag size, the tag, then the arguments.
+ */
+constexpr u64 RECORD_BODY_SIZE = sizeof(u64) + 2 * sizeof(u8);
+
+static_assert(sizeof(header) <= HEADER_SIZE, "Header must fit its page");
+static_assert(sizeof(record) == RECORD_ALIGNMENT, "Any leftover in a block fits a padding record");
+static_assert(sizeof(format_entry) % RECORD_ALIGNMENT == 0, "Entries stay aligned");
+
+constexpr auto align(const u64& bytes) -> u64 {
+    return (bytes + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+
+} // namespace binary_log_format
+
+} // namespace root
\ No newline at end of file
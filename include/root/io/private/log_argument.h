@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/core/string_view.h>
+#include <root/io/formatter.h>
+
+#include <cstring>
+#include <type_traits>
+
+namespace root {
+
+/**
+ * How an argument of type T travels from the logging thread to the one that
+ * formats it. size() bytes are written by encode() on the logging thread and
+ * read back by decode() on the other, which returns something that formats the
+ * same as the original.
+ *
+ * This fallback formats T on the logging thread and ships the text, so it works
+ * for any type with strlen() and format_to().
+ */
+template<typename T>
+struct log_text_argument {
+    static inline auto size(const T& object, const string_view& format_args) -> u64 {
+        return sizeof(u64) + strlen(object, format_args);
+    }
+
+    static inline auto encode(u8* dst, const T& object, const string_view& format_args) -> u8* {
+        const u64 length = strlen(object, format_args);
+        memcpy(dst, &length, sizeof(length));
+        buffer_stream stream(buffer_slice(dst + sizeof(length), 0, length));
+        buffer_writer writer(&stream);
+        format_to(writer, object, format_args);
+        return dst + sizeof(length) + length;
+    }
+
+    static inline auto decode(const u8*& src) -> string_view {
+        u64 length;
+        memcpy(&length, src, sizeof(length));
+        const char* text = reinterpret_cast<const char*>(src + sizeof(length));
+        src += sizeof(length) + length;
+        return string_view(text, 0, length);
+    }
+};
+
+/**
+ * Strings are copied as they may not outlive the call.
+ */
+struct log_string_argument {
+    static inline auto size(const char*, const u64& length) -> u64 {
+        return sizeof(u64) + length;
+    }
+
+    static inline auto encode(u8* dst, const char* data, const u64& length) -> u8* {
+        memcpy(dst, &length, sizeof(length));
+        memcpy(dst + sizeof(length), data, length);
+        return dst + sizeof(length) + length;
+    }
+
+    static inline auto decode(const u8*& src) -> string_view {
+        u64 length;
+        memcpy(&length, src, sizeof(length));
+        const char* text = reinterpret_cast<const char*>(src + sizeof(length));
+        src += sizeof(length) + length;
+        return string_view(text, 0, length);
+    }
+};
+
+template<typename T, typename = void>
+struct log_argument : log_text_argument<T> {};
+
+/**
+ * Trivially copyable types, numbers and plain structs, are copied bit for bit
+ * and formatted on the other side.
+ */
+template<typename T>
+struct log_argument<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+    static inline auto size(const T&, const string_view&) -> u64 {
+        return sizeof(T);
+    }
+
+    static inline auto encode(u8* dst, const T& object, const string_view&) -> u8* {
+        memcpy(dst, &object, sizeof(T));
+        return dst + sizeof(T);
+    }
+
+    static inline auto decode(const u8*& src) -> T {
+        T object;
+        memcpy(&object, src, sizeof(T));
+        src += sizeof(T);
+        return object;
+    }
+};
+
+template<>
+struct log_argument<string_view> {
+    static inline auto size(const string_view& object, const string_view&) -> u64 {
+        return log_string_argument::size(object.data(), object.size());
+    }
+
+    static inline auto encode(u8* dst, const string_view& object, const string_view&) -> u8* {
+        return log_string_argument::encode(dst, object.data(), object.size());
+    }
+
+    static inline auto decode(const u8*& src) -> string_view {
+        return log_string_argument::decode(src);
+    }
+};
+
+template<>
+struct log_argument<const char*> {
+    static inline auto size(const char* const& object, const string_view&) -> u64 {
+        return log_string_argument::size(object, strlen(object));
+    }
+
+    static inline auto encode(u8* dst, const char* const& object, const string_view&) -> u8* {
+        return log_string_argument::encode(dst, object, strlen(object));
+    }
+
+    static inline auto decode(const u8*& src) -> string_view {
+        return log_string_argument::decode(src);
+    }
+};
+
+template<>
+struct log_argument<char*> : log_argument<const char*> {};
+
+// Formatted up front rather than converted on the other side
+template<>
+struct log_argument<const wchar_t*> : log_text_argument<const wchar_t*> {};
+
+template<>
+struct log_argument<wchar_t*> : log_text_argument<const wchar_t*> {};
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/assert.h>
+#include <root/core/atomic.h>
+#include <root/core/primitives.h>
+#include <root/memory/allocator.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace root {
+
+/**
+ * Single producer single consumer ring of variable sized records, one per
+ * logging thread. A record is a u64 size followed by its bytes and always
+ * sits in one contiguous piece; when one wouldn't fit before the end of the
+ * ring the producer fills the rest with a padding record and starts over at
+ * the beginning. Positions only grow, the offset in the ring is position &
+ * mask. Capacity must be a power of two.
+ *
+ * The ring is shared by its thread and the logger that drains it, and freed
+ * by whichever of the two lets go of it last.
+ */
+class log_ring final {
+public:
+    static constexpr u64 ALIGNMENT = alignof(u64);
+
+    explicit log_ring(const u64& capacity, allocator* alloc)
+    :   m_next(nullptr),
+        m_snapshot(0),
+        m_snapshot_retired(false),
+        m_data(nullptr),
+        m_mask(capacity - 1),
+        m_consumer_reported(0),
+        m_allocator(alloc) {
+        root_assert(capacity >= 2 * ALIGNMENT && (capacity & (capacity - 1)) == 0);
+        m_data = static_cast<u8*>(m_allocator->malloc(capacity, ALIGNMENT));
+        m_head.m_value.store(0, std::memory_order_relaxed);
+        m_producer.m_value.m_tail.store(0, std::memory_order_relaxed);
+        m_producer.m_value.m_cached_head = 0;
+        m_producer.m_value.m_pending = 0;
+        m_dropped.store(0, std::memory_order_relaxed);
+        m_retired.store(false, std::memory_order_relaxed);
+        m_references.store(2, std::memory_order_relaxed);
+    }
+
+    log_ring(const log_ring&) = delete;
+    auto operator=(const log_ring&) -> log_ring& = delete;
+
+    /**
+     * Producer. Space for bytes more, committed by commit().
+     * @return nullptr iff the ring is too full, the record is counted as
+     * dropped then.
+     */
+    inline auto reserve(const u64& bytes) -> u8* {
+        producer& p = m_producer.m_value;
+        const u64 size = align(sizeof(u64) + bytes);
+        u64 tail = p.m_tail.load(std::memory_order_relaxed);
+        const u64 offset = tail & m_mask;
+        const u64 padding = offset + size > capacity() ? capacity() - offset : 0;
+        if(tail + padding + size - p.m_cached_head > capacity()) {
+            p.m_cached_head = m_head.m_value.load(std::memory_order_acquire);
+            if(tail + padding + size - p.m_cached_head > capacity()) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        if(padding) {
+            write_size(tail, padding | PADDING);
+            tail += padding;
+        }
+        write_size(tail, size);
+        p.m_pending = tail + size;
+        return m_data + (tail & m_mask) + sizeof(u64);
+    }
+
+    /**
+     * Producer. Publish the record from the last reserve().
+     */
+    inline auto commit() -> void {
+        m_producer.m_value.m_tail.store(m_producer.m_value.m_pending, std::memory_order_release);
+    }
+
+    /**
+     * Consumer. Position up to which records are readable.
+     */
+    inline auto tail() const -> u64 {
+        return m_producer.m_value.m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Consumer. The oldest record before tail, skipping padding.
+     * @return nullptr iff there is none.
+     */
+    inline auto front(const u64& tail) -> const u8* {
+        u64 head = m_head.m_value.load(std::memory_order_relaxed);
+        if(head == tail) return nullptr;
+        const u64 size = read_size(head);
+        if(size & PADDING) {
+            head += size & ~PADDING;
+            m_head.m_value.store(head, std::memory_order_release);
+            if(head == tail) return nullptr;
+        }
+        return m_data + (head & m_mask) + sizeof(u64);
+    }
+
+    /**
+     * Consumer. Hand the record from front() back to the producer.
+     */
+    inline auto pop() -> void {
+        const u64 head = m_head.m_value.load(std::memory_order_relaxed);
+        m_head.m_value.store(head + read_size(head), std::memory_order_release);
+    }
+
+    inline auto capacity() const -> u64 {
+        return m_mask + 1;
+    }
+
+    /**
+     * Records that didn't fit since the consumer last asked.
+     */
+    inline auto take_dropped() -> u64 {
+        const u64 dropped = m_dropped.load(std::memory_order_relaxed);
+        const u64 fresh = dropped - m_consumer_reported;
+        m_consumer_reported = dropped;
+        return fresh;
+    }
+
+    /**
+     * The producer thread is gone, nothing more will be committed.
+     */
+    inline auto retire() -> void {
+        m_retired.store(true, std::memory_order_release);
+    }
+
+    inline auto retired() const -> bool {
+        return m_retired.load(std::memory_order_acquire);
+    }
+
+    /**
+     * The logger has let go, only the thread still holds the ring.
+     */
+    inline auto orphaned() const -> bool {
+        return m_references.load(std::memory_order_acquire) == 1;
+    }
+
+    /**
+     * Called once by the thread and once by the logger, the last one frees.
+     */
+    inline auto release() -> void {
+        if(m_references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_allocator->del(this);
+        }
+    }
+
+    ~log_ring() {
+        m_allocator->free(m_data);
+    }
+
+    // Consumer's bookkeeping: its list of rings, how far to read this pass and
+    // whether the ring was retired before that
+    log_ring* m_next;
+    u64 m_snapshot;
+    bool m_snapshot_retired;
+
+private:
+    static constexpr u64 PADDING = 1ull << 63;
+
+    struct producer {
+        std::atomic<u64> m_tail;
+        u64 m_cached_head;
+        u64 m_pending;
+    };
+
+    inline static auto align(const u64& bytes) -> u64 {
+        return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    inline auto write_size(const u64& position, const u64& size) -> void {
+        memcpy(m_data + (position & m_mask), &size, sizeof(size));
+    }
+
+    inline auto read_size(const u64& position) const -> u64 {
+        u64 size;
+        memcpy(&size, m_data + (position & m_mask), sizeof(size));
+        return size;
+    }
+
+    // The consumer's position and the producer's state on separate lines
+    cache_padded<std::atomic<u64>> m_head;
+    cache_padded<producer> m_producer;
+    u8* m_data;
+    u64 m_mask;
+    u64 m_consumer_reported;
+    std::atomic<u64> m_dropped;
+    std::atomic<bool> m_retired;
+    std::atomic<u32> m_references;
+    allocator* m_allocator;
+};
+
+} // namespace root
\ No newline at end of file
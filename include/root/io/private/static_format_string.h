@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/string_view.h>
+
+#include <type_traits>
+
+namespace root {
+
+/**
+ * Where a placeholder's braces are in its format string.
+ */
+struct placeholder {
+    u64 m_open;
+    u64 m_close;
+};
+
+template<u64 N>
+struct placeholder_table {
+    placeholder m_placeholders[N > 0 ? N : 1];
+};
+
+/**
+ * Every { is closed by a } before the next one and there is no } outside a
+ * placeholder.
+ */
+constexpr auto placeholders_well_formed(const char* text, const u64& size) -> bool {
+    bool open = false;
+    for(u64 i = 0; i < size; i++) {
+        if(text[i] == '{') {
+            if(open) return false;
+            open = true;
+        } else if(text[i] == '}') {
+            if(!open) return false;
+            open = false;
+        }
+    }
+    return !open;
+}
+
+constexpr auto count_placeholders(const char* text, const u64& size) -> u64 {
+    u64 count = 0;
+    for(u64 i = 0; i < size; i++) {
+        if(text[i] == '{') count++;
+    }
+    return count;
+}
+
+template<u64 N>
+constexpr auto parse_placeholders(const char* text, const u64& size) -> placeholder_table<N> {
+    placeholder_table<N> table{};
+    u64 count = 0;
+    for(u64 i = 0; i < size; i++) {
+        if(text[i] == '{') {
+            table.m_placeholders[count].m_open = i;
+        } else if(text[i] == '}') {
+            table.m_placeholders[count++].m_close = i;
+        }
+    }
+    return table;
+}
+
+/**
+ * A format string whose placeholders are found while compiling, made with the
+ * _fmt literal. Formatting one is a fixed sequence of literal copies and
+ * argument writes, and a placeholder count that doesn't match the arguments
+ * or format args that don't apply to an argument's type fail to compile.
+ */
+template<char... Chars>
+class static_format_string {
+public:
+    static constexpr char TEXT[] = {Chars..., '\0'};
+    static constexpr u64 SIZE = sizeof...(Chars);
+
+    static_assert(placeholders_well_formed(TEXT, SIZE), "Unmatched { or } in format string");
+
+    static constexpr u64 PLACEHOLDERS = count_placeholders(TEXT, SIZE);
+    static constexpr placeholder_table<PLACEHOLDERS> TABLE = parse_placeholders<PLACEHOLDERS>(TEXT, SIZE);
+
+    /**
+     * Bounds of the literal text before placeholder i, or after the last one
+     * for i == PLACEHOLDERS.
+     */
+    static constexpr auto literal_begin(const u64& i) -> u64 {
+        return i == 0 ? 0 : TABLE.m_placeholders[i - 1].m_close + 1;
+    }
+
+    static constexpr auto literal_end(const u64& i) -> u64 {
+        return i == PLACEHOLDERS ? SIZE : TABLE.m_placeholders[i].m_open;
+    }
+
+    /**
+     * @return total length of the text outside placeholders.
+     */
+    static constexpr auto literal_size() -> u64 {
+        u64 size = 0;
+        for(u64 i = 0; i <= PLACEHOLDERS; i++) {
+            size += literal_end(i) - literal_begin(i);
+        }
+        return size;
+    }
+
+    static inline auto format_args(const u64& i) -> string_view {
+        return string_view(TEXT, TABLE.m_placeholders[i].m_open + 1, TABLE.m_placeholders[i].m_close);
+    }
+
+    inline operator string_view() const {
+        return string_view(TEXT, 0, SIZE);
+    }
+};
+
+/**
+ * Whether the format args of a placeholder, text[first, last), mean anything
+ * for T. Integers take {[0][width][x|X|b|o|d]}, floats {[.precision][e|f]};
+ * other types accept anything.
+ */
+template<typename T, typename = void>
+struct format_args_check {
+    static constexpr auto valid(const char*, const u64&, const u64&) -> bool {
+        return true;
+    }
+};
+
+template<typename T>
+struct format_args_check<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    static constexpr auto valid(const char* text, const u64& first, const u64& last) -> bool {
+        u64 i = first;
+        while(i < last && text[i] >= '0' && text[i] <= '9') {
+            i++;
+        }
+        if(i < last) {
+            const char c = text[i++];
+            if(c != 'x' && c != 'X' && c != 'b' && c != 'o' && c != 'd') return false;
+        }
+        return i == last;
+    }
+};
+
+template<typename T>
+struct format_args_check<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static constexpr auto valid(const char* text, const u64& first, const u64& last) -> bool {
+        u64 i = first;
+        if(i < last && text[i] == '.') {
+            i++;
+            while(i < last && text[i] >= '0' && text[i] <= '9') {
+                i++;
+            }
+        }
+        if(i < last) {
+            const char c = text[i++];
+            if(c != 'e' && c != 'f') return false;
+        }
+        return i == last;
+    }
+};
+
+inline namespace literals {
+
+/**
+ * "x = {}"_fmt. Relies on string literal operator templates, a GNU extension
+ * gcc and clang both support.
+ */
+template<typename C, C... Chars>
+constexpr auto operator""_fmt() -> static_format_string<Chars...> {
+    return static_format_string<Chars...>();
+}
+
+} // namespace literals
+
+} // namespace root
\ No newline at end of file
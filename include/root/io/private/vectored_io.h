@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/array_slice.h>
+#include <root/core/buffer_slice.h>
+#include <root/core/error.h>
+#include <root/core/primitives.h>
+
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+#include <cerrno>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace root {
+namespace vectored_io {
+
+// Slices are handed to the kernel this many at a time
+constexpr u64 MAX_IOVECS = 64;
+
+/**
+ * Skip the first bytes of an iovec array, after a short transfer.
+ */
+inline auto advance(iovec*& iov, int& count, u64 bytes) -> void {
+    while(count && bytes >= iov->iov_len) {
+        bytes -= iov->iov_len;
+        iov++;
+        count--;
+    }
+    if(count) {
+        iov->iov_base = static_cast<u8*>(iov->iov_base) + bytes;
+        iov->iov_len -= bytes;
+    }
+}
+
+/**
+ * Write all of iov at offset, or at the file position if offset is negative.
+ */
+inline auto write_all(const int& fd, iovec* iov, int count, i64 offset) -> error {
+    while(count) {
+        const ssize_t res = offset < 0 ? ::writev(fd, iov, count) : pwritev(fd, iov, count, offset);
+        if(res < 0) {
+            if(errno == EINTR) continue;
+            return error::UNKNOWN_ERROR;
+        }
+        if(offset >= 0) offset += res;
+        advance(iov, count, res);
+    }
+    return error::NO_ERROR;
+}
+
+/**
+ * Read into iov from offset until it is full or the file ends.
+ */
+inline auto read_all(const int& fd, iovec* iov, int count, u64 offset) -> value_or_error<u64> {
+    u64 total = 0;
+    while(count) {
+        const ssize_t res = preadv(fd, iov, count, offset);
+        if(res < 0) {
+            if(errno == EINTR) continue;
+            return error::UNKNOWN_ERROR;
+        }
+        if(res == 0) break;
+        offset += res;
+        total += res;
+        advance(iov, count, res);
+    }
+    return total;
+}
+
+inline auto to_iovec(const buffer_slice& slice) -> iovec {
+    return iovec{const_cast<void*>(slice.data()), slice.size()};
+}
+
+} // namespace vectored_io
+} // namespace root
+#endif
\ No newline at end of file
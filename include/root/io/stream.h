@@ -20,6 +20,8 @@
 #pragma once
 
 #include <root/core/primitives.h>
+#include <root/core/array_slice.h>
+#include <root/core/buffer_slice.h>
 #include <root/core/error.h>
 
 #include <limits>
@@ -40,6 +42,38 @@ public:
     virtual auto seek(const i64& offset, const relative_to& relative_to = relative_to::start) -> error = 0;
     virtual auto tell(const relative_to& relative_to = relative_to::start) const -> value_or_error<i64> = 0;
 
+    /**
+     * Scatter read filling each slice in turn. Streams backed by a file
+     * descriptor override these to do it in one syscall, the default just
+     * calls read() per slice.
+     * @return total bytes read, less than requested only at the end of the stream.
+     */
+    virtual auto readv(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> {
+        u64 total = 0;
+        for(u64 i = 0; i < buffers.size(); i++) {
+            buffer_slice dst = buffers[i];
+            const value_or_error<u64> res = read(dst.data(), dst.size());
+            if(!res) return res;
+            total += res.value();
+            if(res.value() < dst.size()) break;
+        }
+        return total;
+    }
+
+    /**
+     * Gather write of each slice in turn, see readv().
+     */
+    virtual auto writev(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> {
+        u64 total = 0;
+        for(u64 i = 0; i < buffers.size(); i++) {
+            const value_or_error<u64> res = write(buffers[i].data(), buffers[i].size());
+            if(!res) return res;
+            total += res.value();
+            if(res.value() < buffers[i].size()) break;
+        }
+        return total;
+    }
+
     virtual ~stream() {}
 };
 
@@ -30,5 +30,7 @@ public:
     MOCK_METHOD(value_or_error<u64>, write, (const void*, const u64&));
     MOCK_METHOD(error, seek, (const i64&, const relative_to&));
     MOCK_METHOD(value_or_error<i64>, tell, (const relative_to&), (const));
+    MOCK_METHOD(value_or_error<u64>, readv, (const array_slice<buffer_slice>&));
+    MOCK_METHOD(value_or_error<u64>, writev, (const array_slice<buffer_slice>&));
 };
 } // namespace root
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include <root/io/stream.h>
 #include <root/io/file_stream.h>
 #include <root/io/buffer_stream.h>
+#include <root/io/dynamic_buffer_stream.h>
 
 namespace root {
 
@@ -34,6 +35,10 @@ public:
         return m_stream->write(src, len);
     }
 
+    inline auto writev(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> {
+        return m_stream->writev(buffers);
+    }
+
     inline auto seek(const i64& offset, const relative_to& relative_to = relative_to::start) -> error {
         return m_stream->seek(offset, relative_to);
     }
@@ -53,5 +58,6 @@ using writer = writer_interface<>;
 // TODO: should I move these to the file defining file_stream & buffer_stream?
 using file_writer = writer_interface<file_stream>;
 using buffer_writer = writer_interface<buffer_stream>;
+using dynamic_buffer_writer = writer_interface<dynamic_buffer_stream>;
 
 } // namespace root
\ No newline at end of file
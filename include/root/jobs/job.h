@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+
+#include <atomic>
+#include <utility>
+
+namespace root {
+
+namespace jobs {
+
+class counter;
+
+/**
+ * Unit of work for the job system. The storage is owned by whoever runs the
+ * job and must stay alive until the job's counter reaches zero, which for
+ * fork/join code usually means the job lives on the stack of the waiter.
+ */
+struct job {
+    using function = auto (*)(job*) -> void;
+
+    explicit job(function f) : m_function(f) {}
+
+    function m_function;
+    counter* m_counter{nullptr};
+};
+
+/**
+ * Number of jobs still pending, incremented by run() and decremented when a
+ * job finishes. An optional continuation is run once it drops to zero; it must
+ * be set before any job is run against the counter.
+ */
+class counter {
+public:
+    counter() {}
+
+    explicit counter(job* continuation)
+    :   m_continuation(continuation) {}
+
+    counter(const counter&) = delete;
+    auto operator=(const counter&) -> counter& = delete;
+
+    inline auto done() const -> bool {
+        return m_pending.load(std::memory_order_acquire) == 0;
+    }
+
+    inline auto pending() const -> u32 {
+        return m_pending.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<u32> m_pending{0};
+    job* m_continuation{nullptr};
+
+    friend auto run(job* j, counter* c) -> void;
+    friend auto execute(job* j) -> void;
+};
+
+/**
+ * Job wrapping any callable taking no arguments.
+ */
+template<typename F>
+struct function_job final : public job {
+    explicit function_job(F&& f)
+    :   job(&function_job::invoke), m_callable(std::forward<F>(f)) {}
+
+    inline static auto invoke(job* j) -> void {
+        static_cast<function_job*>(j)->m_callable();
+    }
+
+    F m_callable;
+};
+
+template<typename F>
+inline auto make_job(F&& f) -> function_job<F> {
+    return function_job<F>(std::forward<F>(f));
+}
+
+} // namespace jobs
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/array_slice.h>
+#include <root/jobs/job.h>
+#include <root/memory/allocator.h>
+
+namespace root {
+
+namespace jobs {
+
+/**
+ * Start the worker pool. The calling thread becomes worker 0 and helps out
+ * whenever it waits; worker_count - 1 threads are started and pinned to their
+ * own core. 0 picks one worker per hardware thread.
+ */
+auto init(const u32& worker_count = 0, allocator* alloc = allocator::get_default()) -> void;
+
+/**
+ * Stop and join the workers. Every job run must have finished.
+ */
+auto deinit() -> void;
+
+/**
+ * @return number of workers including the thread that called init(), 0 when
+ * the job system isn't running.
+ */
+auto worker_count() -> u32;
+
+/**
+ * Schedule j, counting it on c if given. Runs j inline when the job system
+ * isn't running or every queue is full.
+ */
+auto run(job* j, counter* c = nullptr) -> void;
+
+/**
+ * Run other jobs until c drops to zero.
+ */
+auto wait(counter* c) -> void;
+
+/**
+ * @return the grain parallel_for uses for size elements when none is given.
+ */
+auto default_grain(const u64& size) -> u64;
+
+template<typename T, typename F>
+struct range_job final : public job {
+    range_job(const array_slice<T>& slice, F* callable, const u64& grain)
+    :   job(&range_job::invoke), m_slice(slice), m_callable(callable), m_grain(grain) {}
+
+    /**
+     * Split off the upper half as a new job until the range is no bigger than
+     * the grain, so idle workers steal big chunks first.
+     */
+    inline static auto process(array_slice<T> slice, F* callable, const u64& grain) -> void {
+        if(slice.size() > grain) {
+            const u64 middle = slice.size() / 2;
+            range_job upper(array_slice<T>(slice.data(), middle, slice.size()), callable, grain);
+            counter pending;
+            run(&upper, &pending);
+            process(array_slice<T>(slice.data(), 0, middle), callable, grain);
+            wait(&pending);
+            return;
+        }
+        for(u64 i = 0; i < slice.size(); i++) {
+            (*callable)(slice[i]);
+        }
+    }
+
+    inline static auto invoke(job* j) -> void {
+        range_job* self = static_cast<range_job*>(j);
+        process(self->m_slice, self->m_callable, self->m_grain);
+    }
+
+    array_slice<T> m_slice;
+    F* m_callable;
+    u64 m_grain;
+};
+
+/**
+ * Call f on every element of slice across the workers and wait for all of
+ * them. grain is the most elements a single job handles, 0 sizes it from the
+ * number of workers.
+ */
+template<typename T, typename F>
+inline auto parallel_for(array_slice<T> slice, F&& f, const u64& grain = 0) -> void {
+    range_job<T, std::remove_reference_t<F>>::process(slice, &f, grain ? grain : default_grain(slice.size()));
+}
+
+} // namespace jobs
+
+} // namespace root
\ No newline at end of file
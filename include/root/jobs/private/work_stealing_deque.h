@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/assert.h>
+#include <root/core/atomic.h>
+#include <root/core/primitives.h>
+#include <root/memory/allocator.h>
+
+#include <atomic>
+
+namespace root {
+
+namespace jobs {
+
+/**
+ * Fixed capacity Chase-Lev deque of pointers. The owning thread pushes and pops
+ * at the bottom, any other thread steals from the top. Follows the C11 version
+ * of Lê, Pop, Cohen and Zappa Nardelli with sequentially consistent operations
+ * in place of the standalone fences.
+ */
+template<typename T>
+class work_stealing_deque final {
+public:
+    explicit work_stealing_deque(const u64& capacity, allocator* alloc = allocator::get_default())
+    :   m_mask(capacity - 1),
+        m_allocator(alloc) {
+        root_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+        m_buffer = static_cast<std::atomic<T*>*>(alloc->malloc(sizeof(std::atomic<T*>) * capacity, alignof(std::atomic<T*>)));
+        for(u64 i = 0; i < capacity; i++) {
+            new (&m_buffer[i]) std::atomic<T*>(nullptr);
+        }
+        m_top.m_value.store(0, std::memory_order_relaxed);
+        m_bottom.m_value.store(0, std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    auto operator=(const work_stealing_deque&) -> work_stealing_deque& = delete;
+
+    ~work_stealing_deque() {
+        m_allocator->free(m_buffer);
+    }
+
+    /**
+     * Owner only.
+     * @return false iff the deque is full.
+     */
+    inline auto push(T* value) -> bool {
+        const i64 b = m_bottom.m_value.load(std::memory_order_relaxed);
+        const i64 t = m_top.m_value.load(std::memory_order_acquire);
+        if(b - t > static_cast<i64>(m_mask)) return false;
+        m_buffer[b & m_mask].store(value, std::memory_order_relaxed);
+        m_bottom.m_value.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Owner only.
+     * @return the most recently pushed value or nullptr if empty.
+     */
+    inline auto pop() -> T* {
+        const i64 b = m_bottom.m_value.load(std::memory_order_relaxed) - 1;
+        m_bottom.m_value.store(b, std::memory_order_seq_cst);
+        i64 t = m_top.m_value.load(std::memory_order_seq_cst);
+        if(t > b) {
+            m_bottom.m_value.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T* value = m_buffer[b & m_mask].load(std::memory_order_relaxed);
+        if(t == b) {
+            // Last element, race the thieves for it
+            if(!m_top.m_value.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                value = nullptr;
+            }
+            m_bottom.m_value.store(b + 1, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    /**
+     * Any thread.
+     * @return the oldest value or nullptr if empty or another thread won it.
+     */
+    inline auto steal() -> T* {
+        i64 t = m_top.m_value.load(std::memory_order_seq_cst);
+        const i64 b = m_bottom.m_value.load(std::memory_order_seq_cst);
+        if(t >= b) return nullptr;
+        T* value = m_buffer[t & m_mask].load(std::memory_order_relaxed);
+        if(!m_top.m_value.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return value;
+    }
+
+    /**
+     * @return number of elements, only a hint while others steal.
+     */
+    inline auto size_hint() const -> u64 {
+        const i64 b = m_bottom.m_value.load(std::memory_order_relaxed);
+        const i64 t = m_top.m_value.load(std::memory_order_relaxed);
+        return b > t ? static_cast<u64>(b - t) : 0;
+    }
+
+private:
+    cache_padded<std::atomic<i64>> m_top;
+    cache_padded<std::atomic<i64>> m_bottom;
+    std::atomic<T*>* m_buffer;
+    u64 m_mask;
+    allocator* m_allocator;
+};
+
+} // namespace jobs
+
+} // namespace root
\ No newline at end of file
@@ -21,29 +21,62 @@
 
 #include <cstdlib>
 #include <new>
+#include <utility>
 #include <root/core/primitives.h>
-#include <root/memory/private/reference_counter.h>
+#include <root/memory/private/control_block.h>
+#include <root/memory/private/local_reference_counter.h>
 
 namespace root {
 
-template<typename C> class strong_ptr;
+template<typename C, typename Counter = reference_counter> class strong_ptr;
+template<typename C> class intrusive_ptr;
+template<typename C> class intrusive_ref_counted;
 
 class allocator {
 public:
     template<typename C, typename... Args>
-    inline auto make(Args... args) -> C* {
+    inline auto make(Args&&... args) -> C* {
         void* ptr = malloc(sizeof(C), alignof(C));
-        return new (ptr) C(args...);
+        return new (ptr) C(std::forward<Args>(args)...);
     }
 
+    /**
+     * Make a strong_ptr whose object and reference_counter share one allocation.
+     */
     template<typename C, typename... Args>
     inline auto make_strong(Args... args) -> strong_ptr<C> {
-        C* memory = make<C>(args...);
-        reference_counter* ref_counter = make<reference_counter>();
-        strong_ptr<C> ptr = strong_ptr<C>(memory, ref_counter, this);
+        return make_counted<C, reference_counter>(args...);
+    }
+
+    /**
+     * Like make_strong but with non-atomic counts, for objects that are never
+     * shared across threads.
+     */
+    template<typename C, typename... Args>
+    inline auto make_local_strong(Args... args) -> strong_ptr<C, local_reference_counter> {
+        return make_counted<C, local_reference_counter>(args...);
+    }
+
+    template<typename C, typename Counter, typename... Args>
+    inline auto make_counted(Args... args) -> strong_ptr<C, Counter> {
+        void* mem = malloc(sizeof(control_block<C, Counter>), alignof(control_block<C, Counter>));
+        control_block<C, Counter>* block = new (mem) control_block<C, Counter>;
+        C* memory = new (block->object()) C(args...);
+        strong_ptr<C, Counter> ptr = strong_ptr<C, Counter>(memory, &block->m_counter, this);
         return ptr;
     }
 
+    /**
+     * Make an object deriving from intrusive_ref_counted<C>, freed through this
+     * allocator once its last intrusive_ptr is gone.
+     */
+    template<typename C, typename... Args>
+    inline auto make_intrusive(Args&&... args) -> intrusive_ptr<C> {
+        C* memory = make<C>(std::forward<Args>(args)...);
+        static_cast<intrusive_ref_counted<C>*>(memory)->m_allocator = this;
+        return intrusive_ptr<C>(memory);
+    }
+
     template<typename C>
     inline auto del(C* ptr) -> void {
         ptr->~C();
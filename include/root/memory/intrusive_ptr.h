@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/memory/intrusive_ref_counted.h>
+
+namespace root {
+
+/**
+ * Owning pointer to an object deriving from intrusive_ref_counted<C>. The count
+ * lives in the object, so a raw C* can be turned back into an owning pointer.
+ */
+template<typename C>
+class intrusive_ptr final {
+public:
+    intrusive_ptr() {}
+
+    explicit intrusive_ptr(C* memory)
+    :   m_memory(memory) {
+        lock();
+    }
+
+    intrusive_ptr(const intrusive_ptr& other)
+    :   m_memory(other.m_memory) {
+        lock();
+    }
+
+    intrusive_ptr(intrusive_ptr&& other)
+    :   m_memory(other.m_memory) {
+        other.m_memory = nullptr;
+    }
+
+    inline auto operator=(const intrusive_ptr& other) -> intrusive_ptr& {
+        if(this != &other) {
+            C* previous = m_memory;
+            m_memory = other.m_memory;
+            lock();
+            unlock(previous);
+        }
+        return *this;
+    }
+
+    inline auto operator=(intrusive_ptr&& other) -> intrusive_ptr& {
+        if(this != &other) {
+            unlock(m_memory);
+            m_memory = other.m_memory;
+            other.m_memory = nullptr;
+        }
+        return *this;
+    }
+
+    ~intrusive_ptr() {
+        unlock(m_memory);
+    }
+
+    /**
+     * @return a reference to the underlying object.
+     */
+    inline auto operator*() const -> C& {
+        return *m_memory;
+    }
+
+    /**
+     * @return the stored pointer.
+     */
+    inline auto operator->() const -> C* {
+        return m_memory;
+    }
+
+    /**
+     * @return the stored pointer.
+     */
+    inline auto get() const -> C* {
+        return m_memory;
+    }
+
+    /**
+     * @return true iff stored pointer isn't null.
+     */
+    inline operator bool() const {
+        return m_memory != nullptr;
+    }
+
+    /**
+     * Clear the pointer. Losing a reference and maybe deallocating.
+     */
+    inline auto clear() -> void {
+        unlock(m_memory);
+        m_memory = nullptr;
+    }
+
+private:
+    inline auto lock() -> void {
+        if(m_memory) static_cast<intrusive_ref_counted<C>*>(m_memory)->add_ref();
+    }
+
+    inline static auto unlock(C* memory) -> void {
+        if(memory) static_cast<intrusive_ref_counted<C>*>(memory)->release();
+    }
+
+    C* m_memory{nullptr};
+};
+
+/**
+ * Make an intrusive_ptr using the default allocator.
+ * @return newly created intrusive_ptr
+ */
+template<typename C, typename... Args>
+inline auto make_intrusive(Args&&... args) -> intrusive_ptr<C> {
+    return allocator::get_default()->make_intrusive<C>(std::forward<Args>(args)...);
+}
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/memory/allocator.h>
+
+#include <atomic>
+
+namespace root {
+
+template<typename C> class intrusive_ptr;
+
+/**
+ * Base for objects that carry their own reference count, to be held in
+ * intrusive_ptr<C>. C is the type the object is destroyed as, so it must be the
+ * most derived type or have a virtual destructor.
+ *
+ * Objects made with allocator::make_intrusive are returned to that allocator
+ * when the last intrusive_ptr goes away. Objects constructed any other way are
+ * never freed by their pointers.
+ */
+template<typename C>
+class intrusive_ref_counted {
+public:
+    inline auto ref_count() const -> u32 {
+        return m_references.load(std::memory_order_relaxed);
+    }
+
+protected:
+    intrusive_ref_counted() {}
+
+    // Copies are new objects with no references to them.
+    intrusive_ref_counted(const intrusive_ref_counted&) {}
+    auto operator=(const intrusive_ref_counted&) -> intrusive_ref_counted& {
+        return *this;
+    }
+
+    ~intrusive_ref_counted() {}
+
+private:
+    inline auto add_ref() -> void {
+        m_references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline auto release() -> void {
+        if(m_references.fetch_sub(1, std::memory_order_acq_rel) == 1 && m_allocator) {
+            m_allocator->template del<C>(static_cast<C*>(this));
+        }
+    }
+
+    std::atomic<u32> m_references{0};
+    allocator* m_allocator{nullptr};
+
+    friend class intrusive_ptr<C>;
+    friend class allocator;
+};
+
+} // namespace root
\ No newline at end of file
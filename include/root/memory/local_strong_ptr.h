@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/memory/private/local_reference_counter.h>
+#include <root/memory/strong_ptr.h>
+#include <root/memory/weak_ptr.h>
+
+namespace root {
+
+/**
+ * strong_ptr/weak_ptr with non-atomic reference counts. Cheaper to copy, but
+ * every copy must stay on the thread that made the object.
+ */
+template<typename C>
+using local_strong_ptr = strong_ptr<C, local_reference_counter>;
+
+template<typename C>
+using local_weak_ptr = weak_ptr<C, local_reference_counter>;
+
+/**
+ * Make a local_strong_ptr using the default allocator.
+ * @return newly created local_strong_ptr
+ */
+template<typename C, typename... Args>
+inline auto make_local_strong(Args... args) -> local_strong_ptr<C> {
+    return allocator::get_default()->make_local_strong<C>(args...);
+}
+
+} // namespace root
\ No newline at end of file
@@ -23,29 +23,80 @@
 #include <root/memory/allocator.h>
 
 namespace root {
-// TODO: most of the functionality
+
+/**
+ * Bump-pointer arena. Allocations are carved out of blocks taken from the
+ * backing resource and are only given back on reset() or destruction. When a
+ * block runs out a new one, twice as big as the last, is chained after it.
+ */
 class monotonic_allocator : public allocator {
 public:
-    monotonic_allocator(const u64& bytes, allocator* backing_resource = allocator::get_default())
-    :   m_size(bytes),
-        m_memory(static_cast<u8*>(backing_resource->malloc(bytes, 1))),
-        m_head(m_memory),
-        m_backing_resource(backing_resource){}
-
-    virtual auto malloc(const u64& bytes, const u64& alignment) -> void* override {
-        
-    }
+    explicit monotonic_allocator(const u64& bytes, allocator* backing_resource = allocator::get_default());
+
+    monotonic_allocator(const monotonic_allocator&) = delete;
+    auto operator=(const monotonic_allocator&) -> monotonic_allocator& = delete;
 
+    virtual auto malloc(const u64& bytes, const u64& alignment) -> void* override;
+
+    /**
+     * No-op, memory is reclaimed by reset() or on destruction.
+     */
     virtual auto free(void* mem) -> void override {}
 
-    virtual ~monotonic_allocator() {
-        m_backing_resource->free(m_memory);
+    /**
+     * Rewind the arena to the start of the first block. Chained blocks are
+     * kept around to be reused, so this is O(1). Every pointer previously
+     * returned by malloc is invalidated.
+     */
+    auto reset() -> void;
+
+    /**
+     * @return bytes consumed since construction or the last reset(), alignment
+     * padding and the unused tails of filled blocks included.
+     */
+    inline auto bytes_used() const -> u64 {
+        return m_bytes_used;
+    }
+
+    /**
+     * @return the largest value bytes_used() has ever reached.
+     */
+    inline auto high_water_mark() const -> u64 {
+        return m_high_water_mark;
     }
 
+    /**
+     * @return number of blocks taken from the backing resource.
+     */
+    inline auto block_count() const -> u64 {
+        return m_block_count;
+    }
+
+    virtual ~monotonic_allocator();
+
 protected:
-    const u64 m_size;
-    u8* const m_memory;
+    struct block {
+        block* m_next;
+        u64 m_size;
+
+        inline auto begin() -> u8* {
+            return reinterpret_cast<u8*>(this + 1);
+        }
+
+        inline auto end() -> u8* {
+            return begin() + m_size;
+        }
+    };
+
+    auto make_block(const u64& bytes) -> block*;
+
+    block* m_first;
+    block* m_current;
     u8* m_head;
+    u64 m_next_block_size;
+    u64 m_bytes_used;
+    u64 m_high_water_mark;
+    u64 m_block_count;
     allocator* m_backing_resource;
 };
 
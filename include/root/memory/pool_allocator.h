@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/memory/allocator.h>
+
+#include <mutex>
+
+namespace root {
+
+/**
+ * Segregated size class allocator for small, fixed size objects such as the
+ * ones make_strong creates. Each class keeps an intrusive free list threaded
+ * through slabs of SLAB_SIZE bytes taken from the backing allocator. Slabs are
+ * only returned to the backing allocator on destruction.
+ *
+ * Requests bigger than MAX_CLASS_SIZE go straight to the backing allocator
+ * aligned to SLAB_SIZE, which is what tells them apart from pooled blocks on
+ * free().
+ */
+class pool_allocator final : public allocator {
+public:
+    constexpr static u64 SLAB_SIZE = 4096;
+    constexpr static u64 MIN_CLASS_SIZE = 16;
+    constexpr static u64 MAX_CLASS_SIZE = 256;
+    constexpr static u64 NUM_CLASSES = 5;
+
+    explicit pool_allocator(allocator* backing_resource = allocator::get_default());
+
+    pool_allocator(const pool_allocator&) = delete;
+    auto operator=(const pool_allocator&) -> pool_allocator& = delete;
+
+    auto malloc(const u64& bytes, const u64& alignment) -> void* override;
+    auto free(void* mem) -> void override;
+
+    /**
+     * @return number of slabs taken from the backing allocator.
+     */
+    auto slab_count() const -> u64;
+
+    ~pool_allocator();
+
+private:
+    struct free_block {
+        free_block* m_next;
+    };
+
+    struct slab {
+        slab* m_next;
+        u64 m_class_index;
+    };
+
+    struct size_class {
+        std::mutex m_lock;
+        free_block* m_free_list{nullptr};
+        slab* m_slabs{nullptr};
+        u64 m_slab_count{0};
+    };
+
+    inline static auto class_size(const u64& class_index) -> u64 {
+        return MIN_CLASS_SIZE << class_index;
+    }
+
+    auto refill(size_class& sc, const u64& class_index) -> bool;
+
+    size_class m_classes[NUM_CLASSES];
+    allocator* m_backing_resource;
+};
+
+} // namespace root
\ No newline at end of file
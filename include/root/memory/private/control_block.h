@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/memory/private/reference_counter.h>
+
+namespace root {
+
+/**
+ * Single allocation holding a reference counter followed by storage for the
+ * managed object. The counter sits at offset 0 so releasing it through the
+ * allocator releases the whole block, which only happens once the object has
+ * been destroyed and the last weak reference is gone.
+ */
+template<typename C, typename Counter = reference_counter>
+struct control_block final {
+    Counter m_counter;
+    alignas(C) u8 m_storage[sizeof(C)];
+
+    inline auto object() -> C* {
+        return reinterpret_cast<C*>(m_storage);
+    }
+};
+
+} // namespace root
\ No newline at end of file
@@ -23,10 +23,10 @@
 #include <root/memory/allocator.h>
 
 namespace root {
-template<typename C>
+template<typename C, typename Counter = reference_counter>
 struct managed_ptr final {
     C                   *m_memory{nullptr};
-    reference_counter   *m_ref_count{nullptr};
+    Counter             *m_ref_count{nullptr};
     allocator           *m_allocator{allocator::get_default()};
 
     /*
@@ -36,24 +36,24 @@ struct managed_ptr final {
     auto operator=(const managed_ptr& other) -> managed_ptr& = delete;
     auto operator=(managed_ptr&& other) -> managed_ptr& = delete;
 
-    managed_ptr(C* memory, reference_counter* ref_counter, allocator* alloc);
+    managed_ptr(C* memory, Counter* ref_counter, allocator* alloc);
     managed_ptr(const managed_ptr& other);
     managed_ptr(managed_ptr&& other);
     managed_ptr() {}
 };
 
-template <typename C> 
-inline managed_ptr<C>::managed_ptr(C* memory, reference_counter* ref_counter, allocator* alloc) 
+template <typename C, typename Counter>
+inline managed_ptr<C, Counter>::managed_ptr(C* memory, Counter* ref_counter, allocator* alloc) 
 :   m_memory(memory),
     m_ref_count(ref_counter),
     m_allocator(alloc) {}
 
-template <typename C>
-inline managed_ptr<C>::managed_ptr(const managed_ptr& other)
+template <typename C, typename Counter>
+inline managed_ptr<C, Counter>::managed_ptr(const managed_ptr& other)
 :   managed_ptr(other.m_memory, other.m_ref_count, other.m_allocator) {}
 
-template <typename C>
-inline managed_ptr<C>::managed_ptr(managed_ptr&& other)
+template <typename C, typename Counter>
+inline managed_ptr<C, Counter>::managed_ptr(managed_ptr&& other)
 :   m_memory(std::move(other.m_memory)), 
     m_ref_count(std::move(other.m_ref_count)), 
     m_allocator(std::move(other.m_allocator)) {}
@@ -23,9 +23,13 @@
 
 namespace root {
 
-template<typename C> class weak_ptr;
+template<typename C, typename Counter = reference_counter> class weak_ptr;
 
-template<typename C>
+/**
+ * Counter is the reference counting policy, see reference_counter and
+ * local_reference_counter.
+ */
+template<typename C, typename Counter>
 class strong_ptr final {
 public:
     strong_ptr(const strong_ptr& other)
@@ -42,9 +46,9 @@ public:
 
     strong_ptr() {}
 
-    inline auto operator=(const strong_ptr<C>& other) -> strong_ptr<C>&;
+    inline auto operator=(const strong_ptr& other) -> strong_ptr&;
 
-    inline auto operator=(strong_ptr<C>&& other) -> strong_ptr<C>&;
+    inline auto operator=(strong_ptr&& other) -> strong_ptr&;
 
     ~strong_ptr() {
         unlock();
@@ -84,7 +88,7 @@ public:
     inline auto clear() -> void ;
 
 private:
-    strong_ptr(C* memory, reference_counter* counter, allocator* alloc)
+    strong_ptr(C* memory, Counter* counter, allocator* alloc)
     :   m_ptr(memory, counter, alloc) {
     }
 
@@ -92,10 +96,10 @@ private:
     inline auto unlock() -> void;
 
     inline auto clear_without_ref_count_change() -> void;
-    static auto check_ref_count_for_deletion(managed_ptr<C>& man_ptr) -> void;
+    static auto check_ref_count_for_deletion(managed_ptr<C, Counter>& man_ptr) -> void;
 
-    managed_ptr<C> m_ptr;
-    friend class weak_ptr<C>;
+    managed_ptr<C, Counter> m_ptr;
+    friend class weak_ptr<C, Counter>;
     friend class allocator;
 };
 
@@ -113,8 +117,8 @@ inline auto make_strong(Args... args) -> strong_ptr<C> {
 /*
  * Implementations of strong_ptr member methods.
  */
-template <typename C>
-inline auto strong_ptr<C>::operator=(const strong_ptr<C>& other) -> strong_ptr<C>& {
+template <typename C, typename Counter>
+inline auto strong_ptr<C, Counter>::operator=(const strong_ptr<C, Counter>& other) -> strong_ptr<C, Counter>& {
     if(this != &other) {
         unlock();
         m_ptr.m_memory = other.m_ptr.m_memory;
@@ -125,8 +129,8 @@ inline auto strong_ptr<C>::operator=(const strong_ptr<C>& other) -> strong_ptr<C
     return *this;
 }
 
-template <typename C>
-inline auto strong_ptr<C>::operator=(strong_ptr<C>&& other) -> strong_ptr<C>& {
+template <typename C, typename Counter>
+inline auto strong_ptr<C, Counter>::operator=(strong_ptr<C, Counter>&& other) -> strong_ptr<C, Counter>& {
     unlock();
     m_ptr.m_memory = std::move(other.m_ptr.m_memory);
     m_ptr.m_ref_count = std::move(other.m_ptr.m_ref_count);
@@ -135,36 +139,40 @@ inline auto strong_ptr<C>::operator=(strong_ptr<C>&& other) -> strong_ptr<C>& {
     return *this;
 }
 
-template <typename C>
-inline auto strong_ptr<C>::clear() -> void {
+template <typename C, typename Counter>
+inline auto strong_ptr<C, Counter>::clear() -> void {
     unlock();
     clear_without_ref_count_change();
 }
 
 
-template <typename C>
-inline auto strong_ptr<C>::clear_without_ref_count_change() -> void {
+template <typename C, typename Counter>
+inline auto strong_ptr<C, Counter>::clear_without_ref_count_change() -> void {
     m_ptr.m_memory = nullptr;
     m_ptr.m_ref_count = nullptr;   
 }
 
-template <typename C>
-inline auto strong_ptr<C>::check_ref_count_for_deletion(managed_ptr<C>& man_ptr) -> void {
+/**
+ * The counter is the start of the control_block so this releases the
+ * object's storage too.
+ */
+template <typename C, typename Counter>
+inline auto strong_ptr<C, Counter>::check_ref_count_for_deletion(managed_ptr<C, Counter>& man_ptr) -> void {
     if(man_ptr.m_ref_count && man_ptr.m_allocator && man_ptr.m_ref_count->abandoned() &&  man_ptr.m_ref_count->can_release()) {
-        man_ptr.m_allocator->template del<reference_counter>(man_ptr.m_ref_count);
+        man_ptr.m_allocator->template del<Counter>(man_ptr.m_ref_count);
     }
 }
 
-template <typename C>
-inline auto strong_ptr<C>::unlock() -> void {
+template <typename C, typename Counter>
+inline auto strong_ptr<C, Counter>::unlock() -> void {
     if(m_ptr.m_ref_count && m_ptr.m_allocator && m_ptr.m_ref_count->decrement_strong()) {
-        m_ptr.m_allocator->template del<C>(m_ptr.m_memory);
+        m_ptr.m_memory->~C();
         check_ref_count_for_deletion(m_ptr);
     }
 }
 
-template <typename C>
-inline auto strong_ptr<C>::lock() -> void {
+template <typename C, typename Counter>
+inline auto strong_ptr<C, Counter>::lock() -> void {
     if(!m_ptr.m_ref_count || !m_ptr.m_ref_count->try_increment_strong()) {
         m_ptr.m_memory = nullptr;
         m_ptr.m_ref_count = nullptr;
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/memory/allocator.h>
+
+#include <mutex>
+
+namespace root {
+
+/**
+ * Caching front-end for another allocator, meant to be installed with
+ * allocator::set_default(). Each thread keeps small magazines of recently freed
+ * blocks per size class so the common malloc/free pair never takes a lock.
+ * Magazines are refilled from and flushed to a shared depot in batches, and the
+ * depot only goes to the backing allocator when it runs dry or holds too much.
+ *
+ * Every block carries a 16 byte header with its size class, so a block can be
+ * freed on any thread: it simply lands in that thread's magazine.
+ */
+class thread_cached_allocator final : public allocator {
+public:
+    constexpr static u64 HEADER_SIZE = 16;
+    constexpr static u64 MIN_CLASS_SIZE = 16;
+    constexpr static u64 MAX_CLASS_SIZE = 512;
+    constexpr static u64 NUM_CLASSES = 6;
+    constexpr static u64 MAGAZINE_SIZE = 64;
+    constexpr static u64 BATCH_SIZE = MAGAZINE_SIZE / 2;
+    constexpr static u64 DEPOT_LIMIT = 16 * MAGAZINE_SIZE;
+
+    explicit thread_cached_allocator(allocator* backing_resource = allocator::get_default());
+
+    thread_cached_allocator(const thread_cached_allocator&) = delete;
+    auto operator=(const thread_cached_allocator&) -> thread_cached_allocator& = delete;
+
+    auto malloc(const u64& bytes, const u64& alignment) -> void* override;
+    auto free(void* mem) -> void override;
+
+    ~thread_cached_allocator();
+
+private:
+    friend struct thread_cache_list;
+
+    struct free_block {
+        free_block* m_next;
+    };
+
+    struct magazine {
+        free_block* m_head{nullptr};
+        u64 m_count{0};
+    };
+
+    /**
+     * One per thread that used this allocator. Owned by the thread, linked into
+     * the allocator so both sides can flush it on whichever goes away first.
+     */
+    struct thread_cache {
+        thread_cached_allocator* m_owner;
+        u64 m_owner_id;
+        thread_cache* m_prev;
+        thread_cache* m_next;
+        magazine m_magazines[NUM_CLASSES];
+    };
+
+    struct depot {
+        std::mutex m_lock;
+        magazine m_blocks;
+    };
+
+    inline static auto class_size(const u64& class_index) -> u64 {
+        return MIN_CLASS_SIZE << class_index;
+    }
+
+    /**
+     * @return the calling thread's cache or nullptr once the thread's caches
+     * have been torn down, which static destructors at exit can run into.
+     */
+    auto local_cache() -> thread_cache*;
+    auto make_block(const u64& class_index) -> free_block*;
+    auto refill(magazine& mag, const u64& class_index, const u64& count) -> bool;
+    auto drain(magazine& mag, const u64& class_index, const u64& count) -> void;
+
+    /**
+     * Return every cached block of cache to the depot. Must hold the registry lock.
+     */
+    auto flush(thread_cache* cache) -> void;
+
+    depot m_depots[NUM_CLASSES];
+    thread_cache* m_caches;
+    u64 m_id;
+    allocator* m_backing_resource;
+};
+
+} // namespace root
\ No newline at end of file
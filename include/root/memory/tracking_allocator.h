@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <root/core/primitives.h>
+#include <root/core/string_view.h>
+#include <root/memory/allocator.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace root {
+
+/**
+ * Decorator that records what goes through another allocator: live and peak
+ * bytes, number of allocations and a power of two size histogram, overall and
+ * per tag. Anything still allocated when it is destroyed is reported through
+ * root::log as a leak.
+ *
+ * Every allocation gets a small header in front of it, so memory from a
+ * tracking_allocator must be freed through it (or one of its tags).
+ */
+class tracking_allocator final : public allocator {
+public:
+    constexpr static u64 NUM_BUCKETS = 16;
+    constexpr static u64 MAX_TAGS = 32;
+    constexpr static u32 UNTAGGED = 0;
+
+    struct stats {
+        std::atomic<u64> m_live_bytes{0};
+        std::atomic<u64> m_peak_bytes{0};
+        std::atomic<u64> m_live_allocations{0};
+        std::atomic<u64> m_total_allocations{0};
+    };
+
+    /**
+     * Allocator that attributes everything it allocates to one tag of a
+     * tracking_allocator, e.g. a subsystem or call site.
+     */
+    class tag final : public allocator {
+    public:
+        auto malloc(const u64& bytes, const u64& alignment) -> void* override;
+        auto free(void* mem) -> void override;
+
+    private:
+        tag(tracking_allocator* parent, const u32& index);
+
+        tracking_allocator* m_parent;
+        u32 m_index;
+
+        friend class tracking_allocator;
+    };
+
+    /**
+     * name and tag names are kept as views, they must outlive the allocator.
+     */
+    explicit tracking_allocator(const string_view& name, allocator* backing_resource = allocator::get_default());
+
+    tracking_allocator(const tracking_allocator&) = delete;
+    auto operator=(const tracking_allocator&) -> tracking_allocator& = delete;
+
+    auto malloc(const u64& bytes, const u64& alignment) -> void* override;
+    auto free(void* mem) -> void override;
+
+    /**
+     * @return an allocator that tags its allocations with name. Asking twice
+     * for the same name gives the same tag. Past MAX_TAGS tags everything is
+     * untagged.
+     */
+    auto tagged(const string_view& name) -> tag;
+
+    inline auto live_bytes() const -> u64 {
+        return m_stats[UNTAGGED].m_live_bytes.load(std::memory_order_relaxed);
+    }
+
+    inline auto peak_bytes() const -> u64 {
+        return m_stats[UNTAGGED].m_peak_bytes.load(std::memory_order_relaxed);
+    }
+
+    inline auto live_allocations() const -> u64 {
+        return m_stats[UNTAGGED].m_live_allocations.load(std::memory_order_relaxed);
+    }
+
+    inline auto total_allocations() const -> u64 {
+        return m_stats[UNTAGGED].m_total_allocations.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return number of allocations so far of at most 2^(bucket+4) bytes. The
+     * last bucket holds everything bigger.
+     */
+    inline auto histogram(const u64& bucket) const -> u64 {
+        return m_histogram[bucket].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return stats for the tag with the given name or nullptr if there is none.
+     */
+    auto tag_stats(const string_view& name) const -> const stats*;
+
+    /**
+     * Log current usage, per tag and the histogram.
+     */
+    auto report() const -> void;
+
+    ~tracking_allocator();
+
+private:
+    struct header {
+        header* m_prev;
+        header* m_next;
+        u64 m_size;
+        u32 m_tag;
+        u32 m_offset;
+    };
+
+    auto tracked_malloc(const u64& bytes, const u64& alignment, const u32& tag_index) -> void*;
+    auto record(stats& s, const i64& bytes, const i64& count) -> void;
+
+    string_view m_name;
+    allocator* m_backing_resource;
+
+    stats m_stats[MAX_TAGS + 1]; // Slot 0 is the overall total
+    std::atomic<u64> m_histogram[NUM_BUCKETS];
+
+    mutable std::mutex m_lock;
+    string_view m_tag_names[MAX_TAGS + 1];
+    u32 m_tag_count;
+    header* m_live;
+};
+
+} // namespace root
\ No newline at end of file
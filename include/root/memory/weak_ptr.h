@@ -23,24 +23,24 @@
 
 namespace root {
 
-template<typename C>
+template<typename C, typename Counter>
 class weak_ptr final {
 public:
     weak_ptr() {}
 
-    explicit weak_ptr(const strong_ptr<C>& ptr) 
+    explicit weak_ptr(const strong_ptr<C, Counter>& ptr) 
     :   weak_ptr(ptr.m_ptr.m_memory, ptr.m_ptr.m_ref_count, ptr.m_ptr.m_allocator) {}
 
-    weak_ptr(const weak_ptr<C>& other) 
+    weak_ptr(const weak_ptr<C, Counter>& other) 
     :   weak_ptr(other.m_ptr.m_memory, other.m_ptr.m_ref_count, other.m_ptr.m_allocator) {}
 
-    weak_ptr(weak_ptr<C>&& other) {
+    weak_ptr(weak_ptr<C, Counter>&& other) {
         m_ptr.m_memory = std::move(other.m_ptr.m_memory);
         m_ptr.m_ref_count = std::move(other.m_ptr.m_ref_count);
         m_ptr.m_allocator = std::move(other.m_ptr.m_allocator);
     }
     
-    auto operator=(const weak_ptr<C>& other) -> weak_ptr<C>& {
+    auto operator=(const weak_ptr<C, Counter>& other) -> weak_ptr<C, Counter>& {
         if(this != &other) {
             unlock();
             m_ptr.m_memory = other.m_ptr.m_memory;
@@ -51,7 +51,7 @@ public:
         return *this;
     }
 
-    auto operator=(weak_ptr<C>&& other) -> weak_ptr<C>& {
+    auto operator=(weak_ptr<C, Counter>&& other) -> weak_ptr<C, Counter>& {
         unlock();
         m_ptr.m_memory = std::move(other.m_ptr.m_memory);
         m_ptr.m_ref_count = std::move(other.m_ptr.m_ref_count);
@@ -60,7 +60,7 @@ public:
         return *this;
     }
 
-    inline auto promote() -> strong_ptr<C>;
+    inline auto promote() -> strong_ptr<C, Counter>;
 
     inline auto valid() const -> bool {
         return m_ptr.m_memory != nullptr;
@@ -80,39 +80,39 @@ private:
     auto unlock() -> void;
     auto lock() -> void;
 
-    weak_ptr(C* memory, reference_counter* ref_count, allocator* alloc) 
+    weak_ptr(C* memory, Counter* ref_count, allocator* alloc) 
     :   m_ptr(memory, ref_count, alloc) {
         lock();
     }
 
-    managed_ptr<C> m_ptr;
+    managed_ptr<C, Counter> m_ptr;
 };
 
-template <typename C>
-inline auto weak_ptr<C>::unlock() -> void {  
+template <typename C, typename Counter>
+inline auto weak_ptr<C, Counter>::unlock() -> void {  
     if(m_ptr.m_ref_count && m_ptr.m_ref_count->decrement_weak()) {
-        strong_ptr<C>::check_ref_count_for_deletion(m_ptr);
+        strong_ptr<C, Counter>::check_ref_count_for_deletion(m_ptr);
     }
 }
 
-template<typename C>
-inline auto weak_ptr<C>::lock() -> void {
+template<typename C, typename Counter>
+inline auto weak_ptr<C, Counter>::lock() -> void {
     if(!m_ptr.m_ref_count || !m_ptr.m_ref_count->try_increment_weak()) {
         m_ptr.m_memory = nullptr;
         m_ptr.m_ref_count = nullptr;
     }
 }
 
-template<typename C>
-inline auto weak_ptr<C>::clear() -> void {
+template<typename C, typename Counter>
+inline auto weak_ptr<C, Counter>::clear() -> void {
     unlock();
     m_ptr.m_memory = nullptr;
     m_ptr.m_ref_count = nullptr;
 }
 
-template<typename C>
-inline auto weak_ptr<C>::promote() -> strong_ptr<C> {
-    strong_ptr<C> ptr(m_ptr.m_memory, m_ptr.m_ref_count, m_ptr.m_allocator);
+template<typename C, typename Counter>
+inline auto weak_ptr<C, Counter>::promote() -> strong_ptr<C, Counter> {
+    strong_ptr<C, Counter> ptr(m_ptr.m_memory, m_ptr.m_ref_count, m_ptr.m_allocator);
     ptr.lock(); // Increment strong
     if(!ptr) clear();
     return ptr;
@@ -31,4 +31,23 @@ endif(${CMAKE_BUILD_TYPE} MATCHES "Debug")
 if(${CMAKE_BUILD_TYPE} MATCHES "Test")
     set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -g")
     add_definitions(-DROOT_DEBUG)
-endif(${CMAKE_BUILD_TYPE} MATCHES "Test")
\ No newline at end of file
+endif(${CMAKE_BUILD_TYPE} MATCHES "Test")
+
+if(${CMAKE_BUILD_TYPE} MATCHES "Benchmark")
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -O2 -g")
+endif(${CMAKE_BUILD_TYPE} MATCHES "Benchmark")
+
+# Log messages below ROOT_LOG_LEVEL are compiled out
+if(${CMAKE_BUILD_TYPE} MATCHES "Debug" OR ${CMAKE_BUILD_TYPE} MATCHES "Test")
+    set(ROOT_DEFAULT_LOG_LEVEL "debug")
+else(${CMAKE_BUILD_TYPE} MATCHES "Debug" OR ${CMAKE_BUILD_TYPE} MATCHES "Test")
+    set(ROOT_DEFAULT_LOG_LEVEL "info")
+endif(${CMAKE_BUILD_TYPE} MATCHES "Debug" OR ${CMAKE_BUILD_TYPE} MATCHES "Test")
+
+set(ROOT_LOG_LEVEL ${ROOT_DEFAULT_LOG_LEVEL} CACHE STRING "Least important log level compiled in: debug, info, warn or error")
+set(ROOT_LOG_LEVELS debug info warn error)
+list(FIND ROOT_LOG_LEVELS ${ROOT_LOG_LEVEL} ROOT_LOG_LEVEL_INDEX)
+if(${ROOT_LOG_LEVEL_INDEX} EQUAL -1)
+    message(FATAL_ERROR "ROOT_LOG_LEVEL must be one of ${ROOT_LOG_LEVELS}")
+endif(${ROOT_LOG_LEVEL_INDEX} EQUAL -1)
+add_definitions(-DROOT_LOG_LEVEL=${ROOT_LOG_LEVEL_INDEX})
\ No newline at end of file
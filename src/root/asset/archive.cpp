@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/asset/archive.h>
+
+#include <root/core/hash.h>
+#include <root/io/log.h>
+#include <root/io/lz4.h>
+#include <root/jobs/jobs.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace root {
+
+archive::archive(const string_view& path)
+:   m_mapping(path, access_pattern::random) {
+    if(m_mapping && !validate()) {
+        log::e("archive", "{} is not a valid archive ({} bytes)"_fmt, path, m_mapping.size());
+        m_mapping = mapped_buffer();
+    }
+}
+
+auto archive::validate() const -> bool {
+    const u64 size = m_mapping.size();
+    if(size < sizeof(archive_format::header)) return false;
+    const archive_format::header* h = header();
+    if(h->m_magic != archive_format::MAGIC || h->m_version != archive_format::VERSION) return false;
+    // A power of two so probing can mask, with room for every entry
+    if(h->m_bucket_count == 0 || (h->m_bucket_count & (h->m_bucket_count - 1)) != 0) return false;
+    if(h->m_entry_count > h->m_bucket_count) return false;
+    if(h->m_chunk_size == 0 || h->m_chunk_size >= archive_format::RAW_CHUNK) return false;
+    if(h->m_index_offset > size || h->m_bucket_count > (size - h->m_index_offset) / sizeof(archive_format::entry)) return false;
+    if(h->m_names_offset > size || h->m_names_size > size - h->m_names_offset) return false;
+    const archive_format::entry* entries = index();
+    for(u64 i = 0; i < h->m_bucket_count; i++) {
+        const archive_format::entry& e = entries[i];
+        if(e.m_name_size == 0) continue;
+        if(e.m_name_offset < h->m_names_offset || e.m_name_offset - h->m_names_offset > h->m_names_size
+           || e.m_name_size > h->m_names_size - (e.m_name_offset - h->m_names_offset)) return false;
+        if(e.m_offset > size || e.m_stored_size > size - e.m_offset) return false;
+        if(e.m_flags & archive_format::COMPRESSED) {
+            if(archive_format::chunk_count(e.m_size, h->m_chunk_size) > e.m_stored_size / sizeof(u32)) return false;
+        } else if(e.m_size != e.m_stored_size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto archive::find_entry(const string_view& id) const -> const archive_format::entry* {
+    if(!*this || id.size() == 0) return nullptr;
+    const u64 hash = fnv1a(id);
+    const u64 mask = header()->m_bucket_count - 1;
+    const archive_format::entry* entries = index();
+    for(u64 probe = 0; probe <= mask; probe++) {
+        const archive_format::entry& e = entries[(hash + probe) & mask];
+        if(e.m_name_size == 0) return nullptr;
+        if(e.m_hash == hash && name(e) == id) return &e;
+    }
+    return nullptr;
+}
+
+auto archive::find(const string_view& id) const -> buffer_slice {
+    const archive_format::entry* e = find_entry(id);
+    if(!e || (e->m_flags & archive_format::COMPRESSED)) return buffer_slice();
+    void* base = const_cast<void*>(m_mapping.data());
+    return buffer_slice(base, e->m_offset, e->m_offset + e->m_size);
+}
+
+auto archive::size(const string_view& id) const -> value_or_error<u64> {
+    const archive_format::entry* e = find_entry(id);
+    if(!e) return error::NOT_FOUND;
+    return e->m_size;
+}
+
+auto archive::read(const string_view& id, void* dst) const -> error {
+    const archive_format::entry* e = find_entry(id);
+    if(!e) return error::NOT_FOUND;
+    if(e->m_flags & archive_format::COMPRESSED) {
+        return decompress(*e, static_cast<u8*>(dst));
+    }
+    memcpy(dst, stored(*e), e->m_size);
+    return error::NO_ERROR;
+}
+
+struct compressed_chunk {
+    const u8* m_src;
+    u64 m_src_size;
+    u8* m_dst;
+    u64 m_dst_size;
+    bool m_raw;
+};
+
+auto archive::decompress(const archive_format::entry& e, u8* dst) const -> error {
+    const u64 chunk_size = header()->m_chunk_size;
+    const u64 count = archive_format::chunk_count(e.m_size, chunk_size);
+    if(count == 0) return error::NO_ERROR;
+    const u8* table = stored(e);
+    allocator* alloc = allocator::get_default();
+    compressed_chunk* chunks = static_cast<compressed_chunk*>(alloc->malloc(sizeof(compressed_chunk) * count, alignof(compressed_chunk)));
+    u64 src_offset = count * sizeof(u32);
+    for(u64 i = 0; i < count; i++) {
+        u32 stored_size;
+        memcpy(&stored_size, table + i * sizeof(u32), sizeof(u32));
+        compressed_chunk& c = chunks[i];
+        c.m_raw = stored_size & archive_format::RAW_CHUNK;
+        c.m_src_size = stored_size & ~archive_format::RAW_CHUNK;
+        c.m_src = table + src_offset;
+        c.m_dst = dst + i * chunk_size;
+        c.m_dst_size = i + 1 < count ? chunk_size : e.m_size - i * chunk_size;
+        src_offset += c.m_src_size;
+        if(src_offset > e.m_stored_size || (c.m_raw && c.m_src_size != c.m_dst_size)) {
+            alloc->free(chunks);
+            return error::INVALID_OPERATION;
+        }
+    }
+
+    std::atomic<bool> failed{false};
+    jobs::parallel_for(array_slice<compressed_chunk>(chunks, 0, count), [&failed](compressed_chunk& c) {
+        if(c.m_raw) {
+            memcpy(c.m_dst, c.m_src, c.m_dst_size);
+        } else if(!lz4::decompress(c.m_src, c.m_src_size, c.m_dst, c.m_dst_size)) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    }, 1);
+    alloc->free(chunks);
+    return failed.load(std::memory_order_relaxed) ? error::INVALID_OPERATION : error::NO_ERROR;
+}
+
+auto archive::verify() const -> bool {
+    if(!*this) return false;
+    const archive_format::entry* entries = index();
+    for(u64 i = 0; i < header()->m_bucket_count; i++) {
+        const archive_format::entry& e = entries[i];
+        if(e.m_name_size == 0) continue;
+        if(fnv1a(stored(e), e.m_stored_size) != e.m_checksum) {
+            log::w("archive", "Checksum mismatch for {} at offset {}"_fmt, name(e), e.m_offset);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace root
\ No newline at end of file
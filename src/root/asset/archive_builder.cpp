@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/asset/archive_builder.h>
+
+#include <root/core/hash.h>
+#include <root/io/lz4.h>
+
+#include <cstring>
+
+namespace root {
+
+static inline auto align_up(const u64& value, const u64& alignment) -> u64 {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static inline auto write_all(stream& out, const void* data, const u64& size) -> error {
+    if(size == 0) return error::NO_ERROR;
+    value_or_error<u64> written = out.write(data, size);
+    if(!written.has_value()) return written.error();
+    return written.value() == size ? error::NO_ERROR : error::UNKNOWN_ERROR;
+}
+
+static inline auto write_padding(stream& out, const u64& size) -> error {
+    static const u8 zeroes[archive_format::DATA_ALIGNMENT] = {};
+    return write_all(out, zeroes, size);
+}
+
+archive_builder::archive_builder(allocator* alloc, const u64& chunk_size)
+:   m_allocator(alloc),
+    m_chunk_size(chunk_size) {
+    root_assert(chunk_size > 0 && chunk_size < archive_format::RAW_CHUNK);
+}
+
+auto archive_builder::compress_chunks(const buffer& data) const -> buffer {
+    const u64 count = archive_format::chunk_count(data.size(), m_chunk_size);
+    const u64 table_size = count * sizeof(u32);
+    if(table_size >= data.size()) return buffer();
+    // Chunks that don't shrink are stored raw, so this is the worst case
+    buffer compressed(data.size() + table_size, alignof(u8), m_allocator);
+    const u64 scratch_size = lz4::compress_bound(m_chunk_size);
+    u8* scratch = static_cast<u8*>(m_allocator->malloc(scratch_size, alignof(u8)));
+    u8* out = static_cast<u8*>(compressed.data());
+    const u8* in = static_cast<const u8*>(data.data());
+    u64 position = table_size;
+    for(u64 i = 0; i < count; i++) {
+        const u8* chunk = in + i * m_chunk_size;
+        const u64 size = i + 1 < count ? m_chunk_size : data.size() - i * m_chunk_size;
+        const u64 written = lz4::compress(chunk, size, scratch, scratch_size);
+        u32 stored_size;
+        if(written && written < size) {
+            memcpy(out + position, scratch, written);
+            stored_size = static_cast<u32>(written);
+        } else {
+            memcpy(out + position, chunk, size);
+            stored_size = static_cast<u32>(size) | archive_format::RAW_CHUNK;
+        }
+        memcpy(out + i * sizeof(u32), &stored_size, sizeof(u32));
+        position += stored_size & ~archive_format::RAW_CHUNK;
+    }
+    m_allocator->free(scratch);
+    if(position >= data.size()) return buffer();
+    buffer trimmed(position, alignof(u8), m_allocator);
+    memcpy(trimmed.data(), compressed.data(), position);
+    return trimmed;
+}
+
+auto archive_builder::add(const string_view& id, buffer&& data, const bool& compress) -> bool {
+    if(id.size() == 0) return false;
+    const u64 hash = fnv1a(id);
+    for(pending_asset* a = m_first; a; a = a->m_next) {
+        if(a->m_hash == hash && string_view(a->m_id) == id) return false;
+    }
+    string owned_id(id.size(), m_allocator);
+    memcpy(owned_id.data(), id.data(), id.size());
+    const u64 size = data.size();
+    pending_asset* a;
+    buffer compressed = compress && size ? compress_chunks(data) : buffer();
+    if(compressed) {
+        a = m_allocator->make<pending_asset>(std::move(owned_id), hash, std::move(compressed), size, archive_format::COMPRESSED);
+    } else {
+        a = m_allocator->make<pending_asset>(std::move(owned_id), hash, std::move(data), size, 0u);
+    }
+    m_stored_size += a->m_data.size();
+    if(m_last) {
+        m_last->m_next = a;
+    } else {
+        m_first = a;
+    }
+    m_last = a;
+    m_count++;
+    return true;
+}
+
+auto archive_builder::write(stream& out) const -> error {
+    // At most half full keeps probe sequences short
+    u64 bucket_count = 1;
+    while(bucket_count < m_count * 2) {
+        bucket_count <<= 1;
+    }
+
+    archive_format::header h{};
+    h.m_magic = archive_format::MAGIC;
+    h.m_version = archive_format::VERSION;
+    h.m_entry_count = m_count;
+    h.m_bucket_count = bucket_count;
+    h.m_index_offset = sizeof(archive_format::header);
+    h.m_names_offset = h.m_index_offset + bucket_count * sizeof(archive_format::entry);
+    h.m_names_size = 0;
+    h.m_chunk_size = m_chunk_size;
+    for(pending_asset* a = m_first; a; a = a->m_next) {
+        h.m_names_size += a->m_id.size();
+    }
+
+    const u64 index_size = bucket_count * sizeof(archive_format::entry);
+    archive_format::entry* index = static_cast<archive_format::entry*>(m_allocator->malloc(index_size, alignof(archive_format::entry)));
+    memset(index, 0, index_size);
+    u64 name_offset = h.m_names_offset;
+    u64 data_offset = align_up(h.m_names_offset + h.m_names_size, archive_format::DATA_ALIGNMENT);
+    for(pending_asset* a = m_first; a; a = a->m_next) {
+        u64 bucket = a->m_hash & (bucket_count - 1);
+        while(index[bucket].m_name_size != 0) {
+            bucket = (bucket + 1) & (bucket_count - 1);
+        }
+        archive_format::entry& e = index[bucket];
+        e.m_hash = a->m_hash;
+        e.m_offset = data_offset;
+        e.m_size = a->m_size;
+        e.m_stored_size = a->m_data.size();
+        e.m_checksum = fnv1a(a->m_data.data(), a->m_data.size());
+        e.m_name_offset = name_offset;
+        e.m_name_size = static_cast<u32>(a->m_id.size());
+        e.m_flags = a->m_flags;
+        name_offset += a->m_id.size();
+        data_offset = align_up(data_offset + e.m_stored_size, archive_format::DATA_ALIGNMENT);
+    }
+
+    error result = write_all(out, &h, sizeof(h));
+    if(result == error::NO_ERROR) result = write_all(out, index, index_size);
+    m_allocator->free(index);
+    for(pending_asset* a = m_first; a && result == error::NO_ERROR; a = a->m_next) {
+        result = write_all(out, a->m_id.data(), a->m_id.size());
+    }
+    u64 position = h.m_names_offset + h.m_names_size;
+    for(pending_asset* a = m_first; a && result == error::NO_ERROR; a = a->m_next) {
+        result = write_padding(out, align_up(position, archive_format::DATA_ALIGNMENT) - position);
+        position = align_up(position, archive_format::DATA_ALIGNMENT);
+        if(result == error::NO_ERROR) result = write_all(out, a->m_data.data(), a->m_data.size());
+        position += a->m_data.size();
+    }
+    return result;
+}
+
+archive_builder::~archive_builder() {
+    pending_asset* a = m_first;
+    while(a) {
+        pending_asset* next = a->m_next;
+        m_allocator->del(a);
+        a = next;
+    }
+}
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/asset/asset_cache.h>
+
+#include <root/core/hash.h>
+
+#include <cstring>
+
+namespace root {
+
+cached_asset::cached_asset(string&& id, const u64& hash, buffer&& data)
+:   m_id(std::move(id)),
+    m_hash(hash),
+    m_data(std::move(data)) {}
+
+asset_cache::asset_cache(const u64& budget, allocator* alloc)
+:   m_allocator(alloc),
+    m_buckets(static_cast<cached_asset**>(alloc->malloc(sizeof(cached_asset*) * INITIAL_BUCKETS, alignof(cached_asset*)))),
+    m_bucket_count(INITIAL_BUCKETS),
+    m_budget(budget) {
+    memset(m_buckets, 0, sizeof(cached_asset*) * m_bucket_count);
+}
+
+auto asset_cache::lookup(const string_view& id, const u64& hash) const -> cached_asset* {
+    for(cached_asset* asset = m_buckets[hash & (m_bucket_count - 1)]; asset; asset = asset->m_next_in_bucket) {
+        if(asset->m_hash == hash && asset->id() == id) return asset;
+    }
+    return nullptr;
+}
+
+auto asset_cache::unlink(cached_asset* asset) -> void {
+    if(asset->m_newer) {
+        asset->m_newer->m_older = asset->m_older;
+    } else {
+        m_newest = asset->m_older;
+    }
+    if(asset->m_older) {
+        asset->m_older->m_newer = asset->m_newer;
+    } else {
+        m_oldest = asset->m_newer;
+    }
+    asset->m_newer = nullptr;
+    asset->m_older = nullptr;
+}
+
+auto asset_cache::push_newest(cached_asset* asset) -> void {
+    asset->m_older = m_newest;
+    asset->m_newer = nullptr;
+    if(m_newest) {
+        m_newest->m_newer = asset;
+    } else {
+        m_oldest = asset;
+    }
+    m_newest = asset;
+}
+
+auto asset_cache::grow() -> void {
+    const u64 count = m_bucket_count * 2;
+    cached_asset** buckets = static_cast<cached_asset**>(m_allocator->malloc(sizeof(cached_asset*) * count, alignof(cached_asset*)));
+    memset(buckets, 0, sizeof(cached_asset*) * count);
+    for(u64 i = 0; i < m_bucket_count; i++) {
+        cached_asset* asset = m_buckets[i];
+        while(asset) {
+            cached_asset* next = asset->m_next_in_bucket;
+            cached_asset*& bucket = buckets[asset->m_hash & (count - 1)];
+            asset->m_next_in_bucket = bucket;
+            bucket = asset;
+            asset = next;
+        }
+    }
+    m_allocator->free(m_buckets);
+    m_buckets = buckets;
+    m_bucket_count = count;
+}
+
+auto asset_cache::evict_until(const u64& bytes) -> void {
+    cached_asset* asset = m_oldest;
+    while(asset && m_bytes > bytes) {
+        cached_asset* newer = asset->m_newer;
+        // The cache's own reference is the only one left
+        if(asset->ref_count() == 1) {
+            cached_asset** link = &m_buckets[asset->m_hash & (m_bucket_count - 1)];
+            while(*link != asset) {
+                link = &(*link)->m_next_in_bucket;
+            }
+            *link = asset->m_next_in_bucket;
+            unlink(asset);
+            m_bytes -= asset->size();
+            m_count--;
+            m_evictions++;
+            // Frees the asset
+            asset_ref cache_reference = std::move(asset->m_cache_reference);
+        }
+        asset = newer;
+    }
+}
+
+auto asset_cache::find(const string_view& id) -> asset_ref {
+    const u64 hash = fnv1a(id);
+    std::lock_guard<std::mutex> guard(m_lock);
+    cached_asset* asset = lookup(id, hash);
+    if(!asset) {
+        m_misses++;
+        return asset_ref();
+    }
+    m_hits++;
+    unlink(asset);
+    push_newest(asset);
+    return asset_ref(asset);
+}
+
+auto asset_cache::insert(const string_view& id, buffer&& data) -> asset_ref {
+    const u64 hash = fnv1a(id);
+    std::lock_guard<std::mutex> guard(m_lock);
+    if(cached_asset* existing = lookup(id, hash)) {
+        return asset_ref(existing);
+    }
+    string owned_id(id.size(), m_allocator);
+    memcpy(owned_id.data(), id.data(), id.size());
+    asset_ref asset = m_allocator->make_intrusive<cached_asset>(std::move(owned_id), hash, std::move(data));
+    // Make room before the new asset counts, so it is never the one evicted
+    if(asset->size() < m_budget) {
+        evict_until(m_budget - asset->size());
+    } else {
+        evict_until(0);
+    }
+    if(m_count >= m_bucket_count) grow();
+    cached_asset*& bucket = m_buckets[hash & (m_bucket_count - 1)];
+    asset->m_next_in_bucket = bucket;
+    bucket = asset.get();
+    push_newest(asset.get());
+    asset->m_cache_reference = asset;
+    m_bytes += asset->size();
+    m_count++;
+    return asset;
+}
+
+auto asset_cache::trim() -> void {
+    std::lock_guard<std::mutex> guard(m_lock);
+    evict_until(m_budget);
+}
+
+auto asset_cache::clear() -> void {
+    std::lock_guard<std::mutex> guard(m_lock);
+    evict_until(0);
+}
+
+auto asset_cache::set_budget(const u64& budget) -> void {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_budget = budget;
+    evict_until(m_budget);
+}
+
+auto asset_cache::bytes() const -> u64 {
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_bytes;
+}
+
+auto asset_cache::count() const -> u64 {
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_count;
+}
+
+auto asset_cache::hits() const -> u64 {
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_hits;
+}
+
+auto asset_cache::misses() const -> u64 {
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_misses;
+}
+
+auto asset_cache::evictions() const -> u64 {
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_evictions;
+}
+
+asset_cache::~asset_cache() {
+    // Assets still held outlive the cache, they just leave it
+    cached_asset* asset = m_oldest;
+    while(asset) {
+        cached_asset* newer = asset->m_newer;
+        asset->m_next_in_bucket = nullptr;
+        asset->m_newer = nullptr;
+        asset->m_older = nullptr;
+        asset_ref cache_reference = std::move(asset->m_cache_reference);
+        asset = newer;
+    }
+    m_allocator->free(m_buckets);
+}
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/asset/asset_load.h>
+
+#include <root/jobs/jobs.h>
+
+#include <thread>
+
+namespace root {
+
+asset_load::asset_load(string&& path, buffer&& destination, allocator* alloc)
+:   m_path(std::move(path)),
+    m_buffer(std::move(destination)),
+    m_buffer_allocator(alloc) {}
+
+auto asset_load::data() -> buffer& {
+    root_assert(status() == state::ready);
+    return m_buffer;
+}
+
+auto asset_load::then(jobs::job* j) -> void {
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if(!done()) {
+            continuation* c = m_buffer_allocator->make<continuation>();
+            c->m_job = j;
+            c->m_next = m_continuations;
+            m_continuations = c;
+            return;
+        }
+    }
+    jobs::run(j);
+}
+
+auto asset_load::wait() -> void {
+    while(!done()) {
+        // Reads done by jobs might be queued behind the caller
+        if(m_jobs) {
+            jobs::wait(m_jobs);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+auto asset_load::complete(const state& result) -> void {
+    continuation* c;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_state.store(result, std::memory_order_release);
+        c = m_continuations;
+        m_continuations = nullptr;
+    }
+    while(c) {
+        continuation* next = c->m_next;
+        jobs::run(c->m_job);
+        m_buffer_allocator->del(c);
+        c = next;
+    }
+}
+
+} // namespace root
\ No newline at end of file
@@ -19,13 +19,54 @@
 
 #include <root/asset/asset_manager.h>
 
-#include <root/io/file_stream.h>
+#include <root/io/posix_file_stream.h>
 #include <root/io/log.h>
 
 namespace root {
 
 asset_manager* asset_manager::m_manager = nullptr;
 
+auto asset_manager::init(const string_view& asset_root, allocator* alloc, const u64& cache_budget) -> void {
+    root_assert(!m_manager);
+    m_manager = new asset_manager(asset_root, alloc, cache_budget);
+}
+
+auto asset_manager::deinit() -> void {
+    delete m_manager;
+    m_manager = nullptr;
+}
+
+auto asset_manager::mount(const string_view& archive_id) -> bool {
+    if(!m_manager) {
+        m_manager = new asset_manager();
+    }
+
+    string full_path = path::join(m_manager->m_asset_root, archive_id, m_manager->m_alloc);
+    string_view fp_view = full_path;
+    m_manager->m_archive = archive(fp_view);
+    log::d("asset_manager", "Mounted {} with {} assets"_fmt, fp_view, m_manager->m_archive.count());
+    return m_manager->m_archive;
+}
+
+auto asset_manager::load(const string_view& id) -> asset_ref {
+    if(!m_manager) {
+        m_manager = new asset_manager();
+    }
+
+    if(asset_ref cached = m_manager->m_cache.find(id)) {
+        return cached;
+    }
+    return m_manager->m_cache.insert(id, m_manager->load_buffer(id));
+}
+
+auto asset_manager::cache() -> asset_cache& {
+    if(!m_manager) {
+        m_manager = new asset_manager();
+    }
+
+    return m_manager->m_cache;
+}
+
 auto asset_manager::raw_load(const string_view& id) -> buffer {
     if(!m_manager) {
         m_manager = new asset_manager();
@@ -34,24 +75,67 @@ auto asset_manager::raw_load(const string_view& id) -> buffer {
     return m_manager->load_buffer(id);
 }
 
+auto asset_manager::load_async(const string_view& id) -> asset_handle {
+    return load_async(id, buffer());
+}
+
+auto asset_manager::load_async(const string_view& id, buffer&& destination) -> asset_handle {
+    if(!m_manager) {
+        m_manager = new asset_manager();
+    }
+
+    return m_manager->m_streamer.load(path::join(m_manager->m_asset_root, id, m_manager->m_alloc), std::move(destination));
+}
+
+auto asset_manager::raw_map(const string_view& id, const access_pattern& pattern) -> mapped_buffer {
+    if(!m_manager) {
+        m_manager = new asset_manager();
+    }
+
+    return m_manager->map_buffer(id, pattern);
+}
+
 auto asset_manager::load_buffer(const string_view& id) -> buffer {
+    value_or_error<u64> packed_size = m_archive.size(id);
+    if(packed_size.has_value()) {
+        if(packed_size.value() == 0) return buffer();
+        // Decompresses straight into the buffer handed out
+        buffer buff(packed_size.value(), alignof(u8), m_alloc);
+        const error result = m_archive.read(id, buff.data());
+        if(result != error::NO_ERROR) {
+            root_log_e("asset_manager", "Could not read {} from the archive, error {}"_fmt, id, static_cast<u64>(result));
+            return buffer();
+        }
+        return buff;
+    }
     string full_path = path::join(m_asset_root, id, m_alloc);
-    FILE* file = fopen(full_path.data(), "r");
     string_view fp_view = full_path;
-    log::d("asset_manager", "Opening {} {}", fp_view , file);
-    root_assert(file);
-    file_stream stream(file);
-    stream.seek(0, relative_to::end);
-    u64 size = stream.tell();
-    stream.seek(0, relative_to::start);
-    log::d("asset_manager", "File is {} bytes", size);
+    posix_file_stream stream(fp_view, file_mode::read, posix_file_stream::DEFAULT_BUFFER_SIZE, m_alloc);
+    if(!stream) {
+        root_log_e("asset_manager", "Could not open {}"_fmt, fp_view);
+        return buffer();
+    }
+    const u64 size = stream.size();
+    log::d("asset_manager", "Opening {}, {} bytes"_fmt, fp_view, size);
     buffer buff(size, alignof(u8), m_alloc);
-    stream.read(buff, size);
+    const value_or_error<u64> read = stream.read(buff, size);
+    if(!read.has_value() || read.value() != size) {
+        root_log_e("asset_manager", "Could not read {}, got {} of {} bytes"_fmt, fp_view, read.value_or(0), size);
+        return buffer();
+    }
     return buff;
 }
 
-asset_manager::asset_manager(const string_view& asset_root, allocator* alloc) 
-:   m_asset_root(asset_root.size(), alloc), m_alloc(alloc) {
+auto asset_manager::map_buffer(const string_view& id, const access_pattern& pattern) -> mapped_buffer {
+    string full_path = path::join(m_asset_root, id, m_alloc);
+    string_view fp_view = full_path;
+    mapped_buffer mapped(fp_view, pattern);
+    log::d("asset_manager", "Mapped {} bytes of {}"_fmt, mapped.size(), fp_view);
+    return mapped;
+}
+
+asset_manager::asset_manager(const string_view& asset_root, allocator* alloc, const u64& cache_budget) 
+:   m_asset_root(asset_root.size(), alloc), m_alloc(alloc), m_streamer(alloc), m_cache(cache_budget, alloc) {
     memcpy(m_asset_root.data(), asset_root.data(), asset_root.size());
 }
 
@@ -0,0 +1,415 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/asset/private/asset_streamer.h>
+
+#include <root/io/file_stream.h>
+#include <root/io/log.h>
+#include <root/jobs/jobs.h>
+
+#if defined(ROOT_LINUX)
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace root {
+
+#if defined(ROOT_LINUX)
+// Reads are split so their length fits in an SQE
+constexpr u64 MAX_READ_SIZE = 1ull << 30;
+
+/**
+ * The rings shared with the kernel, set up by hand since liburing isn't a
+ * dependency. Only the I/O thread touches it after creation.
+ */
+struct io_ring {
+    int m_fd{-1};
+    void* m_sq_ring{nullptr};
+    u64 m_sq_ring_size{0};
+    void* m_cq_ring{nullptr};
+    u64 m_cq_ring_size{0};
+    io_uring_sqe* m_sqes{nullptr};
+    u64 m_sqes_size{0};
+
+    u32* m_sq_tail;
+    u32 m_sq_mask;
+    u32* m_sq_array;
+    u32* m_cq_head;
+    u32* m_cq_tail;
+    u32 m_cq_mask;
+    io_uring_cqe* m_cqes;
+
+    // Pushed since the last io_uring_enter()
+    u32 m_to_submit{0};
+};
+
+/**
+ * Hand the rings back to the kernel, which cancels whatever is still in
+ * flight once the last mapping and the fd are gone.
+ */
+static inline auto ring_release(io_ring* ring) -> void {
+    if(ring->m_sqes) munmap(ring->m_sqes, ring->m_sqes_size);
+    if(ring->m_cq_ring && ring->m_cq_ring != ring->m_sq_ring) munmap(ring->m_cq_ring, ring->m_cq_ring_size);
+    if(ring->m_sq_ring) munmap(ring->m_sq_ring, ring->m_sq_ring_size);
+    if(ring->m_fd >= 0) close(ring->m_fd);
+    ring->m_sqes = nullptr;
+    ring->m_cq_ring = nullptr;
+    ring->m_sq_ring = nullptr;
+    ring->m_fd = -1;
+}
+
+static inline auto ring_destroy(io_ring* ring, allocator* alloc) -> void {
+    ring_release(ring);
+    alloc->del(ring);
+}
+
+static inline auto ring_create(const u32& entries, allocator* alloc) -> io_ring* {
+    io_uring_params params{};
+    const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if(fd < 0) return nullptr;
+    io_ring* ring = alloc->make<io_ring>();
+    ring->m_fd = fd;
+
+    ring->m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring->m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if(single_mmap) {
+        if(ring->m_cq_ring_size > ring->m_sq_ring_size) ring->m_sq_ring_size = ring->m_cq_ring_size;
+        ring->m_cq_ring_size = ring->m_sq_ring_size;
+    }
+    void* sq_ring = mmap(nullptr, ring->m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if(sq_ring == MAP_FAILED) {
+        ring_destroy(ring, alloc);
+        return nullptr;
+    }
+    ring->m_sq_ring = sq_ring;
+    void* cq_ring = single_mmap ? sq_ring : mmap(nullptr, ring->m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if(cq_ring == MAP_FAILED) {
+        ring_destroy(ring, alloc);
+        return nullptr;
+    }
+    ring->m_cq_ring = cq_ring;
+    ring->m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, ring->m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if(sqes == MAP_FAILED) {
+        ring_destroy(ring, alloc);
+        return nullptr;
+    }
+    ring->m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+    u8* sq = static_cast<u8*>(sq_ring);
+    ring->m_sq_tail = reinterpret_cast<u32*>(sq + params.sq_off.tail);
+    ring->m_sq_mask = *reinterpret_cast<u32*>(sq + params.sq_off.ring_mask);
+    ring->m_sq_array = reinterpret_cast<u32*>(sq + params.sq_off.array);
+    u8* cq = static_cast<u8*>(cq_ring);
+    ring->m_cq_head = reinterpret_cast<u32*>(cq + params.cq_off.head);
+    ring->m_cq_tail = reinterpret_cast<u32*>(cq + params.cq_off.tail);
+    ring->m_cq_mask = *reinterpret_cast<u32*>(cq + params.cq_off.ring_mask);
+    ring->m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return ring;
+}
+
+/**
+ * Queue a read of the rest of the load's file. The caller keeps the number in
+ * flight within the queue depth so there is always a free SQE.
+ */
+static inline auto ring_push_read(io_ring* ring, asset_load* load, int fd, u8* dst, const u64& offset, const u64& remaining) -> void {
+    const u32 tail = *ring->m_sq_tail;
+    const u32 index = tail & ring->m_sq_mask;
+    io_uring_sqe* sqe = &ring->m_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->off = offset;
+    sqe->addr = reinterpret_cast<u64>(dst + offset);
+    sqe->len = static_cast<u32>(remaining < MAX_READ_SIZE ? remaining : MAX_READ_SIZE);
+    sqe->user_data = reinterpret_cast<u64>(load);
+    ring->m_sq_array[index] = index;
+    __atomic_store_n(ring->m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->m_to_submit++;
+}
+
+/**
+ * Submit everything pushed so far and wait for at least min_complete
+ * completions.
+ */
+static inline auto ring_enter(io_ring* ring, const u32& min_complete) -> bool {
+    while(true) {
+        const long submitted = syscall(__NR_io_uring_enter, ring->m_fd, ring->m_to_submit, min_complete, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if(submitted >= 0) {
+            ring->m_to_submit -= static_cast<u32>(submitted);
+            return true;
+        }
+        if(errno != EINTR) return false;
+    }
+}
+
+template<typename F>
+static inline auto ring_reap(io_ring* ring, F&& on_completion) -> void {
+    u32 head = *ring->m_cq_head;
+    const u32 tail = __atomic_load_n(ring->m_cq_tail, __ATOMIC_ACQUIRE);
+    while(head != tail) {
+        const io_uring_cqe& cqe = ring->m_cqes[head & ring->m_cq_mask];
+        on_completion(reinterpret_cast<asset_load*>(cqe.user_data), cqe.res);
+        head++;
+    }
+    __atomic_store_n(ring->m_cq_head, head, __ATOMIC_RELEASE);
+}
+#else
+struct io_ring {};
+
+static inline auto ring_create(const u32&, allocator*) -> io_ring* {
+    return nullptr;
+}
+
+static inline auto ring_release(io_ring*) -> void {}
+
+static inline auto ring_destroy(io_ring*, allocator*) -> void {}
+#endif
+
+/**
+ * Reads one load on a worker when io_uring isn't available.
+ */
+struct read_job final : public jobs::job {
+    read_job(asset_streamer* streamer, asset_load* load)
+    :   job(&read_job::invoke), m_streamer(streamer), m_load(load) {}
+
+    inline static auto invoke(jobs::job* j) -> void {
+        read_job* self = static_cast<read_job*>(j);
+        asset_streamer* streamer = self->m_streamer;
+        asset_load* load = self->m_load;
+        // Nothing touches the job after this returns, only its counter
+        streamer->m_allocator->del(self);
+        streamer->finish(load, streamer->read_blocking(load));
+    }
+
+    asset_streamer* m_streamer;
+    asset_load* m_load;
+};
+
+asset_streamer::asset_streamer(allocator* alloc, const bool& use_io_uring)
+:   m_allocator(alloc) {
+    if(use_io_uring) {
+        m_ring = ring_create(QUEUE_DEPTH, alloc);
+    }
+    if(m_ring) {
+        m_io_thread = std::thread(&asset_streamer::io_loop, this);
+    } else {
+        log::d("asset_streamer", "io_uring unavailable, reading assets with jobs"_fmt);
+    }
+}
+
+auto asset_streamer::load(string&& path, buffer&& destination) -> asset_handle {
+    asset_load* load;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        const string_view path_view = path;
+        for(asset_load* l = m_loading; l; l = l->m_next_loading) {
+            if(l->path() == path_view) return asset_handle(l);
+        }
+        asset_handle handle = m_allocator->make_intrusive<asset_load>(std::move(path), std::move(destination), m_allocator);
+        load = handle.get();
+        load->m_self = handle;
+        load->m_next_loading = m_loading;
+        m_loading = load;
+        if(m_ring && !m_ring_failed.load(std::memory_order_relaxed)) {
+            if(m_queued_tail) {
+                m_queued_tail->m_next_queued = load;
+            } else {
+                m_queued_head = load;
+            }
+            m_queued_tail = load;
+            m_wake.notify_one();
+            return handle;
+        }
+        load->m_jobs = &m_jobs;
+    }
+    // Outside the lock as the job may run inline
+    asset_handle handle(load);
+    jobs::run(m_allocator->make<read_job>(this, load), &m_jobs);
+    return handle;
+}
+
+auto asset_streamer::finish(asset_load* load, const asset_load::state& result) -> void {
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        asset_load** link = &m_loading;
+        while(*link != load) {
+            link = &(*link)->m_next_loading;
+        }
+        *link = load->m_next_loading;
+    }
+    // May be the last reference
+    asset_handle self = std::move(load->m_self);
+    load->complete(result);
+}
+
+auto asset_streamer::read_blocking(asset_load* load) -> asset_load::state {
+    FILE* file = fopen(load->m_path.data(), "rb");
+    if(!file) return asset_load::state::failed;
+    file_stream stream(file);
+    stream.seek(0, relative_to::end);
+    value_or_error<i64> size = stream.tell();
+    stream.seek(0, relative_to::start);
+    asset_load::state result = asset_load::state::failed;
+    if(size.has_value() && size.value() > 0) {
+        load->m_size = size.value();
+        if(load->m_buffer.size() < load->m_size) {
+            load->m_buffer = buffer(load->m_size, alignof(u8), load->m_buffer_allocator);
+        }
+        value_or_error<u64> read = stream.read(load->m_buffer, load->m_size);
+        if(read.has_value() && read.value() == load->m_size) {
+            result = asset_load::state::ready;
+        }
+    }
+    fclose(file);
+    return result;
+}
+
+auto asset_streamer::open(asset_load* load) -> bool {
+#if defined(ROOT_LINUX)
+    const int fd = ::open(load->m_path.data(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0) return false;
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    load->m_fd = fd;
+    load->m_size = info.st_size;
+    load->m_offset = 0;
+    if(load->m_buffer.size() < load->m_size) {
+        load->m_buffer = buffer(load->m_size, alignof(u8), load->m_buffer_allocator);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+auto asset_streamer::io_loop() -> void {
+#if defined(ROOT_LINUX)
+    u32 in_flight = 0;
+    auto on_completion = [this, &in_flight](asset_load* load, const i32& result) {
+        if(result > 0) {
+            load->m_offset += result;
+            if(load->m_offset < load->m_size) {
+                // Short read, go again for the rest
+                ring_push_read(m_ring, load, load->m_fd, static_cast<u8*>(load->m_buffer.data()), load->m_offset, load->m_size - load->m_offset);
+                return;
+            }
+        }
+        close(load->m_fd);
+        load->m_fd = -1;
+        in_flight--;
+        finish(load, load->m_offset == load->m_size ? asset_load::state::ready : asset_load::state::failed);
+    };
+
+    while(true) {
+        asset_load* batch = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            while(!m_queued_head && in_flight == 0 && m_running) {
+                m_wake.wait(lock);
+            }
+            if(!m_queued_head && in_flight == 0) break;
+            // Take as many as there are free SQEs for
+            asset_load** link = &batch;
+            for(u32 free = QUEUE_DEPTH - in_flight; free && m_queued_head; free--) {
+                *link = m_queued_head;
+                link = &m_queued_head->m_next_queued;
+                m_queued_head = m_queued_head->m_next_queued;
+            }
+            *link = nullptr;
+            if(!m_queued_head) m_queued_tail = nullptr;
+        }
+        while(batch) {
+            asset_load* load = batch;
+            batch = batch->m_next_queued;
+            load->m_next_queued = nullptr;
+            if(!open(load)) {
+                finish(load, asset_load::state::failed);
+                continue;
+            }
+            ring_push_read(m_ring, load, load->m_fd, static_cast<u8*>(load->m_buffer.data()), 0, load->m_size);
+            in_flight++;
+        }
+        if(in_flight == 0) continue;
+        if(!ring_enter(m_ring, 1)) {
+            log::e("asset_streamer", "io_uring_enter failed with {}, reading assets with jobs"_fmt, errno);
+            fail_ring();
+            break;
+        }
+        ring_reap(m_ring, on_completion);
+    }
+#endif
+}
+
+/**
+ * Fails every load the I/O thread owns, those queued and those in flight, and
+ * sends later ones to jobs.
+ */
+auto asset_streamer::fail_ring() -> void {
+    ring_release(m_ring);
+    asset_load* failed = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_ring_failed.store(true, std::memory_order_relaxed);
+        // Every load still pending was handed to the ring
+        for(asset_load* l = m_loading; l; l = l->m_next_loading) {
+            l->m_next_queued = failed;
+            failed = l;
+        }
+        m_queued_head = nullptr;
+        m_queued_tail = nullptr;
+    }
+    while(failed) {
+        asset_load* load = failed;
+        failed = failed->m_next_queued;
+        load->m_next_queued = nullptr;
+#if defined(ROOT_LINUX)
+        if(load->m_fd >= 0) {
+            close(load->m_fd);
+            load->m_fd = -1;
+        }
+#endif
+        finish(load, asset_load::state::failed);
+    }
+}
+
+asset_streamer::~asset_streamer() {
+    if(m_ring) {
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_running = false;
+        }
+        m_wake.notify_one();
+        m_io_thread.join();
+        ring_destroy(m_ring, m_allocator);
+    }
+    // Loads go to jobs without a ring or once it has failed
+    jobs::wait(&m_jobs);
+}
+
+} // namespace root
\ No newline at end of file
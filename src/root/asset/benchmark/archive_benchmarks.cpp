@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <root/asset/archive.h>
+#include <root/asset/archive_builder.h>
+#include <root/core/test/benchmark.h>
+#include <root/io/file_stream.h>
+#include <root/io/lz4.h>
+#include <root/jobs/jobs.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace root::literals;
+
+constexpr root::u64 ASSET_SIZE = 8 * 1024 * 1024;
+constexpr root::u64 ITERATIONS = 20;
+constexpr const char* RAW_PATH = "/tmp/root_archive_benchmark_raw";
+constexpr const char* COMPRESSED_PATH = "/tmp/root_archive_benchmark_lz4";
+
+/**
+ * Looks roughly like SPIR-V: a stream of words made of small opcodes and
+ * result ids that keep recurring.
+ */
+static inline auto make_asset() -> root::buffer {
+    root::buffer data(ASSET_SIZE, alignof(root::u32));
+    root::u32* words = static_cast<root::u32*>(data.data());
+    for(root::u64 i = 0; i < ASSET_SIZE / sizeof(root::u32); i++) {
+        const root::u32 opcode = 1 + rand() % 64;
+        words[i] = (i % 4 == 0) ? (4u << 16) | opcode : static_cast<root::u32>(rand() % 256);
+    }
+    return data;
+}
+
+static inline auto write_archive(const char* path, const bool& compress) -> root::u64 {
+    root::archive_builder builder;
+    builder.add("asset", make_asset(), compress);
+    FILE* file = fopen(path, "wb");
+    root::file_stream stream(file);
+    builder.write(stream);
+    fclose(file);
+    return builder.stored_size();
+}
+
+/**
+ * Evict the file from the page cache so the next read goes to disk.
+ */
+static inline auto drop_page_cache(const char* path) -> void {
+    const int fd = open(path, O_RDONLY);
+    if(fd < 0) return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+static inline auto read_asset(const char* path, const bool& cold, void* dst) -> void {
+    if(cold) drop_page_cache(path);
+    root::archive packed(root::string_view(path, 0, strlen(path)));
+    packed.read("asset", dst);
+}
+
+class archive_benchmarks : public ::testing::Test {
+public:
+    static void SetUpTestSuite() {
+        srand(0);
+        const root::u64 raw = write_archive(RAW_PATH, false);
+        srand(0);
+        const root::u64 compressed = write_archive(COMPRESSED_PATH, true);
+        root::log::i("benchmark", "archive asset {} bytes raw, {} bytes compressed"_fmt, raw, compressed);
+    }
+
+    static void TearDownTestSuite() {
+        unlink(RAW_PATH);
+        unlink(COMPRESSED_PATH);
+    }
+
+    void SetUp() override {
+        root::jobs::init();
+    }
+
+    void TearDown() override {
+        root::jobs::deinit();
+    }
+
+    root::buffer destination{ASSET_SIZE};
+};
+
+TEST_F(archive_benchmarks, warm_raw) {
+    root::benchmark("archive read 8MiB raw, page cache", ITERATIONS, [this](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            read_asset(RAW_PATH, false, destination.data());
+        }
+    });
+}
+
+TEST_F(archive_benchmarks, warm_compressed) {
+    root::benchmark("archive read 8MiB lz4, page cache", ITERATIONS, [this](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            read_asset(COMPRESSED_PATH, false, destination.data());
+        }
+    });
+}
+
+TEST_F(archive_benchmarks, cold_raw) {
+    root::benchmark("archive read 8MiB raw, cold", ITERATIONS, [this](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            read_asset(RAW_PATH, true, destination.data());
+        }
+    });
+}
+
+TEST_F(archive_benchmarks, cold_compressed) {
+    root::benchmark("archive read 8MiB lz4, cold", ITERATIONS, [this](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            read_asset(COMPRESSED_PATH, true, destination.data());
+        }
+    });
+}
+
+TEST(lz4_benchmarks, decompress_single_thread) {
+    srand(0);
+    root::buffer asset = make_asset();
+    root::buffer compressed(root::lz4::compress_bound(ASSET_SIZE));
+    const root::u64 size = root::lz4::compress(asset.data(), ASSET_SIZE, compressed.data(), compressed.size());
+    root::benchmark("lz4 decompress 8MiB single thread", ITERATIONS, [&](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::lz4::decompress(compressed.data(), size, asset.data(), ASSET_SIZE);
+            root::do_not_optimize(asset);
+        }
+    });
+}
\ No newline at end of file
@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/asset/archive.h>
+#include <root/asset/archive_builder.h>
+#include <root/asset/asset_manager.h>
+#include <root/io/file_stream.h>
+#include <root/jobs/jobs.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+
+class archive_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        strcpy(file_path, "/tmp/root_archive_XXXXXX");
+        int fd = mkstemp(file_path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+    }
+
+    void TearDown() override {
+        unlink(file_path);
+    }
+
+    static auto make_data(const char* contents) -> root::buffer {
+        root::buffer data(strlen(contents));
+        memcpy(data.data(), contents, data.size());
+        return data;
+    }
+
+    auto write(const root::archive_builder& builder) -> void {
+        FILE* file = fopen(file_path, "wb");
+        ASSERT_NE(file, nullptr);
+        root::file_stream stream(file);
+        EXPECT_EQ(builder.write(stream), root::error::NO_ERROR);
+        fclose(file);
+    }
+
+    auto equals(const root::buffer_slice& slice, const char* contents) -> bool {
+        return slice.size() == strlen(contents) && memcmp(slice.data(), contents, slice.size()) == 0;
+    }
+
+    char file_path[64];
+};
+
+TEST_F(archive_tests, finds_assets) {
+    root::archive_builder builder;
+    EXPECT_TRUE(builder.add("shaders/triangle.vert.spv", make_data("vertex")));
+    EXPECT_TRUE(builder.add("shaders/triangle.frag.spv", make_data("fragment")));
+    EXPECT_TRUE(builder.add("empty", root::buffer()));
+    EXPECT_EQ(builder.count(), 3);
+    write(builder);
+
+    root::archive packed(file_path);
+    ASSERT_TRUE(packed);
+    EXPECT_EQ(packed.count(), 3);
+    EXPECT_TRUE(equals(packed.find("shaders/triangle.vert.spv"), "vertex"));
+    EXPECT_TRUE(equals(packed.find("shaders/triangle.frag.spv"), "fragment"));
+    EXPECT_TRUE(packed.find("empty"));
+    EXPECT_EQ(packed.find("empty").size(), 0);
+    EXPECT_FALSE(packed.find("shaders"));
+    EXPECT_FALSE(packed.find(""));
+    EXPECT_TRUE(packed.verify());
+}
+
+TEST_F(archive_tests, data_is_aligned) {
+    root::archive_builder builder;
+    builder.add("a", make_data("1"));
+    builder.add("bb", make_data("22"));
+    builder.add("ccc", make_data("333"));
+    write(builder);
+
+    root::archive packed(file_path);
+    for(const char* id : {"a", "bb", "ccc"}) {
+        const root::buffer_slice slice = packed.find(id);
+        EXPECT_EQ(reinterpret_cast<root::u64>(slice.data()) % root::archive_format::DATA_ALIGNMENT, 0);
+    }
+}
+
+TEST_F(archive_tests, rejects_duplicates) {
+    root::archive_builder builder;
+    EXPECT_TRUE(builder.add("a", make_data("1")));
+    EXPECT_FALSE(builder.add("a", make_data("2")));
+    EXPECT_FALSE(builder.add("", make_data("3")));
+    EXPECT_EQ(builder.count(), 1);
+}
+
+TEST_F(archive_tests, many_assets) {
+    constexpr root::u64 COUNT = 1000;
+    char id[32];
+    char contents[32];
+    root::archive_builder builder;
+    for(root::u64 i = 0; i < COUNT; i++) {
+        snprintf(id, sizeof(id), "asset_%llu", i);
+        snprintf(contents, sizeof(contents), "contents of %llu", i);
+        builder.add(root::string_view(id, 0, strlen(id)), make_data(contents));
+    }
+    write(builder);
+
+    root::archive packed(file_path);
+    ASSERT_EQ(packed.count(), COUNT);
+    for(root::u64 i = 0; i < COUNT; i++) {
+        snprintf(id, sizeof(id), "asset_%llu", i);
+        snprintf(contents, sizeof(contents), "contents of %llu", i);
+        EXPECT_TRUE(equals(packed.find(root::string_view(id, 0, strlen(id))), contents));
+    }
+}
+
+TEST_F(archive_tests, verify_catches_corruption) {
+    root::archive_builder builder;
+    builder.add("a", make_data("some contents"));
+    write(builder);
+    // Flip the last byte, which is the end of the only asset
+    FILE* file = fopen(file_path, "r+b");
+    fseek(file, -1, SEEK_END);
+    fputc('X', file);
+    fclose(file);
+
+    root::archive packed(file_path);
+    ASSERT_TRUE(packed);
+    EXPECT_FALSE(packed.verify());
+}
+
+TEST_F(archive_tests, compressed_assets) {
+    // Several chunks so decompression splits into jobs
+    constexpr root::u64 CHUNK_SIZE = 1024;
+    constexpr root::u64 SIZE = CHUNK_SIZE * 10 + 17;
+    root::buffer compressible(SIZE);
+    for(root::u64 i = 0; i < SIZE; i++) {
+        static_cast<char*>(compressible.data())[i] = "spirv"[i % 5];
+    }
+    root::buffer random(SIZE);
+    for(root::u64 i = 0; i < SIZE; i++) {
+        static_cast<char*>(random.data())[i] = static_cast<char>(rand());
+    }
+    std::vector<char> expected_compressible(static_cast<char*>(compressible.data()), static_cast<char*>(compressible.data()) + SIZE);
+    std::vector<char> expected_random(static_cast<char*>(random.data()), static_cast<char*>(random.data()) + SIZE);
+
+    root::archive_builder builder(root::allocator::get_default(), CHUNK_SIZE);
+    builder.add("compressible", std::move(compressible), true);
+    builder.add("random", std::move(random), true);
+    builder.add("small", make_data("abc"), true);
+    EXPECT_LT(builder.stored_size(), SIZE * 2);
+    write(builder);
+
+    root::archive packed(file_path);
+    ASSERT_TRUE(packed);
+    EXPECT_TRUE(packed.verify());
+    // Compressed assets can't be handed out in place
+    EXPECT_FALSE(packed.find("compressible"));
+    EXPECT_TRUE(equals(packed.find("small"), "abc"));
+
+    root::jobs::init(4);
+    std::vector<char> out(SIZE);
+    EXPECT_EQ(packed.size("compressible").value(), SIZE);
+    EXPECT_EQ(packed.read("compressible", out.data()), root::error::NO_ERROR);
+    EXPECT_EQ(out, expected_compressible);
+    EXPECT_EQ(packed.read("random", out.data()), root::error::NO_ERROR);
+    EXPECT_EQ(out, expected_random);
+    EXPECT_EQ(packed.read("missing", out.data()), root::error::NOT_FOUND);
+    root::jobs::deinit();
+
+    // And without the job system
+    std::fill(out.begin(), out.end(), 0);
+    EXPECT_EQ(packed.read("compressible", out.data()), root::error::NO_ERROR);
+    EXPECT_EQ(out, expected_compressible);
+}
+
+TEST_F(archive_tests, rejects_invalid_files) {
+    FILE* file = fopen(file_path, "wb");
+    fputs("definitely not an archive, but long enough for a header to fit in", file);
+    fclose(file);
+    root::archive packed(file_path);
+    EXPECT_FALSE(packed);
+    EXPECT_FALSE(packed.find("a"));
+
+    root::archive missing("/tmp/root_archive_missing");
+    EXPECT_FALSE(missing);
+}
+
+TEST_F(archive_tests, rejects_names_outside_the_names_table) {
+    root::archive_builder builder;
+    builder.add("a", make_data("some contents"));
+    write(builder);
+
+    // An offset that wraps around when the name size is added to it
+    FILE* file = fopen(file_path, "r+b");
+    ASSERT_NE(file, nullptr);
+    root::archive_format::header h;
+    ASSERT_EQ(fread(&h, sizeof(h), 1, file), 1);
+    bool corrupted = false;
+    for(root::u64 i = 0; i < h.m_bucket_count; i++) {
+        root::archive_format::entry e;
+        const long offset = h.m_index_offset + i * sizeof(e);
+        fseek(file, offset, SEEK_SET);
+        ASSERT_EQ(fread(&e, sizeof(e), 1, file), 1);
+        if(e.m_name_size == 0) continue;
+        e.m_name_offset = ~0ull - e.m_name_size + 1;
+        fseek(file, offset, SEEK_SET);
+        fwrite(&e, sizeof(e), 1, file);
+        corrupted = true;
+    }
+    fclose(file);
+    ASSERT_TRUE(corrupted);
+
+    root::archive packed(file_path);
+    EXPECT_FALSE(packed);
+}
+
+TEST_F(archive_tests, asset_manager_mount) {
+    root::archive_builder builder;
+    builder.add("packed_asset", make_data("packed contents"));
+    root::buffer compressible(4096);
+    memset(compressible.data(), 'z', compressible.size());
+    builder.add("compressed_asset", std::move(compressible), true);
+    write(builder);
+
+    root::asset_manager::init("/tmp");
+    EXPECT_TRUE(root::asset_manager::mount(root::path::basename(file_path)));
+    root::buffer loaded = root::asset_manager::raw_load("packed_asset");
+    ASSERT_TRUE(loaded);
+    EXPECT_TRUE(equals(loaded, "packed contents"));
+    root::asset_ref compressed = root::asset_manager::load("compressed_asset");
+    EXPECT_EQ(compressed->size(), 4096);
+    EXPECT_EQ(static_cast<const char*>(compressed->data().data())[4095], 'z');
+    root::asset_manager::deinit();
+}
+
+TEST_F(archive_tests, asset_manager_rejects_corrupt_assets) {
+    root::archive_builder builder;
+    root::buffer compressible(4096);
+    memset(compressible.data(), 'z', compressible.size());
+    builder.add("compressed_asset", std::move(compressible), true);
+    write(builder);
+
+    // Point the only chunk past the end of the asset's bytes
+    FILE* file = fopen(file_path, "r+b");
+    ASSERT_NE(file, nullptr);
+    root::archive_format::header h;
+    ASSERT_EQ(fread(&h, sizeof(h), 1, file), 1);
+    bool corrupted = false;
+    for(root::u64 i = 0; i < h.m_bucket_count; i++) {
+        root::archive_format::entry e;
+        fseek(file, h.m_index_offset + i * sizeof(e), SEEK_SET);
+        ASSERT_EQ(fread(&e, sizeof(e), 1, file), 1);
+        if(!(e.m_flags & root::archive_format::COMPRESSED)) continue;
+        const root::u32 chunk_size = 0x7FFFFFFF;
+        fseek(file, e.m_offset, SEEK_SET);
+        fwrite(&chunk_size, sizeof(chunk_size), 1, file);
+        corrupted = true;
+    }
+    fclose(file);
+    ASSERT_TRUE(corrupted);
+
+    root::asset_manager::init("/tmp");
+    EXPECT_TRUE(root::asset_manager::mount(root::path::basename(file_path)));
+    EXPECT_FALSE(root::asset_manager::raw_load("compressed_asset"));
+    root::asset_manager::deinit();
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/asset/asset_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+
+static auto make_data(const root::u64& size, const char& fill) -> root::buffer {
+    root::buffer data(size);
+    memset(data.data(), fill, size);
+    return data;
+}
+
+TEST(asset_cache_tests, hit_and_miss) {
+    root::asset_cache cache(1024);
+    EXPECT_FALSE(cache.find("a"));
+    EXPECT_EQ(cache.misses(), 1);
+
+    root::asset_ref inserted = cache.insert("a", make_data(16, 'a'));
+    root::asset_ref found = cache.find("a");
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found.get(), inserted.get());
+    EXPECT_EQ(found->id(), root::string_view("a"));
+    EXPECT_EQ(static_cast<const char*>(found->data().data())[0], 'a');
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 1);
+    EXPECT_EQ(cache.bytes(), 16);
+    EXPECT_EQ(cache.count(), 1);
+}
+
+TEST(asset_cache_tests, insert_existing_keeps_first) {
+    root::asset_cache cache(1024);
+    root::asset_ref first = cache.insert("a", make_data(16, 'a'));
+    root::asset_ref second = cache.insert("a", make_data(32, 'b'));
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(second->size(), 16);
+    EXPECT_EQ(cache.bytes(), 16);
+}
+
+TEST(asset_cache_tests, evicts_least_recently_used) {
+    root::asset_cache cache(48);
+    cache.insert("a", make_data(16, 'a'));
+    cache.insert("b", make_data(16, 'b'));
+    cache.insert("c", make_data(16, 'c'));
+    // a becomes the most recently used, so b goes first
+    EXPECT_TRUE(cache.find("a"));
+    cache.insert("d", make_data(16, 'd'));
+    EXPECT_EQ(cache.evictions(), 1);
+    EXPECT_FALSE(cache.find("b"));
+    EXPECT_TRUE(cache.find("a"));
+    EXPECT_TRUE(cache.find("c"));
+    EXPECT_TRUE(cache.find("d"));
+    EXPECT_LE(cache.bytes(), cache.budget());
+}
+
+TEST(asset_cache_tests, defers_eviction_of_held_assets) {
+    root::asset_cache cache(32);
+    root::asset_ref held = cache.insert("a", make_data(16, 'a'));
+    cache.insert("b", make_data(16, 'b'));
+    cache.insert("c", make_data(16, 'c'));
+    // a is the oldest but still held, so b goes instead
+    EXPECT_FALSE(cache.find("b"));
+    EXPECT_TRUE(cache.find("c"));
+
+    root::asset_ref also_held = cache.find("c");
+    cache.insert("d", make_data(16, 'd'));
+    EXPECT_GT(cache.bytes(), cache.budget());
+    held = root::asset_ref();
+    cache.trim();
+    EXPECT_LE(cache.bytes(), cache.budget());
+    EXPECT_FALSE(cache.find("a"));
+    EXPECT_TRUE(cache.find("c"));
+    EXPECT_TRUE(cache.find("d"));
+}
+
+TEST(asset_cache_tests, held_assets_outlive_eviction) {
+    root::asset_ref held;
+    {
+        root::asset_cache cache(16);
+        held = cache.insert("a", make_data(16, 'a'));
+        cache.clear();
+        EXPECT_TRUE(cache.find("a"));
+    }
+    EXPECT_EQ(held->size(), 16);
+    EXPECT_EQ(static_cast<const char*>(held->data().data())[15], 'a');
+}
+
+TEST(asset_cache_tests, set_budget_evicts) {
+    root::asset_cache cache(1024);
+    for(char c = 'a'; c <= 'h'; c++) {
+        const char id[] = {c, '\0'};
+        cache.insert(id, make_data(16, c));
+    }
+    EXPECT_EQ(cache.bytes(), 8 * 16);
+    cache.set_budget(32);
+    EXPECT_EQ(cache.bytes(), 32);
+    EXPECT_TRUE(cache.find("g"));
+    EXPECT_TRUE(cache.find("h"));
+    EXPECT_EQ(cache.evictions(), 6);
+}
+
+TEST(asset_cache_tests, many_assets) {
+    constexpr root::u64 COUNT = root::asset_cache::INITIAL_BUCKETS * 4;
+    root::asset_cache cache(COUNT * 8);
+    char id[16];
+    for(root::u64 i = 0; i < COUNT; i++) {
+        snprintf(id, sizeof(id), "asset_%llu", i);
+        cache.insert(id, make_data(8, static_cast<char>(i)));
+    }
+    EXPECT_EQ(cache.count(), COUNT);
+    for(root::u64 i = 0; i < COUNT; i++) {
+        snprintf(id, sizeof(id), "asset_%llu", i);
+        root::asset_ref asset = cache.find(id);
+        ASSERT_TRUE(asset);
+        EXPECT_EQ(static_cast<const char*>(asset->data().data())[0], static_cast<char>(i));
+    }
+    EXPECT_EQ(cache.hits(), COUNT);
+}
\ No newline at end of file
@@ -16,9 +16,90 @@
  * You should have received a copy of the GNU General Public License
  * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
  */
-
 #include <root/asset/asset_manager.h>
 
 #include <gtest/gtest.h>
 
-// TODO
\ No newline at end of file
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+TEST(asset_manager_tests, raw_map_matches_raw_load) {
+    char file_path[] = "/tmp/root_asset_XXXXXX";
+    int fd = mkstemp(file_path);
+    ASSERT_GE(fd, 0);
+    const char contents[] = "Some asset contents";
+    ASSERT_EQ(write(fd, contents, sizeof(contents)), sizeof(contents));
+    close(fd);
+
+    root::asset_manager::init("/tmp");
+    const root::string_view id = root::path::basename(file_path);
+    root::mapped_buffer mapped = root::asset_manager::raw_map(id);
+    root::buffer loaded = root::asset_manager::raw_load(id);
+    ASSERT_TRUE(mapped);
+    EXPECT_EQ(mapped.size(), sizeof(contents));
+    EXPECT_EQ(loaded.size(), sizeof(contents));
+    EXPECT_EQ(memcmp(mapped.data(), contents, sizeof(contents)), 0);
+    EXPECT_EQ(memcmp(loaded.data(), contents, sizeof(contents)), 0);
+    root::asset_manager::deinit();
+
+    unlink(file_path);
+}
+
+TEST(asset_manager_tests, load_async) {
+    char file_path[] = "/tmp/root_asset_XXXXXX";
+    int fd = mkstemp(file_path);
+    ASSERT_GE(fd, 0);
+    const char contents[] = "Some asset contents";
+    ASSERT_EQ(write(fd, contents, sizeof(contents)), sizeof(contents));
+    close(fd);
+
+    root::asset_manager::init("/tmp");
+    root::asset_handle load = root::asset_manager::load_async(root::path::basename(file_path));
+    load->wait();
+    ASSERT_EQ(load->status(), root::asset_load::state::ready);
+    EXPECT_EQ(load->size(), sizeof(contents));
+    EXPECT_EQ(memcmp(load->data().data(), contents, sizeof(contents)), 0);
+    root::asset_manager::deinit();
+
+    unlink(file_path);
+}
+
+TEST(asset_manager_tests, load_caches) {
+    char file_path[] = "/tmp/root_asset_XXXXXX";
+    int fd = mkstemp(file_path);
+    ASSERT_GE(fd, 0);
+    const char contents[] = "Some asset contents";
+    ASSERT_EQ(write(fd, contents, sizeof(contents)), sizeof(contents));
+    close(fd);
+
+    root::asset_manager::init("/tmp");
+    const root::string_view id = root::path::basename(file_path);
+    root::asset_ref first = root::asset_manager::load(id);
+    // Gone from disk, so only the cache can serve it
+    unlink(file_path);
+    root::asset_ref second = root::asset_manager::load(id);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(memcmp(second->data().data(), contents, sizeof(contents)), 0);
+    EXPECT_EQ(root::asset_manager::cache().misses(), 1);
+    EXPECT_EQ(root::asset_manager::cache().hits(), 1);
+    root::asset_manager::deinit();
+}
+
+TEST(asset_manager_tests, missing_files_load_empty) {
+    root::asset_manager::init("/tmp");
+    EXPECT_FALSE(root::asset_manager::raw_load("root_asset_missing"));
+    root::asset_manager::deinit();
+}
+
+TEST(asset_manager_tests, unreadable_files_load_empty) {
+    // Opens and has a size, but reading it fails
+    char dir_path[] = "/tmp/root_asset_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_path), nullptr);
+
+    root::asset_manager::init("/tmp");
+    EXPECT_FALSE(root::asset_manager::raw_load(root::path::basename(dir_path)));
+    root::asset_manager::deinit();
+
+    rmdir(dir_path);
+}
\ No newline at end of file
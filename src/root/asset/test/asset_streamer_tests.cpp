@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/asset/private/asset_streamer.h>
+#include <root/jobs/jobs.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#if defined(ROOT_LINUX)
+#include <cerrno>
+#include <cstddef>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#endif
+
+class asset_streamer_tests : public ::testing::TestWithParam<bool> {
+public:
+    void SetUp() override {
+        strcpy(file_path, "/tmp/root_asset_streamer_XXXXXX");
+        int fd = mkstemp(file_path);
+        ASSERT_GE(fd, 0);
+        for(root::u64 i = 0; i < FILE_SIZE; i++) {
+            contents[i] = static_cast<char>(rand());
+        }
+        ASSERT_EQ(write(fd, contents, FILE_SIZE), FILE_SIZE);
+        close(fd);
+    }
+
+    void TearDown() override {
+        unlink(file_path);
+    }
+
+    // The streamer wants the terminator as part of the path
+    static auto to_path(const char* str) -> root::string {
+        root::string path(strlen(str) + 1);
+        memcpy(path.data(), str, path.size());
+        return path;
+    }
+
+    auto path() -> root::string {
+        return to_path(file_path);
+    }
+
+    static constexpr root::u64 FILE_SIZE = 64 * 1024 + 3;
+    char file_path[64];
+    char contents[FILE_SIZE];
+};
+
+TEST_P(asset_streamer_tests, loads_whole_file) {
+    root::asset_streamer streamer(root::allocator::get_default(), GetParam());
+    root::asset_handle load = streamer.load(path(), root::buffer());
+    load->wait();
+    ASSERT_EQ(load->status(), root::asset_load::state::ready);
+    EXPECT_EQ(load->size(), FILE_SIZE);
+    EXPECT_EQ(memcmp(load->data().data(), contents, FILE_SIZE), 0);
+}
+
+TEST_P(asset_streamer_tests, missing_file_fails) {
+    root::asset_streamer streamer(root::allocator::get_default(), GetParam());
+    root::asset_handle load = streamer.load(to_path("/tmp/root_asset_streamer_missing"), root::buffer());
+    load->wait();
+    EXPECT_EQ(load->status(), root::asset_load::state::failed);
+}
+
+TEST_P(asset_streamer_tests, reads_into_supplied_buffer) {
+    root::asset_streamer streamer(root::allocator::get_default(), GetParam());
+    root::buffer destination(FILE_SIZE * 2);
+    const void* data = destination.data();
+    root::asset_handle load = streamer.load(path(), std::move(destination));
+    load->wait();
+    ASSERT_EQ(load->status(), root::asset_load::state::ready);
+    EXPECT_EQ(load->data().data(), data);
+    EXPECT_EQ(load->size(), FILE_SIZE);
+}
+
+TEST_P(asset_streamer_tests, replaces_small_buffer) {
+    root::asset_streamer streamer(root::allocator::get_default(), GetParam());
+    root::asset_handle load = streamer.load(path(), root::buffer(FILE_SIZE / 2));
+    load->wait();
+    ASSERT_EQ(load->status(), root::asset_load::state::ready);
+    EXPECT_GE(load->data().size(), FILE_SIZE);
+    EXPECT_EQ(memcmp(load->data().data(), contents, FILE_SIZE), 0);
+}
+
+TEST_P(asset_streamer_tests, coalesces_pending_loads) {
+    root::asset_streamer streamer(root::allocator::get_default(), GetParam());
+    root::asset_handle first = streamer.load(path(), root::buffer());
+    const bool first_done = first->done();
+    root::asset_handle second = streamer.load(path(), root::buffer());
+    // Only a load that had already finished can be told apart
+    if(!first_done && first.get() != second.get()) {
+        EXPECT_TRUE(first->done());
+    }
+    first->wait();
+    second->wait();
+    EXPECT_EQ(memcmp(second->data().data(), contents, FILE_SIZE), 0);
+}
+
+TEST_P(asset_streamer_tests, then_runs_continuation) {
+    root::asset_streamer streamer(root::allocator::get_default(), GetParam());
+    std::atomic<int> calls{0};
+    auto before = root::jobs::make_job([&calls]() { calls++; });
+    auto after = root::jobs::make_job([&calls]() { calls++; });
+    root::asset_handle load = streamer.load(path(), root::buffer());
+    load->then(&before);
+    load->wait();
+    load->then(&after);
+    while(calls.load() != 2) {}
+    EXPECT_EQ(calls.load(), 2);
+}
+
+TEST_P(asset_streamer_tests, destructor_finishes_loads) {
+    root::asset_handle load;
+    {
+        root::asset_streamer streamer(root::allocator::get_default(), GetParam());
+        load = streamer.load(path(), root::buffer());
+    }
+    EXPECT_EQ(load->status(), root::asset_load::state::ready);
+}
+
+INSTANTIATE_TEST_SUITE_P(backends, asset_streamer_tests, ::testing::Values(true, false));
+
+#if defined(ROOT_LINUX)
+/**
+ * Make io_uring_enter fail with EPERM for this thread and those it starts.
+ */
+static auto deny_io_uring_enter() -> bool {
+    sock_filter filter[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(seccomp_data, nr)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_io_uring_enter, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | (EPERM & SECCOMP_RET_DATA)),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+    };
+    sock_fprog program = {sizeof(filter) / sizeof(filter[0]), filter};
+    return prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) == 0 && prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &program) == 0;
+}
+
+/**
+ * @return 0 if the load in flight fails and the next is read by a job.
+ */
+static auto load_after_ring_failure(const char* file_path, const char* contents, const root::u64& size) -> int {
+    root::asset_streamer streamer(root::allocator::get_default(), true);
+    root::asset_handle first = streamer.load(asset_streamer_tests::to_path(file_path), root::buffer());
+    first->wait();
+    if(first->status() != root::asset_load::state::failed) return 3;
+    if(streamer.uses_io_uring()) return 4;
+    // Later loads are read by jobs instead of waiting on the dead ring
+    root::asset_handle second = streamer.load(asset_streamer_tests::to_path(file_path), root::buffer());
+    second->wait();
+    if(second->status() != root::asset_load::state::ready) return 5;
+    if(second->size() != size || memcmp(second->data().data(), contents, size) != 0) return 6;
+    return 0;
+}
+
+TEST_F(asset_streamer_tests, ring_failure_fails_pending_loads) {
+    if(!root::asset_streamer(root::allocator::get_default(), true).uses_io_uring()) {
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    // In a child process, the filter can't be taken off again
+    EXPECT_EXIT({
+        if(!deny_io_uring_enter()) exit(2);
+        exit(load_after_ring_failure(file_path, contents, FILE_SIZE));
+    }, ::testing::ExitedWithCode(0), "");
+}
+#endif
\ No newline at end of file
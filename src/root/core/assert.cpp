@@ -29,20 +29,21 @@ namespace root {
 #ifdef ROOT_ASSERT
 auto _assert_fail(const char* expr_str, const char* message, const char* file, const int line_num) -> void {
     if(!message) {
-        log::e("", "assert({}) failed at {}:{}", expr_str, file, line_num);
+        log::e("", "assert({}) failed at {}:{}"_fmt, expr_str, file, line_num);
     } else {
-        log::e("", "assert({}, {}) failed at {}:{}", expr_str, message, file, line_num);
+        log::e("", "assert({}, {}) failed at {}:{}"_fmt, expr_str, message, file, line_num);
     }
 #if defined(ROOT_LINUX)
     constexpr i32 MAX_BT = 64;
     void* bt[MAX_BT];
     i32 size = backtrace(bt, MAX_BT);
     char** bt_symbols = backtrace_symbols(bt, size);
-    log::e("assert", "backtrace:");
+    log::e("assert", "backtrace:"_fmt);
     for(int i = 0; i < size; i++) {
-        log::e("assert", "{} {} {}", i, bt[i], bt_symbols[i]);
+        log::e("assert", "{} {} {}"_fmt, i, bt[i], bt_symbols[i]);
     }
 #endif
+    log::flush();
     abort();
 }
 #endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <root/core/mpmc_queue.h>
+#include <root/core/test/benchmark.h>
+#include <root/io/format.h>
+
+#include <thread>
+#include <vector>
+
+constexpr root::u64 ITERATIONS = 1000000;
+constexpr root::u64 CAPACITY = 1024;
+constexpr root::u64 MAX_THREADS = 4;
+
+/**
+ * Each of threads producers pushes iterations / threads values while as many
+ * consumers drain them.
+ */
+static inline auto transfer(const root::u64& threads) -> root::u64 {
+    root::string name = root::format("mpmc_queue {} producers/{} consumers", threads, threads);
+    return root::benchmark(name.data(), ITERATIONS, [&threads](const root::u64& iterations) {
+        root::mpmc_queue<root::u64> queue(CAPACITY);
+        const root::u64 per_thread = iterations / threads;
+        std::vector<std::thread> workers;
+        for(root::u64 t = 0; t < threads; t++) {
+            workers.emplace_back([&queue, per_thread]() {
+                for(root::u64 i = 0; i < per_thread; i++) {
+                    while(!queue.try_push(i)) std::this_thread::yield();
+                }
+            });
+            workers.emplace_back([&queue, per_thread]() {
+                root::u64 value;
+                root::u64 sum = 0;
+                for(root::u64 i = 0; i < per_thread; i++) {
+                    while(!queue.try_pop(value)) std::this_thread::yield();
+                    sum += value;
+                }
+                root::do_not_optimize(sum);
+            });
+        }
+        for(std::thread& worker : workers) {
+            worker.join();
+        }
+    });
+}
+
+TEST(mpmc_queue_benchmarks, uncontended_push_pop) {
+    root::mpmc_queue<root::u64> queue(CAPACITY);
+    root::benchmark("mpmc_queue push+pop single thread", ITERATIONS, [&queue](const root::u64& iterations) {
+        root::u64 value;
+        for(root::u64 i = 0; i < iterations; i++) {
+            queue.try_push(i);
+            queue.try_pop(value);
+            root::do_not_optimize(value);
+        }
+    });
+}
+
+TEST(mpmc_queue_benchmarks, producers_consumers) {
+    const root::u64 hardware = std::thread::hardware_concurrency() / 2;
+    const root::u64 max_threads = hardware > MAX_THREADS ? MAX_THREADS : (hardware ? hardware : 1);
+    for(root::u64 threads = 1; threads <= max_threads; threads++) {
+        transfer(threads);
+    }
+}
\ No newline at end of file
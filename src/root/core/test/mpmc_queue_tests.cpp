@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <root/core/mpmc_queue.h>
+#include <root/memory/system_allocator.h>
+#include <root/memory/test/mock_allocator.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+TEST(mpmc_queue_tests, fifo_order) {
+    root::mpmc_queue<int> queue(8);
+    EXPECT_EQ(queue.capacity(), 8);
+    for(int i = 0; i < 5; i++) {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_EQ(queue.size_hint(), 5);
+    int value;
+    for(int i = 0; i < 5; i++) {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(mpmc_queue_tests, full_and_empty) {
+    root::mpmc_queue<int> queue(4);
+    int value;
+    EXPECT_FALSE(queue.try_pop(value));
+    for(int round = 0; round < 3; round++) {
+        for(int i = 0; i < 4; i++) {
+            EXPECT_TRUE(queue.try_push(i));
+        }
+        EXPECT_FALSE(queue.try_push(4));
+        for(int i = 0; i < 4; i++) {
+            EXPECT_TRUE(queue.try_pop(value));
+            EXPECT_EQ(value, i);
+        }
+        EXPECT_FALSE(queue.try_pop(value));
+    }
+}
+
+TEST(mpmc_queue_tests, storage_from_allocator) {
+    NiceMock<root::mock_allocator> allocator;
+    int mallocs = 0;
+    int frees = 0;
+    ON_CALL(allocator, malloc(_, _)).WillByDefault(Invoke([&mallocs](const root::u64& bytes, const root::u64& alignment) {
+        mallocs++;
+        return root::system_allocator::universal_instance.malloc(bytes, alignment);
+    }));
+    ON_CALL(allocator, free(_)).WillByDefault(Invoke([&frees](void* mem) {
+        frees++;
+        root::system_allocator::universal_instance.free(mem);
+    }));
+    {
+        root::mpmc_queue<root::u64> queue(1024, &allocator);
+        for(root::u64 i = 0; i < 1024; i++) {
+            queue.try_push(i);
+        }
+    }
+    EXPECT_EQ(mallocs, 1);
+    EXPECT_EQ(frees, 1);
+}
+
+TEST(mpmc_queue_tests, destroys_elements) {
+    std::shared_ptr<int> tracked = std::make_shared<int>(42);
+    {
+        root::mpmc_queue<std::shared_ptr<int>> queue(8);
+        queue.try_push(tracked);
+        queue.try_push(tracked);
+        queue.try_push(tracked);
+        std::shared_ptr<int> popped;
+        EXPECT_TRUE(queue.try_pop(popped));
+        EXPECT_EQ(*popped, 42);
+        popped.reset();
+        EXPECT_EQ(tracked.use_count(), 3);
+    }
+    EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(mpmc_queue_tests, concurrent_producers_and_consumers) {
+    constexpr int PRODUCERS = 4;
+    constexpr int CONSUMERS = 4;
+    constexpr root::u64 PER_PRODUCER = 50000;
+    root::mpmc_queue<root::u64> queue(256);
+    std::vector<std::atomic<root::u32>> seen(PRODUCERS * PER_PRODUCER);
+    std::atomic<root::u64> consumed{0};
+    std::vector<std::thread> threads;
+    for(int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&queue, p]() {
+            for(root::u64 i = 0; i < PER_PRODUCER; i++) {
+                while(!queue.try_push(p * PER_PRODUCER + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(int c = 0; c < CONSUMERS; c++) {
+        threads.emplace_back([&queue, &seen, &consumed]() {
+            root::u64 value;
+            while(consumed.load() < PRODUCERS * PER_PRODUCER) {
+                if(queue.try_pop(value)) {
+                    seen[value]++;
+                    consumed++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+    for(std::atomic<root::u32>& count : seen) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(mpmc_queue_tests, per_producer_order) {
+    constexpr int PRODUCERS = 3;
+    constexpr root::u64 PER_PRODUCER = 20000;
+    root::mpmc_queue<root::u64> queue(64);
+    std::vector<std::thread> producers;
+    for(root::u64 p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p]() {
+            for(root::u64 i = 0; i < PER_PRODUCER; i++) {
+                while(!queue.try_push((p << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    root::u64 next[PRODUCERS] = {};
+    root::u64 received = 0;
+    root::u64 value;
+    while(received < PRODUCERS * PER_PRODUCER) {
+        if(!queue.try_pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const root::u64 p = value >> 32;
+        EXPECT_EQ(value & 0xffffffff, next[p]);
+        next[p]++;
+        received++;
+    }
+    for(std::thread& thread : producers) {
+        thread.join();
+    }
+}
\ No newline at end of file
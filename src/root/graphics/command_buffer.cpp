@@ -38,7 +38,7 @@ command_buffer::command_buffer(const command_pool& pool)
     VkResult res = vkAllocateCommandBuffers(pool.device(), &command_buffer_info, &m_handle);
 
     if(res != VK_SUCCESS) {
-        log::e("command_buffer", "vkAllocateCommandBuffers failed with {}", res);
+        log::e("command_buffer", "vkAllocateCommandBuffers failed with {}"_fmt, res);
         abort();
     }
 }
@@ -38,7 +38,7 @@ command_pool::command_pool(const root::graphics::device& dev, allocator* alloc)
     VkResult res = vkCreateCommandPool(m_device_handle, &command_pool_create_info, nullptr, &m_handle);
 
     if(res != VK_SUCCESS) {
-        log::e("command_pool", "vkCreateCommandPool failed with {}", res);
+        log::e("command_pool", "vkCreateCommandPool failed with {}"_fmt, res);
         abort();
     }
 }
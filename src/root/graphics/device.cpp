@@ -44,7 +44,7 @@ device::device(const physical_device& phys_d,
     root_assert(m_graphics_family_index !=  physical_device::FAMILY_INVALID);
 
     if(phys_d.graphics_queue_family_index() != phys_d.present_queue_family_index(target_surface)) {
-        log::e("device", "graphics family differs from present family, we do not handle this currently");
+        log::e("device", "graphics family differs from present family, we do not handle this currently"_fmt);
         abort();
     }
 
@@ -82,7 +82,7 @@ device::device(const physical_device& phys_d,
     vkEnumerateDeviceLayerProperties(phys_d.handle(), &num_layer_property, layer_properties.data());
 
     for(int i = 0; i < num_layer_property; i++) {
-        log::d("device", "Device Layer Properties {}: {}", i, layer_properties[i]);
+        root_log_d("device", "Device Layer Properties {}: {}"_fmt, i, layer_properties[i]);
     }
 
     const char* device_layers[] = {
@@ -99,7 +99,7 @@ device::device(const physical_device& phys_d,
     VkResult res = vkCreateDevice(m_physical_device.handle(), &device_create, m_callbacks, &m_handle);
 
     if(res != VK_SUCCESS) {
-        log::e("device", "vkCreateDevice failed with {}", res);
+        log::e("device", "vkCreateDevice failed with {}"_fmt, res);
     }
 }
 
@@ -112,25 +112,28 @@ device::~device() {
 auto device::auto_select_device(const strong_ptr<instance>& i, const strong_ptr<surface>& target_surface, allocator* alloc) -> strong_ptr<device> {
     const array<physical_device>& physical_devices = i->physical_devices();
     physical_device chosen_device;
-    root::log::d("device", "Found {} physical devices", physical_devices.size());
+    root_log_d("device", "Found {} physical devices"_fmt, physical_devices.size());
     for(u32 i = 0; i < physical_devices.size(); i++) {
         VkPhysicalDeviceProperties props = physical_devices[i].properties();
-        root::log::d("device", "Device {}: {}", i, props);
+        root_log_d("device", "Device {}: {}"_fmt, i, props);
 
-        auto extension_properties = physical_devices[i].extensions(alloc);
+        // Only queried to be logged
+        if(log::enabled<log_level::debug>("device")) {
+            auto extension_properties = physical_devices[i].extensions(alloc);
 
-        for(int j = 0; j < extension_properties.size(); j++) {
-            root::log::d("device", "Extension {}:{}", j, extension_properties[j]);
-        }
+            for(int j = 0; j < extension_properties.size(); j++) {
+                root_log_d("device", "Extension {}:{}"_fmt, j, extension_properties[j]);
+            }
 
-        auto family_properties = physical_devices[i].queue_family_properties(alloc);
-        
-        root::log::d("device", "Device {} has {} queues", i, family_properties.size());
-        for(int j = 0; j < family_properties.size(); j++) {
-            root::log::d("device", "Queue {}:{}", j, family_properties[j]);
+            auto family_properties = physical_devices[i].queue_family_properties(alloc);
+
+            root_log_d("device", "Device {} has {} queues"_fmt, i, family_properties.size());
+            for(int j = 0; j < family_properties.size(); j++) {
+                root_log_d("device", "Queue {}:{}"_fmt, j, family_properties[j]);
+            }
         }
 
-        root::log::d("device", "Device {} Graphics queue family {} Present queue family {}", i, physical_devices[i].graphics_queue_family_index(),  physical_devices[i].present_queue_family_index(target_surface));
+        root_log_d("device", "Device {} Graphics queue family {} Present queue family {}"_fmt, i, physical_devices[i].graphics_queue_family_index(),  physical_devices[i].present_queue_family_index(target_surface));
 
         if(physical_devices[i].has_graphics_queue() && physical_devices[i].has_present_queue(target_surface)) {
             if(chosen_device) {
@@ -145,7 +148,7 @@ auto device::auto_select_device(const strong_ptr<instance>& i, const strong_ptr<
     }
 
     if (!chosen_device) {
-        log::e("device", "Failed to find an appropriate device");
+        log::e("device", "Failed to find an appropriate device"_fmt);
         abort();
     }
 
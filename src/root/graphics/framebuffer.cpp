@@ -48,7 +48,7 @@ framebuffer::framebuffer(const device& dev,
     VkResult res = vkCreateFramebuffer(m_device_handle, &framebuffer_create_info, nullptr, &m_handle);
 
     if(res != VK_SUCCESS) {
-        log::e("framebuffer", "vkCreateFramebuffer failed with {}", res);
+        log::e("framebuffer", "vkCreateFramebuffer failed with {}"_fmt, res);
         abort();
     }
 }
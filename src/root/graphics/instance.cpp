@@ -50,7 +50,7 @@ instance::instance(allocator* alloc)
     vkEnumerateInstanceLayerProperties(&num_layer_properties, layer_properties.data());
 
     for(int i = 0; i < num_layer_properties; i++) {
-        log::d("instance", "Instance Layer Properties {}: {}", i, layer_properties[i]);
+        log::d("instance", "Instance Layer Properties {}: {}"_fmt, i, layer_properties[i]);
     }
 
     const char* instance_layers[] = {
@@ -68,12 +68,12 @@ instance::instance(allocator* alloc)
 #if !defined(ROOT_ANDROID)
     // TODO: Move this to a different location. Ensure that it cannot be called more than once.
     if(glfwInit() != GLFW_TRUE) {
-        log::e("instance", "glfwInit failed");
+        log::e("instance", "glfwInit failed"_fmt);
         abort();
     }
 
     if(glfwVulkanSupported() != GLFW_TRUE) {
-        log::e("instance", "glfwVulkanSupported returned false");
+        log::e("instance", "glfwVulkanSupported returned false"_fmt);
         abort();
     }
 
@@ -81,7 +81,7 @@ instance::instance(allocator* alloc)
     auto glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_ext_count);
 
     for(int i = 0; i < glfw_ext_count; i++) {
-        log::d("instance", "glfw_extension[{}]: {}", i, glfw_extensions[i]);
+        log::d("instance", "glfw_extension[{}]: {}"_fmt, i, glfw_extensions[i]);
     }
 
     create_info.enabledExtensionCount = glfw_ext_count;
@@ -94,14 +94,14 @@ instance::instance(allocator* alloc)
     VkInstance handle;
     VkResult res = vkCreateInstance(&create_info, m_callbacks, &m_handle);
     if (res != VK_SUCCESS) {
-        log::e("instance", "vkCreateInstance failed with {}", res);
+        log::e("instance", "vkCreateInstance failed with {}"_fmt, res);
         abort();
     }
 
     u32 num;
     res = vkEnumeratePhysicalDevices(m_handle, &num, nullptr);
     if (res != VK_SUCCESS) {
-        log::e("instance", "vkEnumeratePhysicalDevices failed with {}", res);
+        log::e("instance", "vkEnumeratePhysicalDevices failed with {}"_fmt, res);
         abort();
     }
     
@@ -109,7 +109,7 @@ instance::instance(allocator* alloc)
     
     res = vkEnumeratePhysicalDevices(m_handle, &num, phys_devices.data());
     if (res != VK_SUCCESS) {
-        log::e("instance", "vkEnumeratePhysicalDevices failed with {}", res);
+        log::e("instance", "vkEnumeratePhysicalDevices failed with {}"_fmt, res);
         abort();
     }
 
@@ -56,7 +56,7 @@ auto physical_device::extensions(allocator* alloc) const -> const array<VkExtens
     VkResult res = vkEnumerateDeviceExtensionProperties(m_handle, nullptr, &num_extensions, nullptr);
 
     if(res != VK_SUCCESS) {
-        log::e("physical_device", "vkEnumerateDeviceExtensionProperties failed with {}", res);
+        log::e("physical_device", "vkEnumerateDeviceExtensionProperties failed with {}"_fmt, res);
         abort();
     }
 
@@ -64,7 +64,7 @@ auto physical_device::extensions(allocator* alloc) const -> const array<VkExtens
     res = vkEnumerateDeviceExtensionProperties(m_handle, nullptr, &num_extensions, extens.data());
     
     if(res != VK_SUCCESS) {
-        log::e("physical_device", "vkEnumerateDeviceExtensionProperties failed with {}", res);
+        log::e("physical_device", "vkEnumerateDeviceExtensionProperties failed with {}"_fmt, res);
         abort();
     }
 
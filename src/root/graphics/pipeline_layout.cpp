@@ -87,7 +87,7 @@ pipeline_layout::pipeline_layout(const device& dev, const VkViewport& vp, const
     // TODO use our own allocator
     VkResult res = vkCreatePipelineLayout(m_device_handle, &pipeline_layout_info, nullptr, &m_handle);
     if(res != VK_SUCCESS) {
-        log::e("pipeline", "vkCreatePipelineLayout failed with {}", res);
+        log::e("pipeline", "vkCreatePipelineLayout failed with {}"_fmt, res);
         abort();
     }
 }
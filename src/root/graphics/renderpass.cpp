@@ -62,7 +62,7 @@ renderpass::renderpass(const device& d, const attachment& attachment, allocator*
     VkResult res = vkCreateRenderPass(d.handle(), &renderpass_info, nullptr, &m_handle);
 
     if(res != VK_SUCCESS) {
-        log::e("renderpass", "vkCreateRenderPass failed with {}", res);
+        log::e("renderpass", "vkCreateRenderPass failed with {}"_fmt, res);
         abort();
     }
 }
@@ -36,7 +36,7 @@ shader_module::shader_module(const device& d,const buffer& buf) {
     VkResult res = vkCreateShaderModule(d.handle(), &create_info, nullptr, &handle);
 
     if(res != VK_SUCCESS) {
-        log::e("shader_module", "vkCreateShaderModule failed with {}", res);
+        log::e("shader_module", "vkCreateShaderModule failed with {}"_fmt, res);
     }
 }
 
@@ -41,7 +41,7 @@ surface::surface(const strong_ptr<instance>& i, const strong_ptr<window>& w, all
     root_assert(i && w);
     VkResult res = glfwCreateWindowSurface(i->handle(), w->handle(), m_callbacks, &m_handle);
     if(res != VK_SUCCESS) {
-        log::e("surface", "glfwCreateWindowSurface failed with {}", res);
+        log::e("surface", "glfwCreateWindowSurface failed with {}"_fmt, res);
         abort();
     }
 }
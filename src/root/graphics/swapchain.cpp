@@ -42,7 +42,7 @@ swapchain::swapchain(const strong_ptr<device>& d, const strong_ptr<surface>& s,
     vkGetPhysicalDeviceSurfaceFormatsKHR(m_device->get_physical_device().handle(), m_surface->handle(), &format_count, nullptr);
 
     if(format_count == 0) {
-        log::e("swapchain", "no formats supported");
+        log::e("swapchain", "no formats supported"_fmt);
         abort();
     }
 
@@ -50,7 +50,7 @@ swapchain::swapchain(const strong_ptr<device>& d, const strong_ptr<surface>& s,
     vkGetPhysicalDeviceSurfaceFormatsKHR(m_device->get_physical_device().handle(), m_surface->handle(), &format_count, temp_formats.data());
 
     for(int i = 0; i < temp_formats.size(); i++) {
-        log::d("swapchain", "format {}: {}", i, temp_formats[i]);
+        root_log_d("swapchain", "format {}: {}"_fmt, i, temp_formats[i]);
     }
 
     m_available_formats = std::move(temp_formats);
@@ -64,7 +64,7 @@ swapchain::swapchain(const strong_ptr<device>& d, const strong_ptr<surface>& s,
 
 
     if(present_mode_count == 0) {
-        log::e("swapchain", "no present modes supported");
+        log::e("swapchain", "no present modes supported"_fmt);
         abort();
     }
 
@@ -72,7 +72,7 @@ swapchain::swapchain(const strong_ptr<device>& d, const strong_ptr<surface>& s,
     vkGetPhysicalDeviceSurfacePresentModesKHR(m_device->get_physical_device().handle(), m_surface->handle(), &present_mode_count, temp_modes.data());
 
     for(int i = 0; i < temp_modes.size(); i++) {
-        log::d("swapchain", "present mode {}: {}", i, temp_modes[i]);
+        root_log_d("swapchain", "present mode {}: {}"_fmt, i, temp_modes[i]);
     }
 
     m_vailable_present_modes = std::move(temp_modes);
@@ -95,7 +95,7 @@ swapchain::~swapchain() {
 auto swapchain::refresh() -> void {
     vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_device->get_physical_device().handle(), m_surface->handle(), &m_surface_capabilities);
 
-    log::d("swapchain","surface_capabilities: {}", m_surface_capabilities);
+    root_log_d("swapchain", "surface_capabilities: {}"_fmt, m_surface_capabilities);
 
     /*
      * Choose extent
@@ -130,7 +130,7 @@ auto swapchain::refresh() -> void {
     VkResult res = vkCreateSwapchainKHR(m_device->handle(), &create_info, m_callbacks, &m_handle);
 
     if(res != VK_SUCCESS) {
-        log::e("swapchain", "vkCreateSwapchainKHR failed with {}", res);
+        log::e("swapchain", "vkCreateSwapchainKHR failed with {}"_fmt, res);
         abort();
     }
 
@@ -166,7 +166,7 @@ auto swapchain::refresh() -> void {
         res = vkCreateImageView(m_device->handle(), &view_create_info, m_callbacks, &(temp_image_views[i]));
 
         if (res != VK_SUCCESS) {
-            log::e("swapchain", "vkCreateImageView failed with {}", res);
+            log::e("swapchain", "vkCreateImageView failed with {}"_fmt, res);
         }
     }
 
@@ -179,7 +179,7 @@ auto swapchain::acquire(const semaphore& sem, const u64 timeout) -> u32 {
     VkResult res = vkAcquireNextImageKHR(m_device->handle(), handle(), timeout, sem.handle(), VK_NULL_HANDLE, &image_index);
     // TODO: deal with out of date swapchain
     if(res != VK_SUCCESS) {
-        log::e("swapchain", "vkAcquireNextImageKHR failed with {}", res);
+        log::e("swapchain", "vkAcquireNextImageKHR failed with {}"_fmt, res);
         abort();
     }
     return image_index;
@@ -208,7 +208,7 @@ auto swapchain::present(const array_slice<semaphore>& wait_semaphores, const u32
     VkResult res = vkQueuePresentKHR(m_device->get_present_queue(), &present_info);
     // TODO: deal with out of date swapchain
     if(res != VK_SUCCESS) {
-        log::e("swapchain", "vkAcquireNextImageKHR failed with {}", res);
+        log::e("swapchain", "vkAcquireNextImageKHR failed with {}"_fmt, res);
         abort();
     }
 }
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/async_logger.h>
+
+#include <atomic>
+
+namespace root {
+
+// Past this much text the batch is written out before carrying on
+constexpr u64 MAX_BATCH_SIZE = 64 * 1024;
+// How long the background thread sleeps when nobody asks for a flush
+constexpr std::chrono::milliseconds FLUSH_INTERVAL(5);
+
+static std::atomic<u64> s_next_logger_id(1);
+
+/**
+ * The rings a thread logs into, one per logger it has used recently. They are
+ * retired when the thread exits.
+ */
+struct log_thread_rings {
+    static constexpr u64 SLOTS = 4;
+
+    struct slot {
+        u64 m_logger_id;
+        log_ring* m_ring;
+    };
+
+    ~log_thread_rings() {
+        for(slot& s : m_slots) {
+            if(s.m_ring) {
+                s.m_ring->retire();
+                s.m_ring->release();
+            }
+        }
+    }
+
+    slot m_slots[SLOTS] = {};
+    u64 m_next_eviction = 0;
+};
+
+static thread_local log_thread_rings t_rings;
+
+async_logger::async_logger(writer* out, const u64& ring_capacity, allocator* alloc)
+:   m_writer(out),
+    m_ring_capacity(ring_capacity),
+    m_id(s_next_logger_id.fetch_add(1, std::memory_order_relaxed)),
+    m_allocator(alloc),
+    m_rings(nullptr),
+    m_batch(alloc),
+    m_batch_writer(&m_batch),
+    m_flush_requests(0),
+    m_flushes_done(0),
+    m_stop(false) {
+    m_batch.reserve(MAX_BATCH_SIZE);
+    m_thread = std::thread([this]() { run(); });
+}
+
+async_logger::~async_logger() {
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    while(m_rings) {
+        log_ring* next = m_rings->m_next;
+        m_rings->release();
+        m_rings = next;
+    }
+}
+
+auto async_logger::flush() -> void {
+    std::unique_lock<std::mutex> lock(m_lock);
+    const u64 ticket = ++m_flush_requests;
+    m_wake.notify_one();
+    m_flushed.wait(lock, [this, ticket]() { return m_flushes_done >= ticket; });
+}
+
+auto async_logger::thread_ring() -> log_ring* {
+    for(const log_thread_rings::slot& s : t_rings.m_slots) {
+        if(s.m_logger_id == m_id) return s.m_ring;
+    }
+    return register_thread();
+}
+
+auto async_logger::register_thread() -> log_ring* {
+    log_ring* ring = m_allocator->make<log_ring>(m_ring_capacity, m_allocator);
+    log_thread_rings::slot* free_slot = nullptr;
+    for(log_thread_rings::slot& s : t_rings.m_slots) {
+        if(!s.m_ring) {
+            free_slot = &s;
+            break;
+        }
+        // Left behind by a logger that is gone
+        if(s.m_ring->orphaned()) {
+            s.m_ring->release();
+            s.m_ring = nullptr;
+            free_slot = &s;
+            break;
+        }
+    }
+    if(!free_slot) {
+        // The ring of a logger this thread used longer ago is drained and freed
+        free_slot = &t_rings.m_slots[t_rings.m_next_eviction++ % log_thread_rings::SLOTS];
+        free_slot->m_ring->retire();
+        free_slot->m_ring->release();
+    }
+    free_slot->m_logger_id = m_id;
+    free_slot->m_ring = ring;
+    std::lock_guard<std::mutex> lock(m_lock);
+    ring->m_next = m_rings;
+    m_rings = ring;
+    return ring;
+}
+
+auto async_logger::run() -> void {
+    std::unique_lock<std::mutex> lock(m_lock);
+    for(;;) {
+        m_wake.wait_for(lock, FLUSH_INTERVAL, [this]() { return m_stop || m_flush_requests != m_flushes_done; });
+        const u64 requests = m_flush_requests;
+        const bool stop = m_stop;
+        lock.unlock();
+        drain();
+        lock.lock();
+        if(requests != m_flushes_done) {
+            m_flushes_done = requests;
+            m_flushed.notify_all();
+        }
+        if(stop) return;
+    }
+}
+
+auto async_logger::drain() -> void {
+    log_ring* rings;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        rings = m_rings;
+    }
+    // Retired before the tail is read means nothing comes after that tail
+    for(log_ring* ring = rings; ring; ring = ring->m_next) {
+        ring->m_snapshot_retired = ring->retired();
+        ring->m_snapshot = ring->tail();
+    }
+
+    // Oldest record of all rings first, each ring is in order already
+    for(;;) {
+        log_ring* oldest = nullptr;
+        const u8* oldest_record = nullptr;
+        u64 oldest_timestamp = 0;
+        for(log_ring* ring = rings; ring; ring = ring->m_next) {
+            const u8* record = ring->front(ring->m_snapshot);
+            if(!record) continue;
+            u64 timestamp;
+            memcpy(&timestamp, record + offsetof(record_header, m_timestamp), sizeof(timestamp));
+            if(!oldest || timestamp < oldest_timestamp) {
+                oldest = ring;
+                oldest_record = record;
+                oldest_timestamp = timestamp;
+            }
+        }
+        if(!oldest) break;
+        format_line(oldest_record);
+        oldest->pop();
+        if(m_batch.size() >= MAX_BATCH_SIZE) write_batch();
+    }
+
+    for(log_ring* ring = rings; ring; ring = ring->m_next) {
+        const u64 dropped = ring->take_dropped();
+        if(dropped) {
+            format_to(m_batch_writer, "WARN: async_logger: {} messages dropped, the ring was full\n"_fmt, dropped);
+        }
+    }
+    write_batch();
+
+    // Forget the rings of threads that are gone once they are empty
+    std::lock_guard<std::mutex> lock(m_lock);
+    log_ring** link = &m_rings;
+    while(*link) {
+        log_ring* ring = *link;
+        if(ring->m_snapshot_retired && !ring->front(ring->m_snapshot)) {
+            *link = ring->m_next;
+            ring->release();
+        } else {
+            link = &ring->m_next;
+        }
+    }
+}
+
+auto async_logger::format_line(const u8* record) -> void {
+    constexpr char const* COLON = ": ";
+    constexpr u64 COLON_LEN = strlen(COLON);
+    record_header header;
+    memcpy(&header, record, sizeof(header));
+    const char* prefix = log_level_prefix(header.m_level);
+    m_batch_writer.write(prefix, strlen(prefix));
+    if(header.m_tag_size) {
+        m_batch_writer.write(record + sizeof(header), header.m_tag_size);
+        m_batch_writer.write(COLON, COLON_LEN);
+    }
+    header.m_format(m_batch_writer, record + sizeof(header) + header.m_tag_size);
+    m_batch_writer.write("\n", 1);
+}
+
+auto async_logger::write_batch() -> void {
+    if(!m_batch.size()) return;
+    m_writer->write(m_batch.data(), m_batch.size());
+    m_batch.clear();
+}
+
+} // namespace root
\ No newline at end of file
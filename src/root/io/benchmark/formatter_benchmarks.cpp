@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <root/core/test/benchmark.h>
+#include <root/io/float_format.h>
+#include <root/io/format.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace root::literals;
+
+constexpr root::u64 ITERATIONS = 1000000;
+
+/**
+ * What formatter::format did before it went single pass: size everything
+ * with strlen() first, then format into a buffer of that size.
+ */
+template<typename... Args>
+inline auto two_pass_format(const root::format_string& fmt, Args... args) -> root::string {
+    const root::u64 len = root::strlen(fmt, args...);
+    root::buffer buf(len + 1, alignof(root::i8));
+    root::buffer_stream stream(buf);
+    root::buffer_writer writer(&stream);
+    root::format_to(writer, fmt, args...);
+    root::format_to(writer, '\0');
+    return root::string(std::move(buf));
+}
+
+/**
+ * How integers used to be measured, through log10 and pow.
+ */
+inline auto log10_digits(const root::u64& i) -> root::u64 {
+    if(i == 0) return 1;
+    const root::u64 digits = static_cast<root::u64>(ceil(log10(static_cast<root::f64>(i))));
+    return digits + (i % static_cast<root::u64>(pow(10, digits)) ? 0 : 1);
+}
+
+TEST(formatter_benchmarks, integer_digits) {
+    constexpr root::u64 VALUES = 1024;
+    root::u64 values[VALUES];
+    for(root::u64 i = 0; i < VALUES; i++) {
+        // Spread over every length
+        values[i] = (static_cast<root::u64>(rand()) << 32 | rand()) >> (rand() % 64);
+    }
+    root::benchmark("strlen u64", ITERATIONS, [&values](const root::u64& iterations) {
+        root::u64 total = 0;
+        for(root::u64 i = 0; i < iterations; i++) {
+            total += root::strlen(values[i % VALUES]);
+        }
+        root::do_not_optimize(total);
+    });
+    root::benchmark("log10 digits u64", ITERATIONS, [&values](const root::u64& iterations) {
+        root::u64 total = 0;
+        for(root::u64 i = 0; i < iterations; i++) {
+            total += log10_digits(values[i % VALUES]);
+        }
+        root::do_not_optimize(total);
+    });
+}
+
+TEST(formatter_benchmarks, hex_and_padding) {
+    root::benchmark("format hex", ITERATIONS, [](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::string str = root::format("handle 0x{016x} in slot {4}"_fmt, i * 0x9E3779B97F4A7C15ull, i % 1024);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("snprintf hex", ITERATIONS, [](const root::u64& iterations) {
+        char str[64];
+        for(root::u64 i = 0; i < iterations; i++) {
+            snprintf(str, sizeof(str), "handle 0x%016llx in slot %4llu", i * 0x9E3779B97F4A7C15ull, i % 1024);
+            root::do_not_optimize(str);
+        }
+    });
+}
+
+TEST(formatter_benchmarks, text) {
+    const root::string_view tag("asset_manager");
+    root::benchmark("format text", ITERATIONS, [&tag](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::string str = root::format("Mounted {} with {} assets"_fmt, tag, 12ull);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("format text, runtime format string", ITERATIONS, [&tag](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::string str = root::format("Mounted {} with {} assets", tag, 12ull);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("two pass format text", ITERATIONS, [&tag](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::string str = two_pass_format("Mounted {} with {} assets", tag, 12ull);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("snprintf text", ITERATIONS, [&tag](const root::u64& iterations) {
+        char str[64];
+        for(root::u64 i = 0; i < iterations; i++) {
+            snprintf(str, sizeof(str), "Mounted %.*s with %llu assets", static_cast<int>(tag.size()), tag.data(), 12ull);
+            root::do_not_optimize(str);
+        }
+    });
+}
+
+TEST(formatter_benchmarks, integers) {
+    root::benchmark("format integers", ITERATIONS, [](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::string str = root::format("frame {} took {} us, {} draws"_fmt, i, static_cast<root::i32>(i % 16667), i % 4096);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("two pass format integers", ITERATIONS, [](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::string str = two_pass_format("frame {} took {} us, {} draws", i, static_cast<root::i32>(i % 16667), i % 4096);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("snprintf integers", ITERATIONS, [](const root::u64& iterations) {
+        char str[64];
+        for(root::u64 i = 0; i < iterations; i++) {
+            snprintf(str, sizeof(str), "frame %llu took %d us, %llu draws", i, static_cast<root::i32>(i % 16667), i % 4096);
+            root::do_not_optimize(str);
+        }
+    });
+}
+
+TEST(formatter_benchmarks, floats) {
+    root::benchmark("format floats", ITERATIONS, [](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::string str = root::format("frame time {} ms"_fmt, 16.6 + static_cast<root::f64>(i % 100) / 100.0);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("two pass format floats", ITERATIONS, [](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::string str = two_pass_format("frame time {} ms", 16.6 + static_cast<root::f64>(i % 100) / 100.0);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("snprintf floats", ITERATIONS, [](const root::u64& iterations) {
+        char str[64];
+        for(root::u64 i = 0; i < iterations; i++) {
+            snprintf(str, sizeof(str), "frame time %f ms", 16.6 + static_cast<root::f64>(i % 100) / 100.0);
+            root::do_not_optimize(str);
+        }
+    });
+}
+
+TEST(formatter_benchmarks, float_conversion) {
+    constexpr root::u64 VALUES = 1024;
+    root::f64 values[VALUES];
+    for(root::u64 i = 0; i < VALUES; i++) {
+        // Full precision values over a wide range of magnitudes
+        values[i] = ldexp(static_cast<root::f64>(rand()) / RAND_MAX + 0.5, rand() % 128 - 64);
+    }
+    root::benchmark("to_chars shortest", ITERATIONS, [&values](const root::u64& iterations) {
+        char str[root::float_format::MAX_CHARS];
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::float_format::to_chars(str, values[i % VALUES]);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("snprintf %.17g", ITERATIONS, [&values](const root::u64& iterations) {
+        char str[64];
+        for(root::u64 i = 0; i < iterations; i++) {
+            snprintf(str, sizeof(str), "%.17g", values[i % VALUES]);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("to_chars fixed 6", ITERATIONS, [&values](const root::u64& iterations) {
+        char str[root::float_format::MAX_CHARS];
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::float_format::to_chars(str, values[i % VALUES], root::float_format::style::fixed, 6);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("snprintf %f", ITERATIONS, [&values](const root::u64& iterations) {
+        char str[root::float_format::MAX_CHARS];
+        for(root::u64 i = 0; i < iterations; i++) {
+            snprintf(str, sizeof(str), "%f", values[i % VALUES]);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("to_chars scientific 3", ITERATIONS, [&values](const root::u64& iterations) {
+        char str[root::float_format::MAX_CHARS];
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::float_format::to_chars(str, values[i % VALUES], root::float_format::style::scientific, 3);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("snprintf %.3e", ITERATIONS, [&values](const root::u64& iterations) {
+        char str[64];
+        for(root::u64 i = 0; i < iterations; i++) {
+            snprintf(str, sizeof(str), "%.3e", values[i % VALUES]);
+            root::do_not_optimize(str);
+        }
+    });
+}
+
+TEST(formatter_benchmarks, long_output) {
+    // Past the inline storage of the output stream
+    char text[512];
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    const root::string_view view(text, 0, sizeof(text) - 1);
+    root::benchmark("format long output", ITERATIONS / 10, [&view](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::string str = root::format("{} {}"_fmt, view, i);
+            root::do_not_optimize(str);
+        }
+    });
+    root::benchmark("two pass format long output", ITERATIONS / 10, [&view](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::string str = two_pass_format("{} {}", view, i);
+            root::do_not_optimize(str);
+        }
+    });
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <root/core/test/benchmark.h>
+#include <root/io/async_logger.h>
+#include <root/io/binary_logger.h>
+#include <root/io/log.h>
+#include <root/io/logger.h>
+
+#include <cstdio>
+#include <unistd.h>
+
+using namespace root::literals;
+
+constexpr root::u64 ITERATIONS = 200000;
+
+/**
+ * Time spent on the logging thread per message. The text loggers write to
+ * /dev/null, the binary one to a mapped file that nothing reads.
+ */
+TEST(logger_benchmarks, calling_thread_cost) {
+    FILE* null_file = fopen("/dev/null", "w");
+    ASSERT_NE(null_file, nullptr);
+    root::file_stream stream(null_file);
+    root::writer out(&stream);
+
+    root::logger sync_logger(&out);
+    root::benchmark("logger", ITERATIONS, [&sync_logger](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            sync_logger.d("swapchain", "Recreating swapchain {}x{} with {} images"_fmt, 1920, 1080, i);
+        }
+    });
+
+    // A ring big enough that nothing is dropped between drains
+    root::async_logger async_logger(&out, 64 * 1024 * 1024);
+    root::benchmark("async_logger", ITERATIONS, [&async_logger](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            async_logger.d("swapchain", "Recreating swapchain {}x{} with {} images"_fmt, 1920, 1080, i);
+        }
+        async_logger.flush();
+    });
+
+    char path[] = "/tmp/root_logger_benchmarkXXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_NE(fd, -1);
+    close(fd);
+    {
+        root::binary_logger binary_logger(path);
+        ASSERT_TRUE(binary_logger);
+        root::benchmark("binary_logger", ITERATIONS, [&binary_logger](const root::u64& iterations) {
+            for(root::u64 i = 0; i < iterations; i++) {
+                binary_logger.d("swapchain", "Recreating swapchain {}x{} with {} images"_fmt, 1920, 1080, i);
+            }
+        });
+    }
+    unlink(path);
+    fclose(null_file);
+}
+
+/**
+ * What a storm of one repeating error costs each call once the rate limiter
+ * holds it back.
+ */
+TEST(logger_benchmarks, suppressed_message_cost) {
+    // One message through to stdout, every one after that held back
+    root::log_rate_limiter limiter(1, 1);
+    root::log::set_rate_limiter(&limiter);
+    root::benchmark("suppressed", ITERATIONS, [](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::log::e("swapchain", "vkAcquireNextImageKHR failed with {}"_fmt, i);
+        }
+    });
+    root::log::set_rate_limiter(nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/binary_log_decoder.h>
+
+#include <root/core/array.h>
+#include <root/io/dynamic_buffer_stream.h>
+#include <root/io/formatter.h>
+#include <root/io/log_level.h>
+#include <root/io/private/binary_log_format.h>
+
+#include <cstddef>
+#include <cstring>
+
+namespace root {
+
+namespace binary_log {
+
+using namespace binary_log_format;
+
+// Past this much text the output is handed to the writer before carrying on
+constexpr u64 MAX_BATCH_SIZE = 64 * 1024;
+constexpr u64 NANOSECONDS_PER_SECOND = 1000000000;
+
+struct format_definition {
+    const char* m_text;
+    u64 m_size;
+    const type* m_types;
+    u64 m_argument_count;
+};
+
+/**
+ * Reads that never go past the end of what they were given.
+ */
+class bounded_reader {
+public:
+    inline bounded_reader(const u8* begin, const u8* end)
+    :   m_cursor(begin),
+        m_end(end) {}
+
+    template<typename T>
+    inline auto read(T& value) -> bool {
+        if(static_cast<u64>(m_end - m_cursor) < sizeof(T)) return false;
+        memcpy(&value, m_cursor, sizeof(T));
+        m_cursor += sizeof(T);
+        return true;
+    }
+
+    inline auto read_bytes(const u64& size, const u8*& bytes) -> bool {
+        if(static_cast<u64>(m_end - m_cursor) < size) return false;
+        bytes = m_cursor;
+        m_cursor += size;
+        return true;
+    }
+
+private:
+    const u8* m_cursor;
+    const u8* m_end;
+};
+
+template<typename T>
+static inline auto format_number(buffer_writer& dst, bounded_reader& arguments, const string_view& format_args) -> bool {
+    T value;
+    if(!arguments.read(value)) return false;
+    format_to(dst, value, format_args);
+    return true;
+}
+
+static inline auto format_argument(buffer_writer& dst, const type& argument_type, bounded_reader& arguments, const string_view& format_args) -> bool {
+    switch(argument_type) {
+        case type::int8: return format_number<i8>(dst, arguments, format_args);
+        case type::int16: return format_number<i16>(dst, arguments, format_args);
+        case type::int32: return format_number<i32>(dst, arguments, format_args);
+        case type::int64: return format_number<i64>(dst, arguments, format_args);
+        case type::uint8: return format_number<u8>(dst, arguments, format_args);
+        case type::uint16: return format_number<u16>(dst, arguments, format_args);
+        case type::uint32: return format_number<u32>(dst, arguments, format_args);
+        case type::uint64: return format_number<u64>(dst, arguments, format_args);
+        case type::float32: return format_number<f32>(dst, arguments, format_args);
+        case type::float64: return format_number<f64>(dst, arguments, format_args);
+        case type::boolean: {
+            u8 value;
+            if(!arguments.read(value)) return false;
+            format_to(dst, value != 0, format_args);
+            return true;
+        }
+        case type::text: {
+            u32 length;
+            const u8* text;
+            if(!arguments.read(length) || !arguments.read_bytes(length, text)) return false;
+            dst.write(text, length);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * The format text with each placeholder replaced by the next argument. Stops
+ * at the first argument that doesn't fit in the record.
+ */
+static inline auto format_message(buffer_writer& dst, const format_definition& f, bounded_reader& arguments) -> void {
+    u64 argument = 0;
+    u64 i = 0;
+    while(i < f.m_size) {
+        const char* open = static_cast<const char*>(memchr(f.m_text + i, '{', f.m_size - i));
+        const u64 literal_end = open ? open - f.m_text : f.m_size;
+        if(literal_end > i) dst.write(f.m_text + i, literal_end - i);
+        if(!open) return;
+        const char* close = static_cast<const char*>(memchr(open, '}', f.m_size - literal_end));
+        if(!close) return;
+        const string_view format_args(f.m_text, literal_end + 1, close - f.m_text);
+        if(argument >= f.m_argument_count || !format_argument(dst, f.m_types[argument], arguments, format_args)) return;
+        argument++;
+        i = close - f.m_text + 1;
+    }
+}
+
+/**
+ * A record's header, copied out of the file.
+ */
+struct record_fields {
+    u32 m_size;
+    u32 m_format_id;
+    u64 m_position;
+};
+
+static inline auto read_record(const u8* record_begin) -> record_fields {
+    record_fields fields;
+    memcpy(&fields.m_size, record_begin + offsetof(record, m_size), sizeof(fields.m_size));
+    memcpy(&fields.m_format_id, record_begin + offsetof(record, m_format_id), sizeof(fields.m_format_id));
+    memcpy(&fields.m_position, record_begin + offsetof(record, m_position), sizeof(fields.m_position));
+    return fields;
+}
+
+static inline auto format_record(buffer_writer& dst, const array<format_definition>& formats, const u8* record_begin, const record_fields& header) -> void {
+    if(header.m_format_id >= formats.size() || !formats[header.m_format_id].m_text) return;
+    const format_definition& f = formats[header.m_format_id];
+    const u64 size = header.m_size;
+
+    bounded_reader body(record_begin + sizeof(record), record_begin + size);
+    u64 timestamp;
+    u8 level;
+    u8 tag_size;
+    const u8* tag;
+    if(!body.read(timestamp) || !body.read(level) || !body.read(tag_size) || !body.read_bytes(tag_size, tag)) return;
+
+    format_to(dst, "{}.{09} "_fmt, timestamp / NANOSECONDS_PER_SECOND, timestamp % NANOSECONDS_PER_SECOND);
+    const char* prefix = log_level_prefix(static_cast<log_level>(level));
+    dst.write(prefix, strlen(prefix));
+    if(tag_size) {
+        dst.write(tag, tag_size);
+        dst.write(": ", 2);
+    }
+    format_message(dst, f, body);
+    dst.write("\n", 1);
+}
+
+/**
+ * @return INVALID_OPERATION if an entry has an id no writer would give out.
+ */
+static inline auto read_dictionary(const u8* dictionary, const u64& size, array<format_definition>& formats) -> error {
+    u32 max_id = 0;
+    for(u64 offset = 0; offset + sizeof(format_entry) <= size;) {
+        format_entry entry;
+        memcpy(&entry, dictionary + offset, sizeof(entry));
+        if(entry.m_size < sizeof(format_entry) || entry.m_size > size - offset) break;
+        if(entry.m_id >= MAX_FORMATS) return error::INVALID_OPERATION;
+        if(entry.m_id > max_id) max_id = entry.m_id;
+        offset += entry.m_size;
+    }
+
+    formats = array<format_definition>(static_cast<u64>(max_id) + 1);
+    for(u64 i = 0; i < formats.size(); i++) {
+        formats[i] = {nullptr, 0, nullptr, 0};
+    }
+    for(u64 offset = 0; offset + sizeof(format_entry) <= size;) {
+        format_entry entry;
+        memcpy(&entry, dictionary + offset, sizeof(entry));
+        if(entry.m_size < sizeof(format_entry) || entry.m_size > size - offset) break;
+        if(static_cast<u64>(entry.m_argument_count) + entry.m_format_size <= entry.m_size - sizeof(format_entry)) {
+            const u8* types = dictionary + offset + sizeof(format_entry);
+            formats[entry.m_id] = {reinterpret_cast<const char*>(types + entry.m_argument_count), entry.m_format_size,
+                                   reinterpret_cast<const type*>(types), entry.m_argument_count};
+        }
+        offset += entry.m_size;
+    }
+    return error::NO_ERROR;
+}
+
+static inline auto flush(dynamic_buffer_stream& batch, writer& out) -> void {
+    if(!batch.size()) return;
+    out.write(batch.data(), batch.size());
+    batch.clear();
+}
+
+auto decode(const void* data, const u64& size, writer& out) -> error {
+    if(size < HEADER_SIZE) return error::INVALID_OPERATION;
+    const u8* bytes = static_cast<const u8*>(data);
+    const header* h = static_cast<const header*>(data);
+    const u64 ring_capacity = h->m_ring_capacity;
+    if(h->m_magic != MAGIC || h->m_version != VERSION
+       || h->m_dictionary_offset > size || h->m_dictionary_capacity > size - h->m_dictionary_offset
+       || h->m_ring_offset > size || ring_capacity > size - h->m_ring_offset
+       || ring_capacity < BLOCK_SIZE || (ring_capacity & (ring_capacity - 1))) {
+        return error::INVALID_OPERATION;
+    }
+    const u64 dictionary_size = h->m_dictionary_size.load(std::memory_order_acquire);
+    array<format_definition> formats;
+    const error err = read_dictionary(bytes + h->m_dictionary_offset,
+                                      dictionary_size < h->m_dictionary_capacity ? dictionary_size : h->m_dictionary_capacity, formats);
+    if(err != error::NO_ERROR) return err;
+    const u8* ring = bytes + h->m_ring_offset;
+
+    dynamic_buffer_stream batch;
+    buffer_writer dst(&batch);
+    // Once the ring has wrapped the oldest whole block is the place to start
+    const u64 end = h->m_write_position.load(std::memory_order_acquire);
+    u64 position = end > ring_capacity ? (end - ring_capacity + BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1) : 0;
+    while(position < end) {
+        const u64 block_end = (position | (BLOCK_SIZE - 1)) + 1;
+        const u8* record_begin = ring + (position & (ring_capacity - 1));
+        const record_fields header = read_record(record_begin);
+        // Not written yet or already overwritten, the next block starts afresh
+        if(header.m_position != position || header.m_size < sizeof(record)
+           || header.m_size > block_end - position || header.m_size % RECORD_ALIGNMENT) {
+            position = block_end;
+            continue;
+        }
+        if(header.m_format_id != PADDING_FORMAT_ID) {
+            format_record(dst, formats, record_begin, header);
+            if(batch.size() >= MAX_BATCH_SIZE) flush(batch, out);
+        }
+        position += header.m_size;
+    }
+
+    const u64 dropped = h->m_dropped.load(std::memory_order_relaxed);
+    if(dropped) {
+        format_to(dst, "WARN: binary_logger: {} messages dropped\n"_fmt, dropped);
+    }
+    flush(batch, out);
+    return error::NO_ERROR;
+}
+
+} // namespace binary_log
+
+} // namespace root
\ No newline at end of file
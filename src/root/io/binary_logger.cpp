@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/binary_logger.h>
+
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <new>
+
+namespace root {
+
+static std::atomic<u32> s_next_format_id(binary_log_format::PADDING_FORMAT_ID + 1);
+
+binary_logger::binary_logger(const string_view& path, const u64& ring_capacity, const u64& dictionary_capacity)
+:   m_mapping(nullptr),
+    m_mapping_size(0),
+    m_header(nullptr),
+    m_dictionary(nullptr),
+    m_ring(nullptr),
+    m_ring_mask(0),
+    m_start(now()) {
+    for(std::atomic<bool>& defined : m_defined) {
+        defined.store(false, std::memory_order_relaxed);
+    }
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    u64 capacity = 2 * binary_log_format::BLOCK_SIZE;
+    while(capacity < ring_capacity) {
+        capacity <<= 1;
+    }
+    // Keeps the ring page aligned
+    const u64 dictionary_size = (dictionary_capacity + binary_log_format::HEADER_SIZE - 1) & ~(binary_log_format::HEADER_SIZE - 1);
+    const u64 mapping_size = binary_log_format::HEADER_SIZE + dictionary_size + capacity;
+
+    // string_view need not be null terminated
+    char c_path[PATH_MAX];
+    if(path.size() >= PATH_MAX) return;
+    memcpy(c_path, path.data(), path.size());
+    c_path[path.size()] = '\0';
+
+    const int fd = open(c_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(fd < 0) return;
+    if(ftruncate(fd, mapping_size) != 0) {
+        close(fd);
+        return;
+    }
+    void* memory = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if(memory == MAP_FAILED) return;
+
+    m_mapping = memory;
+    m_mapping_size = mapping_size;
+    m_header = new (memory) binary_log_format::header;
+    m_header->m_magic = binary_log_format::MAGIC;
+    m_header->m_version = binary_log_format::VERSION;
+    m_header->m_dictionary_offset = binary_log_format::HEADER_SIZE;
+    m_header->m_dictionary_capacity = dictionary_size;
+    m_header->m_ring_offset = binary_log_format::HEADER_SIZE + dictionary_size;
+    m_header->m_ring_capacity = capacity;
+    m_header->m_dropped.store(0, std::memory_order_relaxed);
+    m_header->m_dictionary_size.store(0, std::memory_order_relaxed);
+    m_header->m_write_position.store(0, std::memory_order_release);
+    m_dictionary = static_cast<u8*>(memory) + m_header->m_dictionary_offset;
+    m_ring = static_cast<u8*>(memory) + m_header->m_ring_offset;
+    m_ring_mask = capacity - 1;
+#endif
+}
+
+binary_logger::~binary_logger() {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    if(m_mapping) munmap(m_mapping, m_mapping_size);
+#endif
+}
+
+auto binary_logger::next_format_id() -> u32 {
+    return s_next_format_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto binary_logger::define(const u32& id, const char* text, const u64& size, const binary_log_format::type* types, const u64& count) -> bool {
+    if(id >= MAX_FORMATS) {
+        m_header->m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_dictionary_lock);
+    // Another thread may have got here first
+    if(m_defined[id].load(std::memory_order_relaxed)) return true;
+    const u64 entry_size = binary_log_format::align(sizeof(binary_log_format::format_entry) + count + size);
+    const u64 used = m_header->m_dictionary_size.load(std::memory_order_relaxed);
+    if(used + entry_size > m_header->m_dictionary_capacity) {
+        m_header->m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    u8* dst = m_dictionary + used;
+    const binary_log_format::format_entry entry = {static_cast<u32>(entry_size), id, static_cast<u32>(count), static_cast<u32>(size)};
+    memcpy(dst, &entry, sizeof(entry));
+    memcpy(dst + sizeof(entry), types, count);
+    memcpy(dst + sizeof(entry) + count, text, size);
+    m_header->m_dictionary_size.store(used + entry_size, std::memory_order_release);
+    m_defined[id].store(true, std::memory_order_release);
+    return true;
+}
+
+} // namespace root
\ No newline at end of file
@@ -31,6 +31,29 @@ auto buffer_stream::write(const void* src, const u64& len) -> value_or_error<u64
     return memcpy_helper(backing.offset(pointer), src, len);
 }
 
+auto buffer_stream::readv(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> {
+    u64 total = 0;
+    for(u64 i = 0; i < buffers.size(); i++) {
+        buffer_slice dst = buffers[i];
+        const value_or_error<u64> res = memcpy_helper(dst.data(), backing.offset(pointer), dst.size());
+        if(!res) return res;
+        total += res.value();
+        if(res.value() < dst.size()) break;
+    }
+    return total;
+}
+
+auto buffer_stream::writev(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> {
+    u64 total = 0;
+    for(u64 i = 0; i < buffers.size(); i++) {
+        const value_or_error<u64> res = memcpy_helper(backing.offset(pointer), buffers[i].data(), buffers[i].size());
+        if(!res) return res;
+        total += res.value();
+        if(res.value() < buffers[i].size()) break;
+    }
+    return total;
+}
+
 auto buffer_stream::seek(const i64& offset, const relative_to& relative_to) -> error {
     switch(relative_to) {
         case relative_to::start:
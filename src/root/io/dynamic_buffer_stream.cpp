@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/dynamic_buffer_stream.h>
+
+#include <cstring>
+
+namespace root {
+
+dynamic_buffer_stream::dynamic_buffer_stream(allocator* alloc)
+:   m_data(m_inline),
+    m_capacity(INLINE_CAPACITY),
+    m_size(0),
+    m_position(0),
+    m_alloc(alloc) {}
+
+dynamic_buffer_stream::dynamic_buffer_stream(dynamic_buffer_stream&& other)
+:   m_data(other.is_inline() ? m_inline : other.m_data),
+    m_capacity(other.m_capacity),
+    m_size(other.m_size),
+    m_position(other.m_position),
+    m_alloc(other.m_alloc) {
+    if(other.is_inline()) memcpy(m_inline, other.m_inline, other.m_size);
+    other.m_data = other.m_inline;
+    other.m_capacity = INLINE_CAPACITY;
+    other.clear();
+}
+
+auto dynamic_buffer_stream::reserve(const u64& capacity) -> error {
+    if(capacity <= m_capacity) return error::NO_ERROR;
+    u64 new_capacity = m_capacity * 2;
+    while(new_capacity < capacity) new_capacity *= 2;
+    u8* memory = static_cast<u8*>(m_alloc->malloc(new_capacity, alignof(u64)));
+    if(!memory) return error::UNKNOWN_ERROR;
+    memcpy(memory, m_data, m_size);
+    if(!is_inline()) m_alloc->free(m_data);
+    m_data = memory;
+    m_capacity = new_capacity;
+    return error::NO_ERROR;
+}
+
+auto dynamic_buffer_stream::prepare_write(const u64& bytes) -> error {
+    const error err = reserve(m_position + bytes);
+    if(err != error::NO_ERROR) return err;
+    if(m_position > m_size) memset(m_data + m_size, 0, m_position - m_size);
+    return error::NO_ERROR;
+}
+
+auto dynamic_buffer_stream::read(void* dst, const u64& len) -> value_or_error<u64> {
+    if(m_position >= m_size) return 0ull;
+    const u64 count = m_size - m_position < len ? m_size - m_position : len;
+    memcpy(dst, m_data + m_position, count);
+    m_position += count;
+    return count;
+}
+
+auto dynamic_buffer_stream::write(const void* src, const u64& len) -> value_or_error<u64> {
+    if(!len) return 0ull;
+    const error err = prepare_write(len);
+    if(err != error::NO_ERROR) return err;
+    memcpy(m_data + m_position, src, len);
+    m_position += len;
+    if(m_position > m_size) m_size = m_position;
+    return len;
+}
+
+auto dynamic_buffer_stream::writev(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> {
+    u64 total = 0;
+    for(u64 i = 0; i < buffers.size(); i++) {
+        total += buffers[i].size();
+    }
+    if(!total) return 0ull;
+    // Grow once for the lot
+    const error err = prepare_write(total);
+    if(err != error::NO_ERROR) return err;
+    for(u64 i = 0; i < buffers.size(); i++) {
+        memcpy(m_data + m_position, buffers[i].data(), buffers[i].size());
+        m_position += buffers[i].size();
+    }
+    if(m_position > m_size) m_size = m_position;
+    return total;
+}
+
+auto dynamic_buffer_stream::seek(const i64& offset, const relative_to& relative_to) -> error {
+    i64 base = 0;
+    switch(relative_to) {
+        case relative_to::start:
+            base = 0;
+            break;
+        case relative_to::current_position:
+            base = m_position;
+            break;
+        case relative_to::end:
+            base = m_size;
+            break;
+    }
+    if(base + offset < 0) return error::INVALID_OPERATION;
+    m_position = base + offset;
+    return error::NO_ERROR;
+}
+
+auto dynamic_buffer_stream::tell(const relative_to& relative_to) const -> value_or_error<i64> {
+    switch(relative_to) {
+        case relative_to::start:
+            return static_cast<i64>(m_position);
+        case relative_to::current_position:
+            return 0;
+        case relative_to::end:
+            return static_cast<i64>(m_position) - static_cast<i64>(m_size);
+    }
+    return error::INVALID_OPERATION;
+}
+
+auto dynamic_buffer_stream::to_buffer(const u64& alignment) const -> buffer {
+    buffer copy(m_size, alignment, m_alloc);
+    memcpy(copy.data(), m_data, m_size);
+    return copy;
+}
+
+dynamic_buffer_stream::~dynamic_buffer_stream() {
+    if(!is_inline()) m_alloc->free(m_data);
+}
+
+} // namespace root
\ No newline at end of file
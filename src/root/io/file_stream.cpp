@@ -19,6 +19,8 @@
 
 #include <root/io/file_stream.h>
 
+#include <root/io/private/vectored_io.h>
+
 namespace root {
 
 auto file_stream::read(void* dst, const u64& len) -> value_or_error<u64> {
@@ -37,6 +39,30 @@ auto file_stream::write(const void* src, const u64& len) -> value_or_error<u64>
     return res;
 }
 
+auto file_stream::writev(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    if(fflush(m_file) != 0) return error::UNKNOWN_ERROR;
+    const int fd = fileno(m_file);
+    iovec iov[vectored_io::MAX_IOVECS];
+    u64 total = 0;
+    for(u64 first = 0; first < buffers.size(); first += vectored_io::MAX_IOVECS) {
+        u64 count = 0;
+        for(u64 i = first; i < buffers.size() && count < vectored_io::MAX_IOVECS; i++) {
+            iov[count++] = vectored_io::to_iovec(buffers[i]);
+            total += buffers[i].size();
+        }
+        const error err = vectored_io::write_all(fd, iov, static_cast<int>(count), -1);
+        if(err != error::NO_ERROR) return err;
+    }
+    // stdio caches the file offset, resync it where the file is seekable
+    const off_t position = lseek(fd, 0, SEEK_CUR);
+    if(position >= 0) fseeko(m_file, position, SEEK_SET);
+    return total;
+#else
+    return stream::writev(buffers);
+#endif
+}
+
 auto file_stream::seek(const i64& offset, const relative_to& relative_to) -> error {
     int origin = 0;
     switch(relative_to) {
@@ -0,0 +1,725 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/float_format.h>
+
+#include <root/core/assert.h>
+#include <root/io/private/float_format_tables.h>
+
+#include <cstring>
+
+namespace root {
+
+namespace float_format {
+
+using namespace float_format_tables;
+
+using u128 = unsigned __int128;
+
+/**
+ * A finite, non negative value as mantissa * 10^exponent.
+ */
+struct decimal {
+    u64 mantissa;
+    i32 exponent;
+};
+
+// Shortest round trip, after Ulf Adams' "Ryu: fast float-to-string conversion"
+
+static inline auto pow5_bits(const i32& e) -> i32 {
+    return static_cast<i32>((static_cast<u32>(e) * 1217359) >> 19) + 1;
+}
+
+static inline auto log10_pow2(const i32& e) -> u32 {
+    return (static_cast<u32>(e) * 78913) >> 18;
+}
+
+static inline auto log10_pow5(const i32& e) -> u32 {
+    return (static_cast<u32>(e) * 732923) >> 20;
+}
+
+static inline auto pow5_factor(u64 value) -> u32 {
+    u32 count = 0;
+    while(value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+    return count;
+}
+
+static inline auto multiple_of_power_of_5(const u64& value, const u32& p) -> bool {
+    return pow5_factor(value) >= p;
+}
+
+static inline auto multiple_of_power_of_2(const u64& value, const u32& p) -> bool {
+    return (value & ((1ull << p) - 1)) == 0;
+}
+
+/**
+ * (m * mul) >> j for a 128 bit mul stored as {low, high}, j >= 64.
+ */
+static inline auto mul_shift_64(const u64& m, const u64* mul, const i32& j) -> u64 {
+    const u128 low = static_cast<u128>(m) * mul[0];
+    const u128 high = static_cast<u128>(m) * mul[1];
+    return static_cast<u64>(((low >> 64) + high) >> (j - 64));
+}
+
+/**
+ * (m * factor) >> shift for a 64 bit factor, shift >= 32.
+ */
+static inline auto mul_shift_32(const u32& m, const u64& factor, const i32& shift) -> u32 {
+    const u64 low = static_cast<u64>(m) * static_cast<u32>(factor);
+    const u64 high = static_cast<u64>(m) * static_cast<u32>(factor >> 32);
+    return static_cast<u32>(((low >> 32) + high) >> (shift - 32));
+}
+
+/**
+ * Pick the shortest digits of the interval [vm, vp] around vr, the scaled
+ * value and its neighbours' midpoints, rounding vr half to even when the
+ * interval allows several.
+ */
+template<typename T>
+static inline auto shortest_digits(T vr, T vp, T vm, u32 last_removed_digit, bool vm_is_trailing_zeros,
+                                   bool vr_is_trailing_zeros, const bool& accept_bounds, i32& removed) -> T {
+    if(vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        while(vp / 10 > vm / 10) {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = static_cast<u32>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if(vm_is_trailing_zeros) {
+            while(vm % 10 == 0) {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = static_cast<u32>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if(vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+            // Exactly halfway, round to even
+            last_removed_digit = 4;
+        }
+        return vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    }
+    // Common case, no trailing zeros to track
+    while(vp / 10 > vm / 10) {
+        last_removed_digit = static_cast<u32>(vr % 10);
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        removed++;
+    }
+    return vr + (vr == vm || last_removed_digit >= 5);
+}
+
+static auto shortest_f64(const u64& ieee_mantissa, const u32& ieee_exponent) -> decimal {
+    i32 e2;
+    u64 m2;
+    if(ieee_exponent == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = static_cast<i32>(ieee_exponent) - 1023 - 52 - 2;
+        m2 = (1ull << 52) | ieee_mantissa;
+    }
+
+    // Integers up to 2^53 are exact and need all their digits
+    const i32 integer_shift = -e2 - 2;
+    if(ieee_exponent != 0 && integer_shift >= 0 && integer_shift <= 52
+       && (m2 & ((1ull << integer_shift) - 1)) == 0) {
+        decimal d{m2 >> integer_shift, 0};
+        while(d.mantissa % 10 == 0) {
+            d.mantissa /= 10;
+            d.exponent++;
+        }
+        return d;
+    }
+
+    const bool accept_bounds = (m2 & 1) == 0;
+    const u64 mv = 4 * m2;
+    const u32 mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    u64 vr, vp, vm;
+    i32 e10;
+    u32 last_removed_digit = 0;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    if(e2 >= 0) {
+        const u32 q = log10_pow2(e2) - (e2 > 3);
+        e10 = static_cast<i32>(q);
+        const i32 k = DOUBLE_POW5_INV_BITCOUNT + pow5_bits(static_cast<i32>(q)) - 1;
+        const i32 i = -e2 + static_cast<i32>(q) + k;
+        vr = mul_shift_64(mv, DOUBLE_POW5_INV_SPLIT[q], i);
+        vp = mul_shift_64(mv + 2, DOUBLE_POW5_INV_SPLIT[q], i);
+        vm = mul_shift_64(mv - 1 - mm_shift, DOUBLE_POW5_INV_SPLIT[q], i);
+        if(q <= 21) {
+            if(mv % 5 == 0) {
+                vr_is_trailing_zeros = multiple_of_power_of_5(mv, q);
+            } else if(accept_bounds) {
+                vm_is_trailing_zeros = multiple_of_power_of_5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= multiple_of_power_of_5(mv + 2, q);
+            }
+        }
+    } else {
+        const u32 q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = static_cast<i32>(q) + e2;
+        const i32 i = -e2 - static_cast<i32>(q);
+        const i32 k = pow5_bits(i) - DOUBLE_POW5_BITCOUNT;
+        const i32 j = static_cast<i32>(q) - k;
+        vr = mul_shift_64(mv, DOUBLE_POW5_SPLIT[i], j);
+        vp = mul_shift_64(mv + 2, DOUBLE_POW5_SPLIT[i], j);
+        vm = mul_shift_64(mv - 1 - mm_shift, DOUBLE_POW5_SPLIT[i], j);
+        if(q <= 1) {
+            vr_is_trailing_zeros = true;
+            if(accept_bounds) {
+                vm_is_trailing_zeros = mm_shift == 1;
+            } else {
+                --vp;
+            }
+        } else if(q < 63) {
+            vr_is_trailing_zeros = multiple_of_power_of_2(mv, q);
+        }
+    }
+
+    i32 removed = 0;
+    const u64 output = shortest_digits(vr, vp, vm, last_removed_digit, vm_is_trailing_zeros,
+                                       vr_is_trailing_zeros, accept_bounds, removed);
+    return {output, e10 + removed};
+}
+
+static auto shortest_f32(const u32& ieee_mantissa, const u32& ieee_exponent) -> decimal {
+    i32 e2;
+    u32 m2;
+    if(ieee_exponent == 0) {
+        e2 = 1 - 127 - 23 - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = static_cast<i32>(ieee_exponent) - 127 - 23 - 2;
+        m2 = (1u << 23) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+    const u32 mv = 4 * m2;
+    const u32 mp = 4 * m2 + 2;
+    const u32 mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    const u32 mm = 4 * m2 - 1 - mm_shift;
+
+    u32 vr, vp, vm;
+    i32 e10;
+    u32 last_removed_digit = 0;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    if(e2 >= 0) {
+        const u32 q = log10_pow2(e2);
+        e10 = static_cast<i32>(q);
+        const i32 k = FLOAT_POW5_INV_BITCOUNT + pow5_bits(static_cast<i32>(q)) - 1;
+        const i32 i = -e2 + static_cast<i32>(q) + k;
+        vr = mul_shift_32(mv, FLOAT_POW5_INV_SPLIT[q], i);
+        vp = mul_shift_32(mp, FLOAT_POW5_INV_SPLIT[q], i);
+        vm = mul_shift_32(mm, FLOAT_POW5_INV_SPLIT[q], i);
+        if(q != 0 && (vp - 1) / 10 <= vm / 10) {
+            // The loop below removes at most one digit, so it needs the one before it
+            const i32 l = FLOAT_POW5_INV_BITCOUNT + pow5_bits(static_cast<i32>(q - 1)) - 1;
+            last_removed_digit = mul_shift_32(mv, FLOAT_POW5_INV_SPLIT[q - 1], -e2 + static_cast<i32>(q) - 1 + l) % 10;
+        }
+        if(q <= 9) {
+            if(mv % 5 == 0) {
+                vr_is_trailing_zeros = multiple_of_power_of_5(mv, q);
+            } else if(accept_bounds) {
+                vm_is_trailing_zeros = multiple_of_power_of_5(mm, q);
+            } else {
+                vp -= multiple_of_power_of_5(mp, q);
+            }
+        }
+    } else {
+        const u32 q = log10_pow5(-e2);
+        e10 = static_cast<i32>(q) + e2;
+        const i32 i = -e2 - static_cast<i32>(q);
+        const i32 k = pow5_bits(i) - FLOAT_POW5_BITCOUNT;
+        i32 j = static_cast<i32>(q) - k;
+        vr = mul_shift_32(mv, FLOAT_POW5_SPLIT[i], j);
+        vp = mul_shift_32(mp, FLOAT_POW5_SPLIT[i], j);
+        vm = mul_shift_32(mm, FLOAT_POW5_SPLIT[i], j);
+        if(q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = static_cast<i32>(q) - 1 - (pow5_bits(i + 1) - FLOAT_POW5_BITCOUNT);
+            last_removed_digit = mul_shift_32(mv, FLOAT_POW5_SPLIT[i + 1], j) % 10;
+        }
+        if(q <= 1) {
+            vr_is_trailing_zeros = true;
+            if(accept_bounds) {
+                vm_is_trailing_zeros = mm_shift == 1;
+            } else {
+                --vp;
+            }
+        } else if(q < 31) {
+            vr_is_trailing_zeros = multiple_of_power_of_2(mv, q - 1);
+        }
+    }
+
+    i32 removed = 0;
+    const u32 output = shortest_digits(vr, vp, vm, last_removed_digit, vm_is_trailing_zeros,
+                                       vr_is_trailing_zeros, accept_bounds, removed);
+    return {output, e10 + removed};
+}
+
+// Exact digits at a given precision
+
+static constexpr u64 POWERS_OF_5[28] = {
+    1ull, 5ull, 25ull, 125ull,
+    625ull, 3125ull, 15625ull, 78125ull,
+    390625ull, 1953125ull, 9765625ull, 48828125ull,
+    244140625ull, 1220703125ull, 6103515625ull, 30517578125ull,
+    152587890625ull, 762939453125ull, 3814697265625ull, 19073486328125ull,
+    95367431640625ull, 476837158203125ull, 2384185791015625ull, 11920928955078125ull,
+    59604644775390625ull, 298023223876953125ull, 1490116119384765625ull, 7450580596923828125ull
+};
+
+static inline auto bit_length(const u128& value) -> i32 {
+    const u64 high = static_cast<u64>(value >> 64);
+    if(high) return 128 - __builtin_clzll(high);
+    const u64 low = static_cast<u64>(value);
+    return low ? 64 - __builtin_clzll(low) : 0;
+}
+
+/**
+ * Write value's decimal digits, none for zero.
+ * @return digits written.
+ */
+static inline auto write_integer(char* dst, u128 value) -> u64 {
+    char digits[40];
+    char* it = digits + sizeof(digits);
+    while(value > ~0ull) {
+        // Peel off 19 digits at a time so the rest is 64 bit arithmetic
+        u64 chunk = static_cast<u64>(value % 10000000000000000000ull);
+        value /= 10000000000000000000ull;
+        for(int i = 0; i < 19; i++) {
+            *--it = static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+    u64 low = static_cast<u64>(value);
+    while(low) {
+        *--it = static_cast<char>('0' + low % 10);
+        low /= 10;
+    }
+    const u64 count = digits + sizeof(digits) - it;
+    memcpy(dst, it, count);
+    return count;
+}
+
+/**
+ * Add one to the decimal number in digits.
+ * @return its new length.
+ */
+static inline auto round_up(char* digits, const u64& count) -> u64 {
+    u64 i = count;
+    while(i > 0 && digits[i - 1] == '9') {
+        digits[--i] = '0';
+    }
+    if(i > 0) {
+        digits[i - 1]++;
+        return count;
+    }
+    // All nines, or nothing at all
+    digits[0] = '1';
+    if(count > 0) digits[count] = '0';
+    return count + 1;
+}
+
+/**
+ * m * 5^p * 2^(e2 + p) as a 128 bit fraction, when it fits.
+ */
+static auto exact_digits_u128(const u64& m, const i32& e2, const i32& p, char* digits, u64& count) -> bool {
+    const i32 abs_p = p < 0 ? -p : p;
+    if(abs_p > 54) return false;
+    const u128 pow5 = abs_p <= 27 ? static_cast<u128>(POWERS_OF_5[abs_p])
+                                  : static_cast<u128>(POWERS_OF_5[27]) * POWERS_OF_5[abs_p - 27];
+    u128 numerator = m;
+    u128 denominator = 1;
+    if(p >= 0) {
+        if(bit_length(numerator) + bit_length(pow5) > 127) return false;
+        numerator *= pow5;
+    } else {
+        denominator = pow5;
+    }
+    const i32 shift = e2 + p;
+    u128 quotient, remainder;
+    if(shift >= 0) {
+        if(bit_length(numerator) + shift > 127) return false;
+        numerator <<= shift;
+        quotient = numerator / denominator;
+        remainder = numerator % denominator;
+    } else if(denominator == 1) {
+        if(-shift > 127) {
+            // The numerator is under 2^127, so less than half of the last digit
+            count = 0;
+            return true;
+        }
+        quotient = numerator >> -shift;
+        remainder = numerator & ((static_cast<u128>(1) << -shift) - 1);
+        denominator <<= -shift;
+    } else {
+        if(bit_length(denominator) - shift > 127) return false;
+        denominator <<= -shift;
+        quotient = numerator / denominator;
+        remainder = numerator % denominator;
+    }
+    const u128 twice_remainder = remainder << 1;
+    if(twice_remainder > denominator || (twice_remainder == denominator && (quotient & 1))) {
+        quotient++;
+    }
+    count = write_integer(digits, quotient);
+    return true;
+}
+
+/**
+ * Arbitrary precision unsigned integer, just enough for exact float digits.
+ */
+struct big_integer {
+    static constexpr u32 CAPACITY = 64;
+
+    u32 m_limbs[CAPACITY];
+    u32 m_size = 0;
+};
+
+static inline auto set(big_integer& big, const u64& value) -> void {
+    big.m_limbs[0] = static_cast<u32>(value);
+    big.m_limbs[1] = static_cast<u32>(value >> 32);
+    big.m_size = big.m_limbs[1] ? 2 : (big.m_limbs[0] ? 1 : 0);
+}
+
+static inline auto multiply_small(big_integer& big, const u32& factor) -> void {
+    u64 carry = 0;
+    for(u32 i = 0; i < big.m_size; i++) {
+        const u64 product = static_cast<u64>(big.m_limbs[i]) * factor + carry;
+        big.m_limbs[i] = static_cast<u32>(product);
+        carry = product >> 32;
+    }
+    if(carry) {
+        root_assert(big.m_size < big_integer::CAPACITY);
+        big.m_limbs[big.m_size++] = static_cast<u32>(carry);
+    }
+}
+
+static inline auto multiply_pow10(big_integer& big, u32 exponent) -> void {
+    static constexpr u32 POWERS_OF_10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    while(exponent >= 9) {
+        multiply_small(big, POWERS_OF_10[9]);
+        exponent -= 9;
+    }
+    if(exponent) multiply_small(big, POWERS_OF_10[exponent]);
+}
+
+static inline auto shift_left(big_integer& big, const u32& bits) -> void {
+    if(!big.m_size) return;
+    const u32 limbs = bits / 32;
+    const u32 shift = bits % 32;
+    root_assert(big.m_size + limbs + 1 <= big_integer::CAPACITY);
+    if(shift) {
+        big.m_limbs[big.m_size + limbs] = 0;
+        for(u32 i = big.m_size; i-- > 0;) {
+            big.m_limbs[i + limbs + 1] |= big.m_limbs[i] >> (32 - shift);
+            big.m_limbs[i + limbs] = big.m_limbs[i] << shift;
+        }
+        big.m_size += limbs + (big.m_limbs[big.m_size + limbs] ? 1 : 0);
+    } else {
+        memmove(big.m_limbs + limbs, big.m_limbs, big.m_size * sizeof(u32));
+        big.m_size += limbs;
+    }
+    memset(big.m_limbs, 0, limbs * sizeof(u32));
+}
+
+static inline auto bit_length(const big_integer& big) -> i32 {
+    if(!big.m_size) return 0;
+    return static_cast<i32>(big.m_size * 32) - __builtin_clz(big.m_limbs[big.m_size - 1]);
+}
+
+static inline auto compare(const big_integer& a, const big_integer& b) -> i32 {
+    if(a.m_size != b.m_size) return a.m_size < b.m_size ? -1 : 1;
+    for(u32 i = a.m_size; i-- > 0;) {
+        if(a.m_limbs[i] != b.m_limbs[i]) return a.m_limbs[i] < b.m_limbs[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * a -= b, for a >= b.
+ */
+static inline auto subtract(big_integer& a, const big_integer& b) -> void {
+    i64 borrow = 0;
+    for(u32 i = 0; i < a.m_size; i++) {
+        const i64 difference = static_cast<i64>(a.m_limbs[i]) - (i < b.m_size ? b.m_limbs[i] : 0) - borrow;
+        a.m_limbs[i] = static_cast<u32>(difference);
+        borrow = difference < 0;
+    }
+    while(a.m_size && !a.m_limbs[a.m_size - 1]) {
+        a.m_size--;
+    }
+}
+
+/**
+ * Long division of m * 2^e2 * 10^p, one digit at a time.
+ */
+static auto exact_digits_big(const u64& m, const i32& e2, const i32& p, char* digits) -> u64 {
+    big_integer r, s;
+    set(r, m);
+    set(s, 1);
+    if(p >= 0) {
+        multiply_pow10(r, p);
+    } else {
+        multiply_pow10(s, -p);
+    }
+    if(e2 >= 0) {
+        shift_left(r, e2);
+    } else {
+        shift_left(s, -e2);
+    }
+
+    // r / s < 2^bits, so it has at most this many digits. Any extra are leading zeros.
+    const i32 bits = bit_length(r) - bit_length(s) + 1;
+    const u32 max_digits = bits > 0 ? ((bits * 1233) >> 12) + 2 : 1;
+    multiply_pow10(s, max_digits - 1);
+
+    u64 count = 0;
+    for(u32 i = 0; i < max_digits; i++) {
+        u32 digit = 0;
+        while(compare(r, s) >= 0) {
+            subtract(r, s);
+            digit++;
+        }
+        root_assert(digit < 10);
+        if(count || digit) digits[count++] = static_cast<char>('0' + digit);
+        if(i + 1 < max_digits) multiply_small(r, 10);
+    }
+
+    // What is left in r / s is the fraction below the last digit
+    shift_left(r, 1);
+    const i32 half = compare(r, s);
+    if(half > 0 || (half == 0 && count && ((digits[count - 1] - '0') & 1))) {
+        count = round_up(digits, count);
+    }
+    return count;
+}
+
+/**
+ * The digits of m * 2^e2 * 10^p rounded half to even to an integer, without
+ * leading zeros, so none for zero.
+ * @return digits written.
+ */
+static inline auto exact_digits(const u64& m, const i32& e2, const i32& p, char* digits) -> u64 {
+    u64 count;
+    if(exact_digits_u128(m, e2, p, digits, count)) return count;
+    return exact_digits_big(m, e2, p, digits);
+}
+
+// Output
+
+static inline auto write_exponent(char* dst, i32 exponent) -> u64 {
+    char* it = dst;
+    *it++ = 'e';
+    *it++ = exponent < 0 ? '-' : '+';
+    if(exponent < 0) exponent = -exponent;
+    if(exponent >= 100) {
+        *it++ = static_cast<char>('0' + exponent / 100);
+        exponent %= 100;
+    }
+    *it++ = static_cast<char>('0' + exponent / 10);
+    *it++ = static_cast<char>('0' + exponent % 10);
+    return it - dst;
+}
+
+static inline auto write_zeros(char* dst, const u64& count) -> u64 {
+    memset(dst, '0', count);
+    return count;
+}
+
+/**
+ * Fixed output pads the shortest digits of integers too big for them with the
+ * exact ones rather than zeros, which is no longer.
+ */
+static auto write_shortest(char* dst, const decimal& d, const style& s, const u64& m, const i32& e2) -> u64 {
+    char digits[20] = {'0'};
+    const u64 count = d.mantissa ? write_integer(digits, d.mantissa) : 1;
+    const i32 exponent = d.exponent;
+    const i32 scientific_exponent = exponent + static_cast<i32>(count) - 1;
+
+    style chosen = s;
+    if(s == style::general) {
+        const u64 scientific_length = count + (count > 1 ? 1 : 0) + 2
+                                      + (scientific_exponent >= 100 || scientific_exponent <= -100 ? 3 : 2);
+        u64 fixed_length;
+        if(exponent >= 0) {
+            fixed_length = count + exponent;
+        } else if(static_cast<i32>(count) + exponent > 0) {
+            fixed_length = count + 1;
+        } else {
+            fixed_length = 2 - exponent;
+        }
+        chosen = fixed_length <= scientific_length ? style::fixed : style::scientific;
+    }
+
+    char* it = dst;
+    if(chosen == style::scientific) {
+        *it++ = digits[0];
+        if(count > 1) {
+            *it++ = '.';
+            memcpy(it, digits + 1, count - 1);
+            it += count - 1;
+        }
+        it += write_exponent(it, scientific_exponent);
+    } else if(exponent > 0) {
+        it += exact_digits(m, e2, 0, it);
+    } else if(exponent == 0) {
+        memcpy(it, digits, count);
+        it += count;
+    } else if(static_cast<i32>(count) + exponent > 0) {
+        const u64 integer_digits = count + exponent;
+        memcpy(it, digits, integer_digits);
+        it += integer_digits;
+        *it++ = '.';
+        memcpy(it, digits + integer_digits, -exponent);
+        it += -exponent;
+    } else {
+        *it++ = '0';
+        *it++ = '.';
+        it += write_zeros(it, -exponent - count);
+        memcpy(it, digits, count);
+        it += count;
+    }
+    return it - dst;
+}
+
+static auto write_fixed(char* dst, const u64& m, const i32& e2, const i32& precision) -> u64 {
+    char digits[MAX_CHARS];
+    const u64 count = exact_digits(m, e2, precision, digits);
+    char* it = dst;
+    if(count <= static_cast<u64>(precision)) {
+        *it++ = '0';
+        if(precision) {
+            *it++ = '.';
+            it += write_zeros(it, precision - count);
+            memcpy(it, digits, count);
+            it += count;
+        }
+    } else {
+        const u64 integer_digits = count - precision;
+        memcpy(it, digits, integer_digits);
+        it += integer_digits;
+        if(precision) {
+            *it++ = '.';
+            memcpy(it, digits + integer_digits, precision);
+            it += precision;
+        }
+    }
+    return it - dst;
+}
+
+static auto write_scientific(char* dst, const u64& m, const i32& e2, const i32& precision) -> u64 {
+    char digits[MAX_CHARS];
+    i32 exponent = 0;
+    if(m) {
+        // floor(log10(m * 2^e2)) is within one of this, retry until precision + 1 digits come out
+        const i32 log2 = e2 + 63 - __builtin_clzll(m);
+        exponent = (log2 * 78913) >> 18;
+        while(true) {
+            const u64 count = exact_digits(m, e2, precision - exponent, digits);
+            if(count > static_cast<u64>(precision) + 1) {
+                exponent++;
+            } else if(count < static_cast<u64>(precision) + 1) {
+                exponent--;
+            } else {
+                break;
+            }
+        }
+    } else {
+        write_zeros(digits, precision + 1);
+    }
+
+    char* it = dst;
+    *it++ = digits[0];
+    if(precision) {
+        *it++ = '.';
+        memcpy(it, digits + 1, precision);
+        it += precision;
+    }
+    it += write_exponent(it, exponent);
+    return it - dst;
+}
+
+/**
+ * Everything past the sign, shared by f32 and f64.
+ */
+static inline auto write_value(char* dst, const u64& m, const i32& e2, const style& s, i32 precision,
+                               const decimal& shortest) -> u64 {
+    if(precision < 0) return write_shortest(dst, shortest, s, m, e2);
+    if(precision > MAX_PRECISION) precision = MAX_PRECISION;
+    if(s == style::scientific) return write_scientific(dst, m, e2, precision);
+    return write_fixed(dst, m, e2, precision);
+}
+
+static inline auto write_special(char* dst, const bool& negative, const bool& nan) -> u64 {
+    char* it = dst;
+    if(negative) *it++ = '-';
+    memcpy(it, nan ? "nan" : "inf", 3);
+    return it + 3 - dst;
+}
+
+auto to_chars(char* dst, const f64& f, const style& s, const i32& precision) -> u64 {
+    u64 bits;
+    memcpy(&bits, &f, sizeof(f));
+    const bool negative = bits >> 63;
+    const u64 ieee_mantissa = bits & ((1ull << 52) - 1);
+    const u32 ieee_exponent = static_cast<u32>((bits >> 52) & 0x7ff);
+    if(ieee_exponent == 0x7ff) return write_special(dst, negative, ieee_mantissa != 0);
+
+    char* it = dst;
+    if(negative) *it++ = '-';
+    const u64 m = ieee_exponent ? ieee_mantissa | (1ull << 52) : ieee_mantissa;
+    const i32 e2 = (ieee_exponent ? static_cast<i32>(ieee_exponent) : 1) - 1075;
+    decimal shortest{0, 0};
+    if(precision < 0 && m) shortest = shortest_f64(ieee_mantissa, ieee_exponent);
+    return (it - dst) + write_value(it, m, e2, s, precision, shortest);
+}
+
+auto to_chars(char* dst, const f32& f, const style& s, const i32& precision) -> u64 {
+    u32 bits;
+    memcpy(&bits, &f, sizeof(f));
+    const bool negative = bits >> 31;
+    const u32 ieee_mantissa = bits & ((1u << 23) - 1);
+    const u32 ieee_exponent = (bits >> 23) & 0xff;
+    if(ieee_exponent == 0xff) return write_special(dst, negative, ieee_mantissa != 0);
+
+    char* it = dst;
+    if(negative) *it++ = '-';
+    const u64 m = ieee_exponent ? ieee_mantissa | (1u << 23) : ieee_mantissa;
+    const i32 e2 = (ieee_exponent ? static_cast<i32>(ieee_exponent) : 1) - 150;
+    decimal shortest{0, 0};
+    if(precision < 0 && m) shortest = shortest_f32(ieee_mantissa, ieee_exponent);
+    return (it - dst) + write_value(it, m, e2, s, precision, shortest);
+}
+
+} // namespace float_format
+
+} // namespace root
\ No newline at end of file
@@ -19,9 +19,9 @@
 
 #include <root/io/format.h>
 #include <root/core/assert.h>
-#include <root/math/math.h>
+#include <root/io/float_format.h>
 
-#include <cmath>
+#include <type_traits>
 
 namespace root {
 
@@ -54,207 +54,313 @@ template<> auto format_to<bool>(buffer_writer& dst, const bool& object, const st
     format_to(dst, format_to(object));
 }
 
-template<typename T> auto integer_strlen(T i) -> u64 {
-    if(i == 0) return 1;
-    u64 digits = static_cast<u64>(ceil(log10(fabs(static_cast<f64>(i)))));
-    // If i is an exact power of 10 we will need one more character
-    return (i < 0 ? 1 : 0) + digits + (i % static_cast<T>(pow(10, digits)) ? 0 : 1);
-} 
+/**
+ * Parsed integer placeholder, {[0][width][x|X|b|o|d]}. A leading 0 pads to
+ * width with zeros after the sign instead of spaces before it.
+ */
+struct integer_spec {
+    u64 width = 0;
+    u8 base = 10;
+    bool zero_pad = false;
+    bool upper_case = false;
+};
+
+static inline auto parse_integer_spec(const string_view& format_args) -> integer_spec {
+    integer_spec spec;
+    u64 i = 0;
+    if(i < format_args.size() && format_args[i] == '0') {
+        spec.zero_pad = true;
+        i++;
+    }
+    while(i < format_args.size() && format_args[i] >= '0' && format_args[i] <= '9') {
+        spec.width = spec.width * 10 + (format_args[i] - '0');
+        i++;
+    }
+    if(i < format_args.size()) {
+        switch(format_args[i]) {
+            case 'X':
+                spec.upper_case = true;
+                // fallthrough
+            case 'x':
+                spec.base = 16;
+                break;
+            case 'b':
+                spec.base = 2;
+                break;
+            case 'o':
+                spec.base = 8;
+                break;
+            case 'd':
+                break;
+            default:
+                root_assert(false && "Unknown integer format specifier");
+        }
+    }
+    return spec;
+}
+
+static constexpr u64 POWERS_OF_10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+    10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull, 1000000000000000ull,
+    10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull
+};
+
+static constexpr char DIGIT_PAIRS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * Number of digits of value in base, with no floating point: the bit length
+ * from lzcnt gives the digit count directly for powers of two and a guess
+ * for base 10 that one table lookup corrects.
+ */
+static inline auto digit_count(const u64& value, const u8& base) -> u64 {
+    const u64 bits = 64 - __builtin_clzll(value | 1);
+    switch(base) {
+        case 2:
+            return bits;
+        case 8:
+            return (bits + 2) / 3;
+        case 16:
+            return (bits + 3) / 4;
+        default: {
+            // bits * log10(2), rounded down. value | 1 has as many digits as
+            // value but counts 0 as one digit
+            const u64 guess = (bits * 1233) >> 12;
+            return guess + ((value | 1) >= POWERS_OF_10[guess] ? 1 : 0);
+        }
+    }
+}
+
+/**
+ * Write the digits of value ending right before end.
+ * @return first digit written.
+ */
+static inline auto write_digits(char* end, u64 value, const u64& digits, const integer_spec& spec) -> char* {
+    char* out = end - digits;
+    if(spec.base == 10) {
+        char* cursor = end;
+        // Two digits per division
+        while(value >= 100) {
+            const u64 pair = (value % 100) * 2;
+            value /= 100;
+            cursor -= 2;
+            cursor[0] = DIGIT_PAIRS[pair];
+            cursor[1] = DIGIT_PAIRS[pair + 1];
+        }
+        if(value >= 10) {
+            cursor -= 2;
+            cursor[0] = DIGIT_PAIRS[value * 2];
+            cursor[1] = DIGIT_PAIRS[value * 2 + 1];
+        } else {
+            *--cursor = static_cast<char>('0' + value);
+        }
+        return out;
+    }
+    const char* alphabet = spec.upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+    const u64 shift = spec.base == 16 ? 4 : spec.base == 8 ? 3 : 1;
+    const u64 mask = spec.base - 1;
+    for(char* cursor = end; cursor != out; value >>= shift) {
+        *--cursor = alphabet[value & mask];
+    }
+    return out;
+}
+
+template<typename T> static inline auto is_negative(const T& i) -> bool {
+    if constexpr (std::is_signed_v<T>) {
+        return i < 0;
+    } else {
+        return false;
+    }
+}
+
+template<typename T> static inline auto magnitude(const T& i) -> u64 {
+    if constexpr (std::is_signed_v<T>) {
+        // Negating in unsigned arithmetic is defined for the minimum value too
+        return i < 0 ? 0ull - static_cast<u64>(static_cast<i64>(i)) : static_cast<u64>(i);
+    } else {
+        return static_cast<u64>(i);
+    }
+}
+
+template<typename T> auto integer_strlen(const T& i, const string_view& format_args = string_view()) -> u64 {
+    const integer_spec spec = parse_integer_spec(format_args);
+    const u64 length = (is_negative(i) ? 1 : 0) + digit_count(magnitude(i), spec.base);
+    return length < spec.width ? spec.width : length;
+}
+
+static inline auto write_padding(buffer_writer& dst, const char& pad, u64 count) -> void {
+    constexpr u64 CHUNK = 32;
+    const char* padding = pad == '0' ? "00000000000000000000000000000000" : "                                ";
+    while(count) {
+        const u64 len = count < CHUNK ? count : CHUNK;
+        dst.write(padding, len);
+        count -= len;
+    }
+}
+
+template<typename T> auto integer_format_to(buffer_writer& dst, const T& i, const string_view& format_args = string_view()) -> void {
+    const integer_spec spec = parse_integer_spec(format_args);
+    const u64 value = magnitude(i);
+    const u64 digits = digit_count(value, spec.base);
+    // Sign and 64 binary digits
+    char text[65];
+    char* end = text + sizeof(text);
+    char* begin = write_digits(end, value, digits, spec);
+    const bool negative = is_negative(i);
+    const u64 length = digits + (negative ? 1 : 0);
+    const u64 padding = length < spec.width ? spec.width - length : 0;
+    if(padding && spec.zero_pad) {
+        if(negative) dst.write("-", 1);
+        write_padding(dst, '0', padding);
+        dst.write(begin, digits);
+        return;
+    }
+    if(negative) *--begin = '-';
+    write_padding(dst, ' ', padding);
+    dst.write(begin, end - begin);
+}
 
 // TODO: Look for a method to do with with concepts?
 template<> auto strlen<i8>(const i8& object, const string_view& format_args) -> u64 {
-    return 1;
+    // A character unless the placeholder asks for a number
+    return format_args.size() ? integer_strlen(object, format_args) : 1;
 }
 
 template<> auto strlen<i16>(const i16& object, const string_view& format_args) -> u64 {
-    return integer_strlen(object);
+    return integer_strlen(object, format_args);
 }
 
 template<> auto strlen<i32>(const i32& object, const string_view& format_args) -> u64 {
-    return integer_strlen(object);
+    return integer_strlen(object, format_args);
 }
 
 template<> auto strlen<i64>(const i64& object, const string_view& format_args) -> u64 {
-    return integer_strlen(object);
+    return integer_strlen(object, format_args);
 }
 
 template<> auto strlen<u8>(const u8& object, const string_view& format_args) -> u64 {
-    return integer_strlen(object);
+    return integer_strlen(object, format_args);
 }
 
 template<> auto strlen<u16>(const u16& object, const string_view& format_args) -> u64 {
-    return integer_strlen(object);
+    return integer_strlen(object, format_args);
 }
 
 template<> auto strlen<u32>(const u32& object, const string_view& format_args) -> u64 {
-    return integer_strlen(object);
+    return integer_strlen(object, format_args);
 }
 
 template<> auto strlen<u64>(const u64& object, const string_view& format_args) -> u64 {
-    return integer_strlen(object);
+    return integer_strlen(object, format_args);
 }
 
-template<typename T> auto unsigned_int_format_to(buffer_writer& dst, const T& i, const u64& min_digits = 0) -> void {
-    T digits = i == 0 ? 0 : floor(log10(static_cast<f64>(i)));
-    T scale = static_cast<T>(pow(10, digits));
-    while(min_digits > (digits+1)) {
-        format_to(dst, '0');
-        digits++;
-    }
-    while(scale >= 10) {
-        format_to(dst, static_cast<i8>(((i / scale) % 10) + '0'));
-        scale/=10;
-    }
-    format_to(dst, static_cast<i8>((i  % 10) + '0'));
-} 
-
-template<typename T> auto integer_format_to(buffer_writer& dst, const T& i) -> void {
-    // This needs a cleanup
-    T abs_i = i;
-    if (i < 0) {
-        format_to(dst, '-');
-        abs_i = -i;
-    }
-    unsigned_int_format_to(dst, abs_i);
-} 
-
 template<> auto format_to<i8>(buffer_writer& dst, const i8& i, const string_view& format_args) -> void {
+    if(format_args.size()) {
+        integer_format_to(dst, i, format_args);
+        return;
+    }
     dst.write(&i, 1);
 }
 
 template<> auto format_to<i16>(buffer_writer& dst, const i16& i, const string_view& format_args) -> void {
-    integer_format_to(dst, i);
+    integer_format_to(dst, i, format_args);
 }
 
 template<> auto format_to<i32>(buffer_writer& dst, const i32& i, const string_view& format_args) -> void {
-    integer_format_to(dst, i);
+    integer_format_to(dst, i, format_args);
 }
 
 template<> auto format_to<i64>(buffer_writer& dst, const i64& i, const string_view& format_args) -> void {
-    integer_format_to(dst, i);
+    integer_format_to(dst, i, format_args);
 }
 
 template<> auto format_to<u8>(buffer_writer& dst, const u8& i, const string_view& format_args) -> void {
-    integer_format_to(dst, i);
+    integer_format_to(dst, i, format_args);
 }
 
 template<> auto format_to<u16>(buffer_writer& dst, const u16& i, const string_view& format_args) -> void {
-    integer_format_to(dst, i);
+    integer_format_to(dst, i, format_args);
 }
 
 template<> auto format_to<u32>(buffer_writer& dst, const u32& i, const string_view& format_args) -> void {
-    integer_format_to(dst, i);
+    integer_format_to(dst, i, format_args);
 }
 
 template<> auto format_to<u64>(buffer_writer& dst, const u64& i, const string_view& format_args) -> void {
-    integer_format_to(dst, i);
-}
-
-/*template<typename T> auto float_str_len(const T& f, const u32& precision = 6) -> u64 {
-    u64 sign_len = f < 0.0 ? 1 : 0;
-    f64 absolute_f = fabs(f);
-    f64 digits = log10(absolute_f);
-    return sign_len + ceil(digits) + (precision > 0 ? 1 + precision : 0);
-}*/
-
-template<typename T> auto float_str_len(const T& f, const u32& precision = 6) -> u64 {
-    u64 sign_len = f < 0.0 ? 1 : 0;
-    f64 absolute_f = fabs(f);
-    f64 digits = log10(absolute_f);
-    if(digits > static_cast<f64>(precision)) {
-        // Will print in sNe+E form
-        return sign_len + precision + 3 /*decimal point + e+*/ + strlen(static_cast<u64>(floor(digits)));
+    integer_format_to(dst, i, format_args);
+}
+
+/**
+ * Parsed float placeholder, {[.precision][e|f]}. Without a precision floats
+ * print the shortest text that reads back as the same value, and without a
+ * style whichever of fixed and scientific is shorter.
+ */
+struct float_spec {
+    float_format::style style = float_format::style::general;
+    i32 precision = float_format::SHORTEST;
+};
+
+static inline auto parse_float_spec(const string_view& format_args) -> float_spec {
+    float_spec spec;
+    u64 i = 0;
+    if(i < format_args.size() && format_args[i] == '.') {
+        spec.precision = 0;
+        i++;
+        while(i < format_args.size() && format_args[i] >= '0' && format_args[i] <= '9') {
+            spec.precision = spec.precision * 10 + (format_args[i] - '0');
+            i++;
+        }
     }
-    tuple<f64,f64> split = modf(absolute_f);
-    u64 integer_part = static_cast<u64>(split.at<0>());
-    if(integer_part == 0) {
-        // Will print in sNe-E form
-        f64 complement_digits = ceil(log10(1.0/absolute_f));
-        if(complement_digits > static_cast<f64>(precision-1))
-            return sign_len + precision + 3 /*decimal point + e-*/ + strlen(static_cast<u64>(ceil(complement_digits)));
+    if(i < format_args.size()) {
+        switch(format_args[i]) {
+            case 'e':
+                spec.style = float_format::style::scientific;
+                break;
+            case 'f':
+                spec.style = float_format::style::fixed;
+                break;
+            default:
+                root_assert(false && "Unknown float format specifier");
+        }
     }
-    return sign_len + precision + (precision > digits ? 1 : 0);
+    return spec;
 }
 
-template<> auto strlen<f32>(const f32& object, const string_view& format_args) -> u64 {
-    return float_str_len(object);
+template<typename T> static inline auto float_strlen(const T& f, const string_view& format_args) -> u64 {
+    const float_spec spec = parse_float_spec(format_args);
+    char text[float_format::MAX_CHARS];
+    return float_format::to_chars(text, f, spec.style, spec.precision);
 }
 
-template<> auto strlen<f64>(const f64& object, const string_view& format_args) -> u64 {
-    return float_str_len(object);
+template<typename T> static inline auto float_format_to(buffer_writer& dst, const T& f, const string_view& format_args) -> void {
+    const float_spec spec = parse_float_spec(format_args);
+    char text[float_format::MAX_CHARS];
+    dst.write(text, float_format::to_chars(text, f, spec.style, spec.precision));
 }
 
-/*template<typename T> auto float_format_to(buffer_writer& dst, const T& f, const u32& precision = 6) -> void {
-    if(f < 0.0) {
-        format_to(dst, '-');
-    }
-    constexpr u64 MAX_DIGITS_IN_U64 = 18;
-    f64 absolute_f = fabs(f);
-    tuple<f64,f64> split = modf(absolute_f);
-    f64 to_write = split.at<0>();
-    u64 digits_to_write = ceil(log10(split.at<0>()));
-    while(digits_to_write > MAX_DIGITS_IN_U64) {
-        f64 scale = pow(10, digits_to_write - MAX_DIGITS_IN_U64);
-        f64 this_write = to_write / scale ;
-        std:: cout << " scale: " << scale 
-                   << " this_write: " << this_write
-                   << " to_write: " << to_write
-                   << " digits_to_write: " << digits_to_write << std::endl;
-        format_to(dst, static_cast<u64>(this_write));
-        to_write -= (floor(this_write)*scale);
-        digits_to_write -= MAX_DIGITS_IN_U64;
-    }
-    format_to(dst, static_cast<u64>(to_write));
-    if(precision > 0) {
-        format_to(dst, '.');
-        f64 scaled_fractpart = split.at<1>() * pow(10, precision);
-        format_to(dst, static_cast<u64>(to_write));
-        while(-dst.tell(relative_to::end) > 0) {
-            format_to(dst, '0');
-        }
-    }
-}*/
+template<> auto strlen<f32>(const f32& object, const string_view& format_args) -> u64 {
+    return float_strlen(object, format_args);
+}
 
-template<typename T> auto float_format_to(buffer_writer& dst, const T& f, const u32& precision = 6) -> void {
-    if(f < 0.0) {
-        format_to(dst, '-');
-    }
-    f64 absolute_f = fabs(f);
-    f64 digits = log10(absolute_f);
-    if(digits > static_cast<f64>(precision)) { 
-        // Will print in sNe+E form
-        tuple<f64,f64> split = modf(digits);
-        float_format_to(dst, pow(10, split.at<1>()), precision);
-        format_to(dst, "e+");
-        format_to(dst, static_cast<u64>(split.at<0>()));
-        return;
-    }
-    tuple<f64,f64> split = modf(absolute_f);
-    u64 integer_part = static_cast<u64>(split.at<0>());
-    if(integer_part == 0) {
-        // Will print in sNe-E form
-        f64 complement_digits = ceil(log10(1.0/absolute_f));
-        if(complement_digits > static_cast<f64>(precision-1)) {
-            float_format_to(dst, absolute_f * pow(10, complement_digits), precision);
-            format_to(dst, "e-");
-            format_to(dst, static_cast<u64>(complement_digits));
-            return;
-        }
-    }
-    format_to(dst, static_cast<u64>(integer_part));
-    if (digits < precision) {
-        u64 left_over_digits = precision - (digits < 0 ? 1 : digits);
-        format_to(dst, '.');
-        unsigned_int_format_to(dst, static_cast<u64>(round(split.at<1>() * pow(10, floor(left_over_digits)))), left_over_digits);
-    }
+template<> auto strlen<f64>(const f64& object, const string_view& format_args) -> u64 {
+    return float_strlen(object, format_args);
 }
 
 template<> auto format_to<f32>(buffer_writer& dst, const f32& f, const string_view& format_args) -> void {
-    return float_format_to(dst, f);
+    float_format_to(dst, f, format_args);
 }
 
 template<> auto format_to<f64>(buffer_writer& dst, const f64& f, const string_view& format_args) -> void {
-    return float_format_to(dst, f);
+    float_format_to(dst, f, format_args);
 }
 
 } // namespace root
\ No newline at end of file
@@ -19,12 +19,123 @@
 
 #include <root/io/log.h>
 
+#include <root/core/hash.h>
+
+#include <mutex>
+
 #if defined(ROOT_LINUX)
 #include <cstdio>
 #endif
 
 namespace root {
 
+async_logger* log::m_async_logger = nullptr;
+binary_logger* log::m_binary_logger = nullptr;
+log_rate_limiter* log::m_rate_limiter = nullptr;
+
+/**
+ * Tags with a level, found by the hash of their name with linear probing.
+ * Entries are only ever added, so readers look up without the lock. Once the
+ * table is full new tags share the default level.
+ */
+constexpr u64 MAX_LOG_TAGS = 128;
+
+struct log_tag {
+    // 0 while the entry is free
+    std::atomic<u64> m_hash;
+    std::atomic<log_level> m_level;
+    // Set through set_level(tag, level) rather than following the default
+    bool m_own_level;
+};
+
+static log_tag s_tags[MAX_LOG_TAGS];
+static std::atomic<log_level> s_default_level(MIN_LOG_LEVEL);
+static std::mutex s_tags_lock;
+
+static inline auto tag_hash(const string_view& tag) -> u64 {
+    const u64 hash = fnv1a(tag);
+    return hash ? hash : 1;
+}
+
+/**
+ * @return the entry for hash, or the free one where it would go, or nullptr if
+ * the table is full.
+ */
+static inline auto probe(const u64& hash) -> log_tag* {
+    for(u64 i = 0; i < MAX_LOG_TAGS; i++) {
+        log_tag* tag = &s_tags[(hash + i) % MAX_LOG_TAGS];
+        const u64 found = tag->m_hash.load(std::memory_order_acquire);
+        if(found == hash || found == 0) return tag;
+    }
+    return nullptr;
+}
+
+/**
+ * Called with s_tags_lock held.
+ */
+static inline auto register_tag(const string_view& name) -> log_tag* {
+    const u64 hash = tag_hash(name);
+    log_tag* tag = probe(hash);
+    if(tag && tag->m_hash.load(std::memory_order_relaxed) == 0) {
+        tag->m_level.store(s_default_level.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        tag->m_own_level = false;
+        tag->m_hash.store(hash, std::memory_order_release);
+    }
+    return tag;
+}
+
+auto log::set_level(const log_level& level) -> void {
+    std::lock_guard<std::mutex> lock(s_tags_lock);
+    s_default_level.store(level, std::memory_order_relaxed);
+    for(log_tag& tag : s_tags) {
+        if(tag.m_hash.load(std::memory_order_relaxed) && !tag.m_own_level) {
+            tag.m_level.store(level, std::memory_order_relaxed);
+        }
+    }
+}
+
+auto log::set_level(const string_view& name, const log_level& level) -> void {
+    std::lock_guard<std::mutex> lock(s_tags_lock);
+    log_tag* tag = register_tag(name);
+    if(!tag) return;
+    tag->m_level.store(level, std::memory_order_relaxed);
+    tag->m_own_level = true;
+}
+
+auto log::tag_level(const string_view& name) -> const std::atomic<log_level>& {
+    std::lock_guard<std::mutex> lock(s_tags_lock);
+    log_tag* tag = register_tag(name);
+    return tag ? tag->m_level : s_default_level;
+}
+
+auto log::find_tag_level(const string_view& name) -> const std::atomic<log_level>& {
+    const u64 hash = tag_hash(name);
+    log_tag* tag = probe(hash);
+    return tag && tag->m_hash.load(std::memory_order_relaxed) == hash ? tag->m_level : s_default_level;
+}
+
+auto log::flush() -> void {
+    if(m_rate_limiter) {
+        m_rate_limiter->report([](const log_level& level, const string_view& tag, const char* format, const u64& count) {
+            switch(level) {
+            case log_level::debug:
+                write_suppressed<log_level::debug>(tag, count, format);
+                break;
+            case log_level::info:
+                write_suppressed<log_level::info>(tag, count, format);
+                break;
+            case log_level::warn:
+                write_suppressed<log_level::warn>(tag, count, format);
+                break;
+            case log_level::error:
+                write_suppressed<log_level::error>(tag, count, format);
+                break;
+            }
+        });
+    }
+    if(m_async_logger) m_async_logger->flush();
+}
+
 #if defined(ROOT_LINUX)
 logger* log::m_logger = new logger(new writer(new file_stream(stdout)));
 #endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/log_rate_limiter.h>
+
+#include <root/core/hash.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace root {
+
+log_rate_limiter::log_rate_limiter(const u64& burst, const u64& per_second, const log_level& least_limited)
+    : m_entries(), m_interval(1000000000ull / std::max(per_second, 1ull)),
+      m_tolerance(m_interval * (std::max(burst, 1ull) - 1)), m_least_limited(least_limited) {}
+
+/*
+ * The bucket is kept as the time it is full again rather than a token count,
+ * so taking a token is one compare and swap: there is one left as long as
+ * that time is less than burst - 1 intervals ahead, and taking it pushes the
+ * time an interval further.
+ */
+auto log_rate_limiter::admit(const log_level& level, const string_view& tag, const char* format, const u64& now)
+    -> admission {
+    if(level < m_least_limited) return {true, 0};
+    entry* e = find(level, tag, format);
+    if(!e) return {true, 0};
+
+    u64 full_at = e->m_full_at.load(std::memory_order_relaxed);
+    do {
+        if(full_at > now + m_tolerance) {
+            e->m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return {false, 0};
+        }
+    } while(!e->m_full_at.compare_exchange_weak(full_at, std::max(full_at, now) + m_interval,
+                                                std::memory_order_relaxed));
+
+    // Storms aside the count is 0, so skip the write that would take the line
+    if(!e->m_suppressed.load(std::memory_order_relaxed)) return {true, 0};
+    return {true, e->m_suppressed.exchange(0, std::memory_order_relaxed)};
+}
+
+auto log_rate_limiter::find(const log_level& level, const string_view& tag, const char* format) -> entry* {
+    const u64 address = reinterpret_cast<u64>(format);
+    u64 key = fnv1a(&address, sizeof(address), fnv1a(tag));
+    key = key ? key : 1;
+    for(u64 i = 0; i < MAX_KEYS; i++) {
+        entry* e = &m_entries[(key + i) % MAX_KEYS];
+        u64 found = e->m_key.load(std::memory_order_relaxed);
+        if(found == 0) {
+            if(e->m_key.compare_exchange_strong(found, key, std::memory_order_relaxed)) {
+                e->m_level = level;
+                e->m_tag_size = static_cast<u8>(std::min(tag.size(), MAX_TAG_SIZE));
+                memcpy(e->m_tag, tag.data(), e->m_tag_size);
+                e->m_format = format;
+                e->m_ready.store(true, std::memory_order_release);
+                return e;
+            }
+            // found now holds whichever key got there first
+        }
+        if(found == key) return e;
+    }
+    return nullptr;
+}
+
+} // namespace root
\ No newline at end of file
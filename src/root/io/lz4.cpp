@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/lz4.h>
+
+#include <cstring>
+
+namespace root {
+
+namespace lz4 {
+
+constexpr u64 MIN_MATCH = 4;
+// The last match has to start this far from the end of the input
+constexpr u64 MATCH_FIND_LIMIT = 12;
+// and the block always ends in this many literals
+constexpr u64 LAST_LITERALS = 5;
+constexpr u64 MAX_OFFSET = 65535;
+constexpr u32 HASH_BITS = 14;
+
+static inline auto read32(const u8* p) -> u32 {
+    u32 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline auto hash(const u32& sequence) -> u32 {
+    // Knuth's multiplicative hash
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/**
+ * Write the 4 bit length in a token as 15 followed by 255s and the rest.
+ */
+static inline auto write_length(u8*& op, u64 length) -> void {
+    while(length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<u8>(length);
+}
+
+static inline auto length_bytes(const u64& length) -> u64 {
+    return length >= 15 ? (length - 15) / 255 + 1 : 0;
+}
+
+/**
+ * Emit literals [anchor, anchor + literals) then a match, or only the
+ * literals when match_length is 0.
+ * @return false if dst would overflow.
+ */
+static inline auto emit(u8*& op, const u8* op_end, const u8* anchor, const u64& literals, const u64& offset, const u64& match_length) -> bool {
+    const u64 needed = 1 + length_bytes(literals) + literals + (match_length ? 2 + length_bytes(match_length - MIN_MATCH) : 0);
+    if(needed > static_cast<u64>(op_end - op)) return false;
+    u8* token = op++;
+    *token = static_cast<u8>((literals < 15 ? literals : 15) << 4);
+    if(literals >= 15) write_length(op, literals - 15);
+    if(literals) memcpy(op, anchor, literals);
+    op += literals;
+    if(match_length == 0) return true;
+    *op++ = static_cast<u8>(offset);
+    *op++ = static_cast<u8>(offset >> 8);
+    const u64 length = match_length - MIN_MATCH;
+    *token |= static_cast<u8>(length < 15 ? length : 15);
+    if(length >= 15) write_length(op, length - 15);
+    return true;
+}
+
+auto compress(const void* src, const u64& src_size, void* dst, const u64& dst_capacity) -> u64 {
+    if(src_size > MAX_INPUT_SIZE) return 0;
+    const u8* in = static_cast<const u8*>(src);
+    u8* op = static_cast<u8*>(dst);
+    const u8* op_end = op + dst_capacity;
+    u64 anchor = 0;
+
+    if(src_size > MATCH_FIND_LIMIT) {
+        u32 table[1 << HASH_BITS] = {};
+        const u64 limit = src_size - MATCH_FIND_LIMIT;
+        const u64 match_limit = src_size - LAST_LITERALS;
+        u64 ip = 0;
+        while(ip < limit) {
+            const u32 sequence = read32(in + ip);
+            const u32 h = hash(sequence);
+            u64 ref = table[h];
+            table[h] = static_cast<u32>(ip);
+            if(ref >= ip || ip - ref > MAX_OFFSET || read32(in + ref) != sequence) {
+                ip++;
+                continue;
+            }
+            while(ip > anchor && ref > 0 && in[ip - 1] == in[ref - 1]) {
+                ip--;
+                ref--;
+            }
+            u64 length = MIN_MATCH;
+            while(ip + length < match_limit && in[ref + length] == in[ip + length]) {
+                length++;
+            }
+            if(!emit(op, op_end, in + anchor, ip - anchor, ip - ref, length)) return 0;
+            ip += length;
+            anchor = ip;
+            // Positions skipped over by the match are worth finding again
+            if(ip < limit) table[hash(read32(in + ip - 2))] = static_cast<u32>(ip - 2);
+        }
+    }
+    if(!emit(op, op_end, in + anchor, src_size - anchor, 0, 0)) return 0;
+    return op - static_cast<u8*>(dst);
+}
+
+/**
+ * Read the extra bytes of a length whose 4 bits in the token were all set.
+ */
+static inline auto read_length(const u8*& ip, const u8* ip_end, u64& length) -> bool {
+    u8 byte;
+    do {
+        if(ip == ip_end) return false;
+        byte = *ip++;
+        length += byte;
+    } while(byte == 255);
+    return true;
+}
+
+auto decompress(const void* src, const u64& src_size, void* dst, const u64& dst_size) -> bool {
+    const u8* ip = static_cast<const u8*>(src);
+    const u8* ip_end = ip + src_size;
+    u8* out = static_cast<u8*>(dst);
+    u8* op = out;
+    u8* op_end = op + dst_size;
+
+    while(ip != ip_end) {
+        const u8 token = *ip++;
+        u64 literals = token >> 4;
+        if(literals == 15 && !read_length(ip, ip_end, literals)) return false;
+        if(literals > static_cast<u64>(ip_end - ip) || literals > static_cast<u64>(op_end - op)) return false;
+        if(literals) memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+        // The last sequence is literals only
+        if(ip == ip_end) break;
+
+        if(ip_end - ip < 2) return false;
+        const u64 offset = ip[0] | (static_cast<u64>(ip[1]) << 8);
+        ip += 2;
+        if(offset == 0 || offset > static_cast<u64>(op - out)) return false;
+        u64 length = token & 15;
+        if(length == 15 && !read_length(ip, ip_end, length)) return false;
+        length += MIN_MATCH;
+        if(length > static_cast<u64>(op_end - op)) return false;
+        const u8* match = op - offset;
+        if(offset >= length) {
+            memcpy(op, match, length);
+            op += length;
+        } else {
+            // Overlapping copies repeat the last offset bytes
+            for(u64 i = 0; i < length; i++) {
+                *op++ = *match++;
+            }
+        }
+    }
+    return op == op_end;
+}
+
+} // namespace lz4
+
+} // namespace root
\ No newline at end of file
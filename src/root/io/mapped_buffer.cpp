@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/mapped_buffer.h>
+
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+namespace root {
+
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+static inline auto to_advice(const access_pattern& pattern) -> int {
+    switch(pattern) {
+        case access_pattern::sequential:
+            return MADV_SEQUENTIAL;
+        case access_pattern::random:
+            return MADV_RANDOM;
+        case access_pattern::will_need:
+            return MADV_WILLNEED;
+        case access_pattern::normal:
+        default:
+            return MADV_NORMAL;
+    }
+}
+#endif
+
+mapped_buffer::mapped_buffer(const string_view& path, const access_pattern& pattern)
+:   mapped_buffer() {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    // string_view need not be null terminated
+    char c_path[PATH_MAX];
+    if(path.size() >= PATH_MAX) return;
+    memcpy(c_path, path.data(), path.size());
+    c_path[path.size()] = '\0';
+
+    const int fd = open(c_path, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) return;
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return;
+    }
+    void* memory = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if(memory == MAP_FAILED) return;
+    m_data = memory;
+    m_byte_size = info.st_size;
+    advise(pattern);
+#endif
+}
+
+auto mapped_buffer::advise(const access_pattern& pattern, const u64& offset, const u64& len) -> error {
+    if(!*this || offset >= m_byte_size) return error::INVALID_OPERATION;
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    // madvise() wants a page aligned start
+    const u64 page_size = sysconf(_SC_PAGESIZE);
+    const u64 start = offset & ~(page_size - 1);
+    const u64 end = len == 0 || offset + len > m_byte_size ? m_byte_size : offset + len;
+    if(madvise(static_cast<u8*>(m_data) + start, end - start, to_advice(pattern)) != 0) {
+        return error::UNKNOWN_ERROR;
+    }
+    return error::NO_ERROR;
+#else
+    return error::INVALID_OPERATION;
+#endif
+}
+
+auto mapped_buffer::unmap() -> void {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    if(m_data) munmap(m_data, m_byte_size);
+#endif
+    clear();
+}
+
+} // namespace root
\ No newline at end of file
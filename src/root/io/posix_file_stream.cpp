@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/posix_file_stream.h>
+
+#include <root/io/private/vectored_io.h>
+
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+#include <cerrno>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+namespace root {
+
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+static inline auto open_flags(const file_mode& mode) -> int {
+    switch(mode) {
+        case file_mode::write:
+            return O_WRONLY | O_CREAT | O_TRUNC;
+        case file_mode::read_write:
+            return O_RDWR | O_CREAT;
+        case file_mode::direct_read:
+            return O_RDONLY | O_DIRECT;
+        case file_mode::read:
+        default:
+            return O_RDONLY;
+    }
+}
+
+/**
+ * pread() until len bytes are in or the file ends.
+ */
+static inline auto pread_all(const int& fd, void* dst, const u64& len, const u64& offset) -> value_or_error<u64> {
+    u64 total = 0;
+    while(total < len) {
+        const ssize_t res = pread(fd, static_cast<u8*>(dst) + total, len - total, offset + total);
+        if(res < 0) {
+            if(errno == EINTR) continue;
+            return error::UNKNOWN_ERROR;
+        }
+        if(res == 0) break;
+        total += res;
+    }
+    return total;
+}
+
+static inline auto pwrite_all(const int& fd, const void* src, const u64& len, const u64& offset) -> error {
+    u64 total = 0;
+    while(total < len) {
+        const ssize_t res = pwrite(fd, static_cast<const u8*>(src) + total, len - total, offset + total);
+        if(res < 0) {
+            if(errno == EINTR) continue;
+            return error::UNKNOWN_ERROR;
+        }
+        total += res;
+    }
+    return error::NO_ERROR;
+}
+#endif
+
+posix_file_stream::posix_file_stream(const string_view& path, const file_mode& mode, const u64& buffer_size, allocator* alloc)
+:   m_alloc(alloc),
+    m_buffer_size(buffer_size ? buffer_size : DEFAULT_BUFFER_SIZE),
+    m_fd(-1),
+    m_mode(mode),
+    m_direct(false),
+    m_dirty(false),
+    m_position(0),
+    m_size(0),
+    m_buffer_offset(0),
+    m_buffer_length(0) {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    // string_view need not be null terminated
+    char c_path[PATH_MAX];
+    if(path.size() >= PATH_MAX) return;
+    memcpy(c_path, path.data(), path.size());
+    c_path[path.size()] = '\0';
+
+    const int flags = open_flags(mode) | O_CLOEXEC;
+    m_fd = open(c_path, flags, 0644);
+    m_direct = m_fd >= 0 && (flags & O_DIRECT);
+    if(m_fd < 0 && errno == EINVAL && (flags & O_DIRECT)) {
+        m_fd = open(c_path, flags & ~O_DIRECT);
+    }
+    if(m_fd < 0) return;
+    struct stat info;
+    if(fstat(m_fd, &info) != 0) {
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    m_size = info.st_size;
+    if(m_direct) {
+        // O_DIRECT transfers must be whole, aligned blocks
+        const u64 size = buffer_size < DIRECT_ALIGNMENT ? DIRECT_ALIGNMENT : buffer_size;
+        m_buffer_size = (size + DIRECT_ALIGNMENT - 1) & ~(DIRECT_ALIGNMENT - 1);
+    }
+#endif
+}
+
+auto posix_file_stream::reserve_buffer() -> void {
+    if(m_buffer) return;
+    m_buffer = buffer(m_buffer_size, m_direct ? DIRECT_ALIGNMENT : alignof(u64), m_alloc);
+}
+
+auto posix_file_stream::fill(const u64& offset) -> error {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    reserve_buffer();
+    m_buffer_offset = m_direct ? offset & ~(DIRECT_ALIGNMENT - 1) : offset;
+    m_buffer_length = 0;
+    const value_or_error<u64> res = pread_all(m_fd, m_buffer.data(), m_buffer_size, m_buffer_offset);
+    if(!res) return res.error();
+    m_buffer_length = res.value();
+    return error::NO_ERROR;
+#else
+    return error::INVALID_OPERATION;
+#endif
+}
+
+auto posix_file_stream::read(void* dst, const u64& len) -> value_or_error<u64> {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    if(!*this || m_mode == file_mode::write) return error::INVALID_OPERATION;
+    if(m_dirty) {
+        const error err = flush();
+        if(err != error::NO_ERROR) return err;
+    }
+    u8* out = static_cast<u8*>(dst);
+    u64 total = 0;
+    while(total < len && m_position < m_size) {
+        if(m_position >= m_buffer_offset && m_position < m_buffer_offset + m_buffer_length) {
+            const u64 available = m_buffer_offset + m_buffer_length - m_position;
+            const u64 count = available < len - total ? available : len - total;
+            memcpy(out + total, static_cast<u8*>(m_buffer.data()) + (m_position - m_buffer_offset), count);
+            total += count;
+            m_position += count;
+            continue;
+        }
+        // Big reads, or reads of the rest of the file, go straight into dst
+        // unless O_DIRECT's alignment rules forbid it
+        const u64 left = m_size - m_position;
+        const u64 in_file = left < len - total ? left : len - total;
+        const bool aligned = (reinterpret_cast<u64>(out + total) | m_position) % DIRECT_ALIGNMENT == 0;
+        const u64 count = m_direct ? in_file & ~(DIRECT_ALIGNMENT - 1) : in_file;
+        const bool bypass = m_direct ? aligned && count >= m_buffer_size : count >= m_buffer_size || count == left;
+        if(bypass && count) {
+            const value_or_error<u64> res = pread_all(m_fd, out + total, count, m_position);
+            if(!res) return res.error();
+            total += res.value();
+            m_position += res.value();
+            if(res.value() < count) break;
+            continue;
+        }
+        const error err = fill(m_position);
+        if(err != error::NO_ERROR) return err;
+        if(m_position >= m_buffer_offset + m_buffer_length) break;
+    }
+    return total;
+#else
+    return error::INVALID_OPERATION;
+#endif
+}
+
+auto posix_file_stream::write(const void* src, const u64& len) -> value_or_error<u64> {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    if(!*this || m_mode == file_mode::read || m_mode == file_mode::direct_read) return error::INVALID_OPERATION;
+    if(!m_dirty || m_position != m_buffer_offset + m_buffer_length) {
+        // Drops read ahead too, the write may land on top of it
+        const error err = flush();
+        if(err != error::NO_ERROR) return err;
+        m_buffer_offset = m_position;
+        m_buffer_length = 0;
+    }
+    if(m_buffer_length + len > m_buffer_size) {
+        const error err = flush();
+        if(err != error::NO_ERROR) return err;
+        m_buffer_offset = m_position;
+    }
+    if(len >= m_buffer_size) {
+        const error err = pwrite_all(m_fd, src, len, m_position);
+        if(err != error::NO_ERROR) return err;
+    } else {
+        reserve_buffer();
+        memcpy(static_cast<u8*>(m_buffer.data()) + m_buffer_length, src, len);
+        m_buffer_length += len;
+        m_dirty = true;
+    }
+    m_position += len;
+    if(m_position > m_size) m_size = m_position;
+    return len;
+#else
+    return error::INVALID_OPERATION;
+#endif
+}
+
+static inline auto total_size(const array_slice<buffer_slice>& buffers) -> u64 {
+    u64 total = 0;
+    for(u64 i = 0; i < buffers.size(); i++) {
+        total += buffers[i].size();
+    }
+    return total;
+}
+
+auto posix_file_stream::readv(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    if(!*this || m_mode == file_mode::write) return error::INVALID_OPERATION;
+    // Small reads are better served from the buffer and O_DIRECT needs every slice aligned
+    if(m_direct || total_size(buffers) < m_buffer_size) return stream::readv(buffers);
+    if(m_dirty) {
+        const error err = flush();
+        if(err != error::NO_ERROR) return err;
+    }
+    iovec iov[vectored_io::MAX_IOVECS];
+    u64 total = 0;
+    for(u64 first = 0; first < buffers.size(); first += vectored_io::MAX_IOVECS) {
+        u64 count = 0;
+        u64 requested = 0;
+        for(u64 i = first; i < buffers.size() && count < vectored_io::MAX_IOVECS; i++) {
+            iov[count++] = vectored_io::to_iovec(buffers[i]);
+            requested += buffers[i].size();
+        }
+        const value_or_error<u64> res = vectored_io::read_all(m_fd, iov, static_cast<int>(count), m_position);
+        if(!res) return res;
+        total += res.value();
+        m_position += res.value();
+        if(res.value() < requested) break;
+    }
+    return total;
+#else
+    return error::INVALID_OPERATION;
+#endif
+}
+
+auto posix_file_stream::writev(const array_slice<buffer_slice>& buffers) -> value_or_error<u64> {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    if(!*this || m_mode == file_mode::read || m_mode == file_mode::direct_read) return error::INVALID_OPERATION;
+    const u64 total = total_size(buffers);
+    if(total < m_buffer_size) return stream::writev(buffers);
+    if(m_dirty && m_position != m_buffer_offset + m_buffer_length) {
+        const error err = flush();
+        if(err != error::NO_ERROR) return err;
+    }
+
+    // Pending writes that end where the slices start go out in the same syscall
+    iovec iov[vectored_io::MAX_IOVECS];
+    u64 count = 0;
+    u64 offset = m_position;
+    u64 batch = 0;
+    if(m_dirty) {
+        iov[count++] = iovec{m_buffer.data(), m_buffer_length};
+        offset = m_buffer_offset;
+        batch = m_buffer_length;
+    }
+    for(u64 i = 0; i < buffers.size(); i++) {
+        if(count == vectored_io::MAX_IOVECS) {
+            const error err = vectored_io::write_all(m_fd, iov, static_cast<int>(count), offset);
+            if(err != error::NO_ERROR) return err;
+            offset += batch;
+            batch = 0;
+            count = 0;
+        }
+        iov[count++] = vectored_io::to_iovec(buffers[i]);
+        batch += buffers[i].size();
+    }
+    const error err = vectored_io::write_all(m_fd, iov, static_cast<int>(count), offset);
+    if(err != error::NO_ERROR) return err;
+    // Also drops read ahead the slices may have landed on
+    m_dirty = false;
+    m_buffer_length = 0;
+    m_position += total;
+    if(m_position > m_size) m_size = m_position;
+    return total;
+#else
+    return error::INVALID_OPERATION;
+#endif
+}
+
+auto posix_file_stream::flush() -> error {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    if(m_dirty) {
+        const error err = pwrite_all(m_fd, m_buffer.data(), m_buffer_length, m_buffer_offset);
+        if(err != error::NO_ERROR) return err;
+        m_dirty = false;
+    }
+    m_buffer_length = 0;
+    return error::NO_ERROR;
+#else
+    return error::INVALID_OPERATION;
+#endif
+}
+
+auto posix_file_stream::seek(const i64& offset, const relative_to& relative_to) -> error {
+    if(!*this) return error::INVALID_OPERATION;
+    i64 base = 0;
+    switch(relative_to) {
+        case relative_to::start:
+            base = 0;
+            break;
+        case relative_to::current_position:
+            base = m_position;
+            break;
+        case relative_to::end:
+            base = m_size;
+            break;
+    }
+    if(base + offset < 0) return error::INVALID_OPERATION;
+    m_position = base + offset;
+    return error::NO_ERROR;
+}
+
+auto posix_file_stream::tell(const relative_to& relative_to) const -> value_or_error<i64> {
+    if(!*this) return error::INVALID_OPERATION;
+    switch(relative_to) {
+        case relative_to::start:
+            return static_cast<i64>(m_position);
+        case relative_to::current_position:
+            return 0;
+        case relative_to::end:
+            return static_cast<i64>(m_size) - static_cast<i64>(m_position);
+    }
+    return error::INVALID_OPERATION;
+}
+
+posix_file_stream::~posix_file_stream() {
+#if defined(ROOT_LINUX) || defined(ROOT_ANDROID)
+    if(m_fd >= 0) {
+        flush();
+        close(m_fd);
+    }
+#endif
+}
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/async_logger.h>
+#include <root/memory/system_allocator.h>
+#include <root/memory/test/mock_allocator.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace root::literals;
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+class async_logger_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        ON_CALL(alloc, malloc(_, _)).WillByDefault(Invoke([this](const root::u64& bytes, const root::u64& alignment) {
+            mallocs++;
+            if(std::this_thread::get_id() == logging_thread) logging_thread_mallocs++;
+            return root::system_allocator::universal_instance.malloc(bytes, alignment);
+        }));
+        ON_CALL(alloc, free(_)).WillByDefault(Invoke([this](void* mem) {
+            frees++;
+            root::system_allocator::universal_instance.free(mem);
+        }));
+    }
+
+    auto text() const -> std::string {
+        return std::string(static_cast<const char*>(out.data()), out.size());
+    }
+
+    auto lines() const -> std::vector<std::string> {
+        std::vector<std::string> result;
+        std::istringstream stream(text());
+        std::string line;
+        while(std::getline(stream, line)) {
+            result.push_back(line);
+        }
+        return result;
+    }
+
+    NiceMock<root::mock_allocator> alloc;
+    std::atomic<root::u64> mallocs = 0;
+    std::atomic<root::u64> frees = 0;
+    std::atomic<root::u64> logging_thread_mallocs = 0;
+    std::atomic<std::thread::id> logging_thread;
+    root::dynamic_buffer_stream out;
+    root::writer out_writer = root::writer(&out);
+};
+
+TEST_F(async_logger_tests, formats_like_the_platform_logger) {
+    root::async_logger logger(&out_writer);
+    {
+        // Strings are copied, they don't need to outlive the call
+        std::string name = "swapchain";
+        logger.i("vk", "Recreating {} at {}x{}"_fmt, root::string_view(name.data(), 0, name.size()), 1920, 1080);
+        name = "overwritten";
+    }
+    logger.d("", "no tag, {} and {}"_fmt, true, static_cast<root::u8>(7));
+    logger.w("jobs", "{x} {04X} {b}"_fmt, 255u, 171, 5);
+    logger.e("device", "{} {.2f} {}"_fmt, "c string", 3.14159, 0.1f);
+    char mutable_text[] = "mutable";
+    logger.i("tag", "{}!"_fmt, static_cast<char*>(mutable_text));
+    logger.flush();
+    EXPECT_EQ(text(), "INFO: vk: Recreating swapchain at 1920x1080\n"
+                      "DEBUG: no tag, true and 7\n"
+                      "WARN: jobs: ff 00AB 101\n"
+                      "ERROR: device: c string 3.14 0.1\n"
+                      "INFO: tag: mutable!\n");
+}
+
+TEST_F(async_logger_tests, keeps_each_threads_order) {
+    constexpr root::u64 THREADS = 4;
+    constexpr root::u64 MESSAGES = 2000;
+    root::async_logger logger(&out_writer, 1024 * 1024);
+    std::vector<std::thread> threads;
+    for(root::u64 t = 0; t < THREADS; t++) {
+        threads.emplace_back([&logger, t]() {
+            for(root::u64 i = 0; i < MESSAGES; i++) {
+                logger.i("t", "{} {}"_fmt, t, i);
+            }
+        });
+    }
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+
+    root::u64 next[THREADS] = {};
+    const std::vector<std::string> written = lines();
+    ASSERT_EQ(written.size(), THREADS * MESSAGES);
+    for(const std::string& line : written) {
+        root::u64 t, i;
+        ASSERT_EQ(sscanf(line.c_str(), "INFO: t: %llu %llu", &t, &i), 2) << line;
+        ASSERT_LT(t, THREADS);
+        EXPECT_EQ(i, next[t]++);
+    }
+}
+
+TEST_F(async_logger_tests, full_ring_drops_and_reports) {
+    constexpr root::u64 MESSAGES = 1000;
+    root::async_logger logger(&out_writer, 1024);
+    for(root::u64 i = 0; i < MESSAGES; i++) {
+        logger.i("overflow", "message {}"_fmt, i);
+    }
+    logger.flush();
+
+    root::u64 logged = 0;
+    root::u64 dropped = 0;
+    for(const std::string& line : lines()) {
+        root::u64 count;
+        if(sscanf(line.c_str(), "WARN: async_logger: %llu messages dropped", &count) == 1) {
+            dropped += count;
+        } else {
+            logged++;
+        }
+    }
+    EXPECT_GT(dropped, 0);
+    EXPECT_EQ(logged + dropped, MESSAGES);
+
+    // There's room again once drained
+    logger.i("overflow", "after"_fmt);
+    logger.flush();
+    EXPECT_EQ(lines().back(), "INFO: overflow: after");
+}
+
+TEST_F(async_logger_tests, writes_and_frees_rings_of_exited_threads) {
+    {
+        root::async_logger logger(&out_writer, root::async_logger::DEFAULT_RING_CAPACITY, &alloc);
+        std::thread thread([&logger]() {
+            logger.i("thread", "exiting"_fmt);
+        });
+        thread.join();
+        logger.flush();
+        EXPECT_EQ(text(), "INFO: thread: exiting\n");
+        logger.flush();
+    }
+    EXPECT_EQ(mallocs, frees);
+}
+
+TEST_F(async_logger_tests, only_first_message_allocates) {
+    root::async_logger logger(&out_writer, root::async_logger::DEFAULT_RING_CAPACITY, &alloc);
+    // On its own thread, whose ring is freed on exit while alloc is still alive
+    std::thread thread([this, &logger]() {
+        logging_thread = std::this_thread::get_id();
+        logger.i("alloc", "first"_fmt);
+        const root::u64 after_first = logging_thread_mallocs;
+        for(int i = 0; i < 100; i++) {
+            logger.i("alloc", "{} {} {}"_fmt, i, "text", 1.5);
+        }
+        EXPECT_EQ(logging_thread_mallocs, after_first);
+    });
+    thread.join();
+    logger.flush();
+    EXPECT_EQ(lines().size(), 101);
+}
\ No newline at end of file
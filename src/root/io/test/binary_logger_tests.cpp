@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/binary_log_decoder.h>
+#include <root/io/binary_logger.h>
+#include <root/io/log.h>
+#include <root/io/mapped_buffer.h>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace root::literals;
+
+struct test_point {
+    int m_x;
+    int m_y;
+    // Not trivially copyable, so it is formatted while logging
+    ~test_point() {}
+};
+
+template<>
+auto root::strlen<test_point>(const test_point& object, const string_view&) -> u64 {
+    return 4 + strlen(object.m_x) + strlen(object.m_y);
+}
+
+template<>
+auto root::format_to<test_point>(buffer_writer& dst, const test_point& object, const string_view&) -> void {
+    format_to(dst, "({}, {})"_fmt, object.m_x, object.m_y);
+}
+
+class binary_logger_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        strcpy(file_path, "/tmp/root_binary_log_XXXXXX");
+        int fd = mkstemp(file_path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+    }
+
+    void TearDown() override {
+        unlink(file_path);
+    }
+
+    auto path() const -> root::string_view {
+        return root::string_view(file_path, 0, strlen(file_path));
+    }
+
+    auto decode() const -> std::string {
+        root::mapped_buffer mapped(path());
+        root::dynamic_buffer_stream out;
+        root::writer out_writer(&out);
+        EXPECT_EQ(root::binary_log::decode(mapped.data(), mapped.size(), out_writer), root::error::NO_ERROR);
+        return std::string(static_cast<const char*>(out.data()), out.size());
+    }
+
+    /**
+     * Decoded lines without their timestamps.
+     */
+    auto messages() const -> std::vector<std::string> {
+        std::vector<std::string> result;
+        std::istringstream stream(decode());
+        std::string line;
+        while(std::getline(stream, line)) {
+            result.push_back(line.substr(line.find(' ') + 1));
+        }
+        return result;
+    }
+
+    char file_path[64];
+};
+
+TEST_F(binary_logger_tests, decodes_every_argument_type) {
+    root::binary_logger logger(path());
+    ASSERT_TRUE(logger);
+    {
+        // Strings are copied, they don't need to outlive the call
+        std::string name = "swapchain";
+        logger.i("vk", "Recreating {} at {}x{}"_fmt, root::string_view(name.data(), 0, name.size()), 1920u, 1080);
+        name = "overwritten";
+    }
+    logger.d("", "no tag, {} {} {}"_fmt, true, static_cast<root::i16>(-7), static_cast<root::u16>(7));
+    logger.w("jobs", "{x} {04X} {b} {}"_fmt, static_cast<root::u8>(255), 171ll, 5ull, 'c');
+    logger.e("device", "{} {.2f} {} {e}"_fmt, "c string", 3.14159, 0.1f, 1234.5);
+    logger.i("point", "{} at {}"_fmt, test_point{3, -4}, static_cast<void*>(nullptr));
+    logger.i("tag", "no arguments"_fmt);
+
+    std::vector<std::string> expected = {"INFO: vk: Recreating swapchain at 1920x1080",
+                                         "DEBUG: no tag, true -7 7",
+                                         "WARN: jobs: ff 00AB 101 c",
+                                         "ERROR: device: c string 3.14 0.1 1.2345e+03",
+                                         "INFO: point: (3, -4) at 0",
+                                         "INFO: tag: no arguments"};
+    EXPECT_EQ(messages(), expected);
+}
+
+TEST_F(binary_logger_tests, timestamps_are_seconds_since_start) {
+    root::binary_logger logger(path());
+    logger.i("t", "first"_fmt);
+    logger.i("t", "second"_fmt);
+    std::istringstream stream(decode());
+    double previous = -1.0;
+    std::string line;
+    while(std::getline(stream, line)) {
+        const std::string seconds = line.substr(0, line.find(' '));
+        // Nanoseconds are zero padded
+        EXPECT_EQ(seconds.size() - seconds.find('.'), 10);
+        const double time = atof(seconds.c_str());
+        EXPECT_GE(time, previous);
+        EXPECT_LT(time, 60.0);
+        previous = time;
+    }
+}
+
+TEST_F(binary_logger_tests, keeps_newest_records_after_wrapping) {
+    constexpr int MESSAGES = 10000;
+    // Rounded up to two blocks, far less than the messages need
+    root::binary_logger logger(path(), 1);
+    for(int i = 0; i < MESSAGES; i++) {
+        logger.i("wrap", "message {}"_fmt, i);
+    }
+    const std::vector<std::string> written = messages();
+    ASSERT_GT(written.size(), 100);
+    ASSERT_LT(written.size(), MESSAGES);
+    int first;
+    ASSERT_EQ(sscanf(written[0].c_str(), "INFO: wrap: message %d", &first), 1);
+    for(root::u64 i = 0; i < written.size(); i++) {
+        EXPECT_EQ(written[i], "INFO: wrap: message " + std::to_string(first + i));
+    }
+    EXPECT_EQ(written.back(), "INFO: wrap: message " + std::to_string(MESSAGES - 1));
+}
+
+TEST_F(binary_logger_tests, skips_incomplete_records) {
+    {
+        root::binary_logger logger(path());
+        logger.i("crash", "complete"_fmt);
+        logger.i("crash", "interrupted {}"_fmt, 1);
+    }
+    // Make the second record look half written: its position is set last
+    root::binary_log_format::header header;
+    FILE* file = fopen(file_path, "r+b");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(fread(&header, sizeof(header), 1, file), 1);
+    root::u32 first_size;
+    fseek(file, header.m_ring_offset, SEEK_SET);
+    ASSERT_EQ(fread(&first_size, sizeof(first_size), 1, file), 1);
+    const root::u64 stale_position = 12345;
+    fseek(file, header.m_ring_offset + first_size + offsetof(root::binary_log_format::record, m_position), SEEK_SET);
+    ASSERT_EQ(fwrite(&stale_position, sizeof(stale_position), 1, file), 1);
+    fclose(file);
+
+    EXPECT_EQ(messages(), std::vector<std::string>{"INFO: crash: complete"});
+}
+
+TEST_F(binary_logger_tests, threads_log_concurrently) {
+    constexpr root::u64 THREADS = 4;
+    constexpr root::u64 MESSAGES = 2000;
+    root::binary_logger logger(path(), 1024 * 1024);
+    std::vector<std::thread> threads;
+    for(root::u64 t = 0; t < THREADS; t++) {
+        threads.emplace_back([&logger, t]() {
+            for(root::u64 i = 0; i < MESSAGES; i++) {
+                logger.i("t", "{} {}"_fmt, t, i);
+            }
+        });
+    }
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+
+    root::u64 next[THREADS] = {};
+    const std::vector<std::string> written = messages();
+    ASSERT_EQ(written.size(), THREADS * MESSAGES);
+    for(const std::string& line : written) {
+        root::u64 t, i;
+        ASSERT_EQ(sscanf(line.c_str(), "INFO: t: %llu %llu", &t, &i), 2) << line;
+        ASSERT_LT(t, THREADS);
+        EXPECT_EQ(i, next[t]++);
+    }
+}
+
+TEST_F(binary_logger_tests, root_log_writes_through_it) {
+    root::binary_logger logger(path());
+    root::log::set_binary_logger(&logger);
+    root::log::w("log", "through {}"_fmt, "root::log");
+    root_log_e("log", "and the {}"_fmt, "macro");
+    root::log::set_binary_logger(nullptr);
+    EXPECT_EQ(messages(), (std::vector<std::string>{"WARN: log: through root::log", "ERROR: log: and the macro"}));
+}
+
+TEST_F(binary_logger_tests, rejects_other_files) {
+    char garbage[8192];
+    for(root::u64 i = 0; i < sizeof(garbage); i++) {
+        garbage[i] = static_cast<char>(i * 131 + 7);
+    }
+    root::dynamic_buffer_stream out;
+    root::writer out_writer(&out);
+    EXPECT_EQ(root::binary_log::decode(garbage, sizeof(garbage), out_writer), root::error::INVALID_OPERATION);
+    EXPECT_EQ(root::binary_log::decode(garbage, 16, out_writer), root::error::INVALID_OPERATION);
+
+    // A sound header with a dictionary id past what any writer gives out
+    {
+        root::binary_logger logger(path());
+        logger.i("t", "some {}"_fmt, 1);
+    }
+    root::mapped_buffer mapped(path());
+    std::vector<root::u8> corrupt(static_cast<const root::u8*>(mapped.data()), static_cast<const root::u8*>(mapped.data()) + mapped.size());
+    const root::binary_log_format::header* h = reinterpret_cast<const root::binary_log_format::header*>(corrupt.data());
+    const root::u32 id = 0xFFFFFFFF;
+    memcpy(corrupt.data() + h->m_dictionary_offset + offsetof(root::binary_log_format::format_entry, m_id), &id, sizeof(id));
+    EXPECT_EQ(root::binary_log::decode(corrupt.data(), corrupt.size(), out_writer), root::error::INVALID_OPERATION);
+    EXPECT_EQ(out.size(), 0);
+}
\ No newline at end of file
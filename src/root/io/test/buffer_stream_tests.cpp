@@ -223,4 +223,40 @@ TEST_F(buffer_stream_tests, read_too_far) {
     EXPECT_EQ(stream.tell(), BUFFER_SIZE);
     EXPECT_EQ(stream.tell(root::relative_to::current_position), 0);
     EXPECT_EQ(stream.tell(root::relative_to::end), 0);
+}
+
+TEST_F(buffer_stream_tests, writev) {
+    char first[100];
+    char second[200];
+    memset(first, 'a', sizeof(first));
+    memset(second, 'b', sizeof(second));
+    root::buffer_slice slices[] = {root::buffer_slice(first, 0, sizeof(first)),
+                                   root::buffer_slice(second, 0, sizeof(second)),
+                                   root::buffer_slice(first, 0, sizeof(first))};
+
+    EXPECT_EQ(stream.writev(slices), 400);
+    EXPECT_EQ(stream.tell(), 400);
+    EXPECT_EQ(memcmp(buffer, first, 100), 0);
+    EXPECT_EQ(memcmp(buffer + 100, second, 200), 0);
+    EXPECT_EQ(memcmp(buffer + 300, first, 100), 0);
+
+    // Stops short at the end of the buffer
+    EXPECT_EQ(stream.writev(slices), BUFFER_SIZE - 400);
+    EXPECT_EQ(stream.tell(root::relative_to::end), 0);
+}
+
+TEST_F(buffer_stream_tests, readv) {
+    char* data = static_cast<char*>(buffer.data());
+    for(int i = 0; i < BUFFER_SIZE; i++) {
+        data[i] = static_cast<char>(rand());
+    }
+    char first[10];
+    char second[BUFFER_SIZE];
+    root::buffer_slice slices[] = {root::buffer_slice(first, 0, sizeof(first)),
+                                   root::buffer_slice(second, 0, sizeof(second))};
+
+    EXPECT_EQ(stream.readv(slices), BUFFER_SIZE);
+    EXPECT_EQ(memcmp(first, data, sizeof(first)), 0);
+    EXPECT_EQ(memcmp(second, data + sizeof(first), BUFFER_SIZE - sizeof(first)), 0);
+    EXPECT_EQ(stream.readv(slices), 0);
 }
\ No newline at end of file
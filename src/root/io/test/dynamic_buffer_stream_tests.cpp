@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/dynamic_buffer_stream.h>
+#include <root/memory/system_allocator.h>
+#include <root/memory/test/mock_allocator.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdlib>
+#include <cstring>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+class dynamic_buffer_stream_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        ON_CALL(alloc, malloc(_, _)).WillByDefault(Invoke([this](const root::u64& bytes, const root::u64& alignment) {
+            mallocs++;
+            return root::system_allocator::universal_instance.malloc(bytes, alignment);
+        }));
+        ON_CALL(alloc, free(_)).WillByDefault(Invoke([this](void* mem) {
+            frees++;
+            root::system_allocator::universal_instance.free(mem);
+        }));
+        for(root::u64 i = 0; i < DATA_SIZE; i++) {
+            data[i] = static_cast<char>(rand());
+        }
+    }
+
+    static constexpr root::u64 DATA_SIZE = 64 * 1024;
+    NiceMock<root::mock_allocator> alloc;
+    root::u64 mallocs = 0;
+    root::u64 frees = 0;
+    char data[DATA_SIZE];
+};
+
+TEST_F(dynamic_buffer_stream_tests, small_output_stays_inline) {
+    root::dynamic_buffer_stream stream(&alloc);
+    EXPECT_EQ(stream.write(data, root::dynamic_buffer_stream::INLINE_CAPACITY), root::dynamic_buffer_stream::INLINE_CAPACITY);
+    EXPECT_EQ(stream.size(), root::dynamic_buffer_stream::INLINE_CAPACITY);
+    EXPECT_EQ(memcmp(stream.data(), data, stream.size()), 0);
+    EXPECT_EQ(mallocs, 0);
+}
+
+TEST_F(dynamic_buffer_stream_tests, grows_geometrically) {
+    {
+        root::dynamic_buffer_stream stream(&alloc);
+        for(root::u64 i = 0; i < DATA_SIZE; i++) {
+            EXPECT_EQ(stream.write(data + i, 1), 1);
+        }
+        EXPECT_EQ(stream.size(), DATA_SIZE);
+        EXPECT_EQ(stream.capacity(), DATA_SIZE);
+        EXPECT_EQ(memcmp(stream.data(), data, DATA_SIZE), 0);
+        // 512, 1K, ... 64K
+        EXPECT_EQ(mallocs, 8);
+        EXPECT_EQ(frees, 7);
+    }
+    EXPECT_EQ(frees, mallocs);
+}
+
+TEST_F(dynamic_buffer_stream_tests, reserve) {
+    root::dynamic_buffer_stream stream(&alloc);
+    EXPECT_EQ(stream.reserve(DATA_SIZE), root::error::NO_ERROR);
+    EXPECT_EQ(mallocs, 1);
+    EXPECT_EQ(stream.write(data, DATA_SIZE), DATA_SIZE);
+    EXPECT_EQ(mallocs, 1);
+}
+
+TEST_F(dynamic_buffer_stream_tests, seek_read_and_overwrite) {
+    root::dynamic_buffer_stream stream(&alloc);
+    EXPECT_EQ(stream.write(data, 1000), 1000);
+    EXPECT_EQ(stream.tell(), 1000);
+    EXPECT_EQ(stream.tell(root::relative_to::end), 0);
+
+    EXPECT_EQ(stream.seek(-100, root::relative_to::end), root::error::NO_ERROR);
+    EXPECT_EQ(stream.tell(root::relative_to::end), -100);
+    char out[200];
+    EXPECT_EQ(stream.read(out, sizeof(out)), 100);
+    EXPECT_EQ(memcmp(out, data + 900, 100), 0);
+
+    EXPECT_EQ(stream.seek(10), root::error::NO_ERROR);
+    EXPECT_EQ(stream.write("root", 4), 4);
+    EXPECT_EQ(stream.size(), 1000);
+    EXPECT_EQ(memcmp(static_cast<const char*>(stream.data()) + 10, "root", 4), 0);
+
+    EXPECT_EQ(stream.seek(-1), root::error::INVALID_OPERATION);
+}
+
+TEST_F(dynamic_buffer_stream_tests, write_past_end_zero_fills) {
+    root::dynamic_buffer_stream stream(&alloc);
+    EXPECT_EQ(stream.write("a", 1), 1);
+    EXPECT_EQ(stream.seek(1000), root::error::NO_ERROR);
+    EXPECT_EQ(stream.write("b", 1), 1);
+    EXPECT_EQ(stream.size(), 1001);
+    const char* contents = static_cast<const char*>(stream.data());
+    EXPECT_EQ(contents[0], 'a');
+    for(root::u64 i = 1; i < 1000; i++) {
+        EXPECT_EQ(contents[i], 0);
+    }
+    EXPECT_EQ(contents[1000], 'b');
+}
+
+TEST_F(dynamic_buffer_stream_tests, writev_grows_once) {
+    root::dynamic_buffer_stream stream(&alloc);
+    root::buffer_slice slices[] = {root::buffer_slice(data, 0, 1000), root::buffer_slice(data, 1000, 5000)};
+    EXPECT_EQ(stream.writev(slices), 5000);
+    EXPECT_EQ(mallocs, 1);
+    EXPECT_EQ(memcmp(stream.data(), data, 5000), 0);
+}
+
+TEST_F(dynamic_buffer_stream_tests, to_buffer) {
+    root::dynamic_buffer_stream stream(&alloc);
+    EXPECT_EQ(stream.write(data, 100), 100);
+    {
+        EXPECT_CALL(alloc, malloc(100, alignof(root::u8))).Times(1);
+        root::buffer copy = stream.to_buffer();
+        EXPECT_EQ(copy.size(), 100);
+        EXPECT_EQ(memcmp(copy.data(), data, 100), 0);
+    }
+    EXPECT_EQ(frees, 1);
+}
+
+TEST_F(dynamic_buffer_stream_tests, move) {
+    root::dynamic_buffer_stream small(&alloc);
+    EXPECT_EQ(small.write(data, 10), 10);
+    root::dynamic_buffer_stream moved_small(std::move(small));
+    EXPECT_EQ(moved_small.size(), 10);
+    EXPECT_EQ(memcmp(moved_small.data(), data, 10), 0);
+    EXPECT_EQ(small.size(), 0);
+
+    root::dynamic_buffer_stream large(&alloc);
+    EXPECT_EQ(large.write(data, DATA_SIZE), DATA_SIZE);
+    const void* storage = large.data();
+    root::dynamic_buffer_stream moved_large(std::move(large));
+    EXPECT_EQ(moved_large.data(), storage);
+    EXPECT_EQ(memcmp(moved_large.data(), data, DATA_SIZE), 0);
+    EXPECT_EQ(mallocs, 1);
+}
\ No newline at end of file
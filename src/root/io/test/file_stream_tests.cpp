@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/file_stream.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+class file_stream_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        strcpy(file_path, "/tmp/root_file_stream_XXXXXX");
+        int fd = mkstemp(file_path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        file = fopen(file_path, "w+b");
+        ASSERT_NE(file, nullptr);
+    }
+
+    void TearDown() override {
+        fclose(file);
+        unlink(file_path);
+    }
+
+    char file_path[64];
+    FILE* file;
+};
+
+TEST_F(file_stream_tests, writev_after_buffered_write) {
+    root::file_stream stream(file);
+    // Still sitting in stdio's buffer when writev runs
+    EXPECT_EQ(stream.write("INFO: ", 6), 6);
+    char tag[] = "tag: ";
+    char body[] = "body\n";
+    root::buffer_slice slices[] = {root::buffer_slice(tag, 0, 5), root::buffer_slice(body, 0, 5)};
+    EXPECT_EQ(stream.writev(slices), 10);
+    EXPECT_EQ(stream.tell(), 16);
+
+    // stdio carries on from where writev left the file
+    EXPECT_EQ(stream.write("end", 3), 3);
+    EXPECT_EQ(stream.seek(0), root::error::NO_ERROR);
+    char data[32] = {};
+    EXPECT_EQ(stream.read(data, sizeof(data)), 19);
+    EXPECT_STREQ(data, "INFO: tag: body\nend");
+}
+
+TEST_F(file_stream_tests, readv) {
+    EXPECT_EQ(fwrite("headerpayload", 1, 13, file), 13);
+    EXPECT_EQ(fseek(file, 0, SEEK_SET), 0);
+    root::file_stream stream(file);
+    char header[6];
+    char payload[16] = {};
+    root::buffer_slice slices[] = {root::buffer_slice(header, 0, sizeof(header)), root::buffer_slice(payload, 0, sizeof(payload))};
+    EXPECT_EQ(stream.readv(slices), 13);
+    EXPECT_EQ(memcmp(header, "header", 6), 0);
+    EXPECT_STREQ(payload, "payload");
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/float_format.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+using root::float_format::style;
+
+template<typename T>
+static inline auto to_chars(const T& value, const style& s = style::general,
+                            const root::i32& precision = root::float_format::SHORTEST) -> std::string {
+    char text[root::float_format::MAX_CHARS];
+    const root::u64 length = root::float_format::to_chars(text, value, s, precision);
+    return std::string(text, length);
+}
+
+/**
+ * Significant digits of a float printed in scientific style.
+ */
+static inline auto significant_digits(const std::string& text) -> root::u64 {
+    const std::string mantissa = text.substr(0, text.find('e'));
+    std::string digits;
+    for(const char& c : mantissa) {
+        if(c >= '0' && c <= '9') digits += c;
+    }
+    const root::u64 first = digits.find_first_not_of('0');
+    const root::u64 last = digits.find_last_not_of('0');
+    return first == std::string::npos ? 1 : last - first + 1;
+}
+
+TEST(float_format_tests, shortest_known_values) {
+    EXPECT_EQ(to_chars(0.0), "0");
+    EXPECT_EQ(to_chars(-0.0), "-0");
+    EXPECT_EQ(to_chars(1.0), "1");
+    EXPECT_EQ(to_chars(0.1), "0.1");
+    EXPECT_EQ(to_chars(0.3), "0.3");
+    EXPECT_EQ(to_chars(0.1 + 0.2), "0.30000000000000004");
+    EXPECT_EQ(to_chars(100.0), "100");
+    EXPECT_EQ(to_chars(123.456), "123.456");
+    EXPECT_EQ(to_chars(1e22), "1e+22");
+    EXPECT_EQ(to_chars(1e23), "1e+23");
+    EXPECT_EQ(to_chars(1e-5), "1e-05");
+    EXPECT_EQ(to_chars(0.001), "0.001");
+    EXPECT_EQ(to_chars(5e-324), "5e-324");
+    EXPECT_EQ(to_chars(2.2250738585072014e-308), "2.2250738585072014e-308");
+    EXPECT_EQ(to_chars(std::numeric_limits<root::f64>::max()), "1.7976931348623157e+308");
+    EXPECT_EQ(to_chars(9007199254740993.0), "9007199254740992");
+    EXPECT_EQ(to_chars(-1.5f), "-1.5");
+    EXPECT_EQ(to_chars(0.1f), "0.1");
+    EXPECT_EQ(to_chars(16777216.0f), "16777216");
+    EXPECT_EQ(to_chars(std::numeric_limits<root::f32>::max()), "3.4028235e+38");
+    EXPECT_EQ(to_chars(std::numeric_limits<root::f32>::denorm_min()), "1e-45");
+}
+
+TEST(float_format_tests, special_values) {
+    EXPECT_EQ(to_chars(std::numeric_limits<root::f64>::infinity()), "inf");
+    EXPECT_EQ(to_chars(-std::numeric_limits<root::f64>::infinity()), "-inf");
+    EXPECT_EQ(to_chars(std::numeric_limits<root::f64>::quiet_NaN()), "nan");
+    EXPECT_EQ(to_chars(-std::numeric_limits<root::f32>::infinity(), style::fixed, 3), "-inf");
+    EXPECT_EQ(to_chars(0.0, style::scientific), "0e+00");
+    EXPECT_EQ(to_chars(0.0, style::scientific, 2), "0.00e+00");
+    EXPECT_EQ(to_chars(-0.0, style::fixed, 2), "-0.00");
+}
+
+TEST(float_format_tests, shortest_styles) {
+    EXPECT_EQ(to_chars(1234.5, style::scientific), "1.2345e+03");
+    EXPECT_EQ(to_chars(1e-7, style::fixed), "0.0000001");
+    EXPECT_EQ(to_chars(1e21, style::fixed), "1000000000000000000000");
+    // Fixed integers past 2^53 print their exact value rather than padding with zeros
+    EXPECT_EQ(to_chars(1e23, style::fixed), "99999999999999991611392");
+    EXPECT_EQ(to_chars(123456789012345680000.0), "123456789012345683968");
+}
+
+TEST(float_format_tests, shortest_round_trips) {
+    std::mt19937_64 random(1234);
+    for(int i = 0; i < 10000; i++) {
+        const root::u64 bits = random();
+        root::f64 value;
+        memcpy(&value, &bits, sizeof(value));
+        if(!std::isfinite(value)) continue;
+        const std::string text = to_chars(value);
+        EXPECT_EQ(strtod(text.c_str(), nullptr), value) << text;
+
+        // One digit fewer doesn't read back. Skipped on powers of two, where
+        // the interval that rounds to value is lopsided
+        const root::u64 digits = significant_digits(to_chars(value, style::scientific));
+        if(digits > 1 && (bits & ((1ull << 52) - 1))) {
+            char shorter[64];
+            snprintf(shorter, sizeof(shorter), "%.*e", static_cast<int>(digits - 2), value);
+            EXPECT_NE(strtod(shorter, nullptr), value) << text;
+        }
+    }
+}
+
+TEST(float_format_tests, f32_shortest_round_trips) {
+    std::mt19937 random(1234);
+    for(int i = 0; i < 10000; i++) {
+        const root::u32 bits = random();
+        root::f32 value;
+        memcpy(&value, &bits, sizeof(value));
+        if(!std::isfinite(value)) continue;
+        const std::string text = to_chars(value);
+        EXPECT_EQ(strtof(text.c_str(), nullptr), value) << text;
+
+        const root::u64 digits = significant_digits(to_chars(value, style::scientific));
+        if(digits > 1 && (bits & ((1u << 23) - 1))) {
+            char shorter[64];
+            snprintf(shorter, sizeof(shorter), "%.*e", static_cast<int>(digits - 2), value);
+            EXPECT_NE(strtof(shorter, nullptr), value) << text;
+        }
+    }
+}
+
+TEST(float_format_tests, precision_matches_printf) {
+    std::mt19937_64 random(1234);
+    constexpr root::i32 PRECISIONS[] = {0, 1, 2, 3, 6, 10, 17, 25, 60, root::float_format::MAX_PRECISION};
+    char expected[root::float_format::MAX_CHARS];
+    for(int i = 0; i < 2000; i++) {
+        const root::u64 bits = random();
+        root::f64 value;
+        memcpy(&value, &bits, sizeof(value));
+        if(!std::isfinite(value)) continue;
+        // Mostly values of everyday magnitude, where the rounding is interesting
+        if(i % 2) value = std::ldexp(static_cast<root::f64>(bits >> 11), -53 + static_cast<int>(bits % 40) - 20);
+        for(const root::i32& precision : PRECISIONS) {
+            snprintf(expected, sizeof(expected), "%.*e", precision, value);
+            EXPECT_EQ(to_chars(value, style::scientific, precision), expected);
+            snprintf(expected, sizeof(expected), "%.*f", precision, value);
+            EXPECT_EQ(to_chars(value, style::fixed, precision), expected);
+        }
+    }
+}
+
+TEST(float_format_tests, precision_rounds_half_to_even) {
+    EXPECT_EQ(to_chars(0.5, style::fixed, 0), "0");
+    EXPECT_EQ(to_chars(1.5, style::fixed, 0), "2");
+    EXPECT_EQ(to_chars(0.125, style::fixed, 2), "0.12");
+    EXPECT_EQ(to_chars(0.375, style::fixed, 2), "0.38");
+    // 2.675 is really 2.67499999999999982236431605997495353221893310546875
+    EXPECT_EQ(to_chars(2.675, style::fixed, 2), "2.67");
+    EXPECT_EQ(to_chars(9.9999, style::fixed, 2), "10.00");
+    EXPECT_EQ(to_chars(9.9999, style::scientific, 2), "1.00e+01");
+    EXPECT_EQ(to_chars(1e-10, style::fixed, 3), "0.000");
+    EXPECT_EQ(to_chars(3.14159, style::general, 2), "3.14");
+    EXPECT_EQ(to_chars(1.0f / 3.0f, style::fixed, 10), "0.3333333433");
+    EXPECT_EQ(to_chars(5e-324, style::scientific, 3), "4.941e-324");
+    EXPECT_EQ(to_chars(1.0, style::fixed, 1000), to_chars(1.0, style::fixed, root::float_format::MAX_PRECISION));
+}
\ No newline at end of file
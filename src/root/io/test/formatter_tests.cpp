@@ -17,13 +17,14 @@
  * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <root/io/formatter.h>
+#include <root/io/format.h>
 #include <root/memory/test/mock_allocator.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include <limits>
+#include <string>
 #include <iostream> // TODO remove
 
 class formatter_tests : public ::testing::Test {
@@ -46,6 +47,7 @@ public:
 };
 
 using ::testing::Return;
+using namespace root::literals;
 
 template<typename T, const char* root_fmt_string, const char* c_fmt_string>
 auto int_format_test() -> void {
@@ -252,7 +254,7 @@ TEST_F(formatter_tests, f32_to_string) {
         char str_lit[MAX_STR_SIZE];
         sprintf(str_lit, "%1.5e", test);
         EXPECT_CALL(allocator, malloc(strlen(str_lit)+1, alignof(root::i8))).Times(1).WillOnce(Return(memory));
-        root::string str = formatter.to_string(test);
+        root::string str = formatter.format("{.5e}", test);
         EXPECT_EQ(memcmp(str, str_lit, strlen(str_lit)), 0);
         EXPECT_CALL(allocator, free(memory)).Times(1);
     }
@@ -264,22 +266,22 @@ TEST_F(formatter_tests, f32_to_string) {
         char str_lit[MAX_STR_SIZE];
         sprintf(str_lit, "%1.5e", test);
         EXPECT_CALL(allocator, malloc(strlen(str_lit)+1, alignof(root::i8))).Times(1).WillOnce(Return(memory));
-        root::string str = formatter.to_string(test);
+        root::string str = formatter.format("{.5e}", test);
         EXPECT_EQ(memcmp(str, str_lit, strlen(str_lit)), 0);
         EXPECT_CALL(allocator, free(memory)).Times(1);
     }
 
-    /*for (int _ = 0; _ < NUM_TESTS; _++) {
+    for (int _ = 0; _ < NUM_TESTS; _++) {
         constexpr root::f32 SCALE = 10.0f;
         root::f32 test = ((static_cast<root::f32>(rand()) /static_cast<root::f32>(RAND_MAX))
                           * SCALE) - (SCALE / 2);
         char str_lit[MAX_STR_SIZE];
         sprintf(str_lit, "%2.4f", test);
         EXPECT_CALL(allocator, malloc(strlen(str_lit)+1, alignof(root::i8))).Times(1).WillOnce(Return(memory));
-        root::string str = formatter.to_string(test);
+        root::string str = formatter.format("{.4f}", test);
         EXPECT_EQ(memcmp(str, str_lit, strlen(str_lit)), 0);
         EXPECT_CALL(allocator, free(memory)).Times(1);
-    }*/
+    }
 
     for (int _ = 0; _ < NUM_TESTS; _++) {
         constexpr root::f32 SCALE = 2.0f;
@@ -288,8 +290,175 @@ TEST_F(formatter_tests, f32_to_string) {
         char str_lit[MAX_STR_SIZE];
         sprintf(str_lit, "%1.5f", test);
         EXPECT_CALL(allocator, malloc(strlen(str_lit)+1, alignof(root::i8))).Times(1).WillOnce(Return(memory));
-        root::string str = formatter.to_string(test);
+        root::string str = formatter.format("{.5f}", test);
         EXPECT_EQ(memcmp(str, str_lit, strlen(str_lit)), 0);
         EXPECT_CALL(allocator, free(memory)).Times(1);
     }
+
+    // Without a precision, the shortest text that reads back as the same value
+    for (int _ = 0; _ < NUM_TESTS; _++) {
+        constexpr root::f32 SCALE = 1e15f;
+        root::f32 test = ((static_cast<root::f32>(rand()) /static_cast<root::f32>(RAND_MAX))
+                          * SCALE) - (SCALE / 2);
+        const root::u64 length = root::strlen(test);
+        EXPECT_CALL(allocator, malloc(length+1, alignof(root::i8))).Times(1).WillOnce(Return(memory));
+        root::string str = formatter.to_string(test);
+        EXPECT_EQ(strlen(str.data()), length);
+        EXPECT_EQ(strtof(str.data(), nullptr), test);
+        EXPECT_CALL(allocator, free(memory)).Times(1);
+    }
+}
+
+template<typename... Args>
+static inline auto formatted(const root::format_string& fmt, Args... args) -> std::string {
+    root::string str = root::format(fmt, args...);
+    return std::string(str.data());
+}
+
+static inline auto binary(root::u64 value) -> std::string {
+    std::string digits;
+    do {
+        digits.insert(digits.begin(), static_cast<char>('0' + (value & 1)));
+        value >>= 1;
+    } while(value);
+    return digits;
+}
+
+TEST(integer_format_tests, decimal_boundaries) {
+    char expected[32];
+    root::u64 power = 1;
+    for(int digits = 1; digits <= 20; digits++) {
+        for(const root::u64& value : {power - 1, power, power + 1}) {
+            snprintf(expected, sizeof(expected), "%llu", value);
+            EXPECT_EQ(formatted("{}", value), expected);
+            EXPECT_EQ(root::strlen(value), strlen(expected));
+        }
+        if(digits < 20) power *= 10;
+    }
+    EXPECT_EQ(formatted("{}", std::numeric_limits<root::u64>::max()), "18446744073709551615");
+}
+
+TEST(integer_format_tests, beyond_double_precision) {
+    char expected[32];
+    // Not representable as doubles, digit counting through log10 got these wrong
+    for(const root::u64& value : {(1ull << 53) + 1, 9999999999999999999ull, (1ull << 63) + 7, 12345678901234567891ull}) {
+        snprintf(expected, sizeof(expected), "%llu", value);
+        EXPECT_EQ(formatted("{}", value), expected);
+        EXPECT_EQ(root::strlen(value), strlen(expected));
+    }
+}
+
+TEST(integer_format_tests, power_of_two_boundaries) {
+    char expected[80];
+    for(int bit = 0; bit < 64; bit++) {
+        const root::u64 power = 1ull << bit;
+        for(const root::u64& value : {power - 1, power, power + 1}) {
+            snprintf(expected, sizeof(expected), "%llu", value);
+            EXPECT_EQ(formatted("{d}", value), expected);
+            snprintf(expected, sizeof(expected), "%llx", value);
+            EXPECT_EQ(formatted("{x}", value), expected);
+            snprintf(expected, sizeof(expected), "%llX", value);
+            EXPECT_EQ(formatted("{X}", value), expected);
+            snprintf(expected, sizeof(expected), "%llo", value);
+            EXPECT_EQ(formatted("{o}", value), expected);
+            EXPECT_EQ(formatted("{b}", value), binary(value));
+            EXPECT_EQ(root::strlen(value, "b"), binary(value).size());
+        }
+    }
+}
+
+TEST(integer_format_tests, every_u16) {
+    char expected[16];
+    for(root::u32 i = 0; i <= std::numeric_limits<root::u16>::max(); i++) {
+        const root::u16 value = static_cast<root::u16>(i);
+        snprintf(expected, sizeof(expected), "%u", i);
+        ASSERT_EQ(formatted("{}", value), expected);
+        snprintf(expected, sizeof(expected), "%04x", i);
+        ASSERT_EQ(formatted("{04x}", value), expected);
+    }
+}
+
+TEST(integer_format_tests, signed_limits) {
+    EXPECT_EQ(formatted("{}", std::numeric_limits<root::i64>::min()), "-9223372036854775808");
+    EXPECT_EQ(formatted("{}", std::numeric_limits<root::i64>::max()), "9223372036854775807");
+    EXPECT_EQ(formatted("{}", std::numeric_limits<root::i32>::min()), "-2147483648");
+    EXPECT_EQ(formatted("{}", std::numeric_limits<root::i32>::max()), "2147483647");
+    EXPECT_EQ(formatted("{}", std::numeric_limits<root::i16>::min()), "-32768");
+    EXPECT_EQ(formatted("{}", std::numeric_limits<root::i16>::max()), "32767");
+    EXPECT_EQ(formatted("{}", static_cast<root::i64>(0)), "0");
+    EXPECT_EQ(formatted("{}", static_cast<root::i64>(-1)), "-1");
+    EXPECT_EQ(root::strlen(std::numeric_limits<root::i64>::min()), 20);
+    // i8 is a character unless the placeholder asks for a number
+    EXPECT_EQ(formatted("{}", static_cast<root::i8>('a')), "a");
+    EXPECT_EQ(formatted("{d}", static_cast<root::i8>(-128)), "-128");
+    EXPECT_EQ(formatted("{x}", static_cast<root::i64>(-255)), "-ff");
+}
+
+TEST(integer_format_tests, width_and_padding) {
+    EXPECT_EQ(formatted("[{8}]", 42), "[      42]");
+    EXPECT_EQ(formatted("[{08}]", 42), "[00000042]");
+    EXPECT_EQ(formatted("[{8}]", -42), "[     -42]");
+    EXPECT_EQ(formatted("[{08}]", -42), "[-0000042]");
+    EXPECT_EQ(formatted("[{2}]", 12345), "[12345]");
+    EXPECT_EQ(formatted("[{08X}]", 0xbeefu), "[0000BEEF]");
+    EXPECT_EQ(formatted("[{16b}]", 5u), "[             101]");
+    EXPECT_EQ(formatted("[{40}]", 1), "[" + std::string(39, ' ') + "1]");
+    EXPECT_EQ(formatted("{x}", 0u), "0");
+    EXPECT_EQ(root::strlen(42, "08"), 8);
+    EXPECT_EQ(root::strlen(-42, "x"), 3);
+}
+
+TEST(float_placeholder_tests, styles_and_precision) {
+    EXPECT_EQ(formatted("{}", 0.1), "0.1");
+    EXPECT_EQ(formatted("{}", 1e23), "1e+23");
+    EXPECT_EQ(formatted("{}", 0.1f), "0.1");
+    EXPECT_EQ(formatted("{e}", 1234.5), "1.2345e+03");
+    EXPECT_EQ(formatted("{f}", 1.5e-5), "0.000015");
+    EXPECT_EQ(formatted("{.3}", 3.14159), "3.142");
+    EXPECT_EQ(formatted("{.3f}", -2.0f), "-2.000");
+    EXPECT_EQ(formatted("{.2e}", 12345.0), "1.23e+04");
+    EXPECT_EQ(formatted("{.0f}", 2.5), "2");
+    EXPECT_EQ(formatted("{.0f}", 3.5), "4");
+    EXPECT_EQ(formatted("x = {.1f}, y = {}", 1.25, -0.5f), "x = 1.2, y = -0.5");
+    EXPECT_EQ(root::strlen(3.14159, ".3"), 5);
+    EXPECT_EQ(root::strlen(1e100, "e"), 6);
+}
+
+template<char... Chars, typename... Args>
+static inline auto formatted(const root::static_format_string<Chars...>& fmt, Args... args) -> std::string {
+    root::string str = root::format(fmt, args...);
+    return std::string(str.data());
+}
+
+TEST(static_format_string_tests, parsed_at_compile_time) {
+    using fmt = decltype("a {} b {x} c"_fmt);
+    static_assert(fmt::PLACEHOLDERS == 2);
+    static_assert(fmt::literal_begin(0) == 0 && fmt::literal_end(0) == 2);
+    static_assert(fmt::literal_begin(1) == 4 && fmt::literal_end(1) == 7);
+    static_assert(fmt::literal_begin(2) == 10 && fmt::literal_end(2) == 12);
+    static_assert(fmt::literal_size() == 7);
+    static_assert(decltype("no placeholders"_fmt)::PLACEHOLDERS == 0);
+
+    static_assert(!root::placeholders_well_formed("a { b", 5));
+    static_assert(!root::placeholders_well_formed("a } b", 5));
+    static_assert(!root::placeholders_well_formed("{{}}", 4));
+
+    static_assert(root::format_args_check<root::i32>::valid("08x", 0, 3));
+    static_assert(!root::format_args_check<root::i32>::valid(".3f", 0, 3));
+    static_assert(root::format_args_check<root::f64>::valid(".3f", 0, 3));
+    static_assert(!root::format_args_check<root::f64>::valid("x", 0, 1));
+}
+
+TEST(static_format_string_tests, matches_runtime_format) {
+    EXPECT_EQ(formatted("{}"_fmt, 42), formatted("{}", 42));
+    EXPECT_EQ(formatted("frame {} took {} us"_fmt, 7ull, -3), "frame 7 took -3 us");
+    EXPECT_EQ(formatted("[{08X}] {.2f} {}"_fmt, 0xbeefu, 2.5, true), "[0000BEEF] 2.50 true");
+    EXPECT_EQ(formatted("{}{}{}"_fmt, "a", 'b', "c"), "abc");
+    EXPECT_EQ(formatted("no placeholders"_fmt), "no placeholders");
+    EXPECT_EQ(formatted(""_fmt), "");
+    // A single string_view argument used to be ambiguous
+    const root::string_view view("view", 0, 4);
+    EXPECT_EQ(formatted("<{}>"_fmt, view), "<view>");
+    EXPECT_EQ(root::strlen("<{}>"_fmt, view), 6);
+    EXPECT_EQ(root::strlen("{} + {} = {}"_fmt, 1, 2, 3), 9);
 }
\ No newline at end of file
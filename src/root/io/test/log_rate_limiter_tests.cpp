@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/log.h>
+#include <root/io/log_rate_limiter.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace root::literals;
+
+constexpr root::u64 SECOND = 1000000000ull;
+
+TEST(log_rate_limiter_tests, lets_a_burst_through_then_refills) {
+    root::log_rate_limiter limiter(3, 2);
+    const char* format = "acquire failed {}";
+    const root::u64 start = 10 * SECOND;
+
+    for(int i = 0; i < 3; i++) {
+        const root::log_rate_limiter::admission admitted = limiter.admit(root::log_level::error, "swapchain", format, start);
+        EXPECT_TRUE(admitted.m_write);
+        EXPECT_EQ(admitted.m_suppressed, 0);
+    }
+    for(int i = 0; i < 5; i++) {
+        EXPECT_FALSE(limiter.admit(root::log_level::error, "swapchain", format, start).m_write);
+    }
+
+    // Two a second, so one token back after half of one, carrying the count
+    EXPECT_FALSE(limiter.admit(root::log_level::error, "swapchain", format, start + SECOND / 4).m_write);
+    root::log_rate_limiter::admission admitted = limiter.admit(root::log_level::error, "swapchain", format, start + SECOND / 2);
+    EXPECT_TRUE(admitted.m_write);
+    EXPECT_EQ(admitted.m_suppressed, 6);
+    EXPECT_FALSE(limiter.admit(root::log_level::error, "swapchain", format, start + SECOND / 2).m_write);
+
+    // Idle long enough and the whole burst is back, no more than that
+    const root::u64 later = start + 10 * SECOND;
+    admitted = limiter.admit(root::log_level::error, "swapchain", format, later);
+    EXPECT_TRUE(admitted.m_write);
+    EXPECT_EQ(admitted.m_suppressed, 1);
+    EXPECT_TRUE(limiter.admit(root::log_level::error, "swapchain", format, later).m_write);
+    EXPECT_TRUE(limiter.admit(root::log_level::error, "swapchain", format, later).m_write);
+    EXPECT_FALSE(limiter.admit(root::log_level::error, "swapchain", format, later).m_write);
+}
+
+TEST(log_rate_limiter_tests, keys_by_tag_and_format) {
+    root::log_rate_limiter limiter(1, 1);
+    const char* acquire = "acquire failed {}";
+    const char* present = "present failed {}";
+
+    EXPECT_TRUE(limiter.admit(root::log_level::warn, "swapchain", acquire, SECOND).m_write);
+    EXPECT_FALSE(limiter.admit(root::log_level::warn, "swapchain", acquire, SECOND).m_write);
+    EXPECT_TRUE(limiter.admit(root::log_level::warn, "swapchain", present, SECOND).m_write);
+    EXPECT_TRUE(limiter.admit(root::log_level::warn, "device", acquire, SECOND).m_write);
+
+    // Below least_limited nothing is held back
+    for(int i = 0; i < 10; i++) {
+        EXPECT_TRUE(limiter.admit(root::log_level::info, "swapchain", acquire, SECOND).m_write);
+    }
+
+    std::vector<std::string> reported;
+    limiter.report([&reported](const root::log_level& level, const root::string_view& tag, const char* format,
+                               const root::u64& count) {
+        EXPECT_EQ(level, root::log_level::warn);
+        reported.push_back(std::string(tag.data(), tag.size()) + " " + format + " " + std::to_string(count));
+    });
+    ASSERT_EQ(reported.size(), 1);
+    EXPECT_EQ(reported[0], "swapchain acquire failed {} 1");
+
+    // Reported counts are not handed back again
+    limiter.report([](const root::log_level&, const root::string_view&, const char*, const root::u64&) {
+        ADD_FAILURE();
+    });
+    EXPECT_EQ(limiter.admit(root::log_level::warn, "swapchain", acquire, 2 * SECOND).m_suppressed, 0);
+}
+
+TEST(log_rate_limiter_tests, counts_every_message_across_threads) {
+    constexpr root::u64 BURST = 100;
+    constexpr int THREADS = 4;
+    constexpr int MESSAGES = 10000;
+    root::log_rate_limiter limiter(BURST, 1);
+    const char* format = "frame {} late";
+
+    std::atomic<root::u64> written(0);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&limiter, &written, format]() {
+            for(int i = 0; i < MESSAGES; i++) {
+                if(limiter.admit(root::log_level::error, "renderer", format, SECOND).m_write) {
+                    written.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+
+    root::u64 suppressed = 0;
+    limiter.report([&suppressed](const root::log_level&, const root::string_view&, const char*, const root::u64& count) {
+        suppressed += count;
+    });
+    EXPECT_EQ(written.load(), BURST);
+    EXPECT_EQ(written.load() + suppressed, THREADS * MESSAGES);
+}
+
+TEST(log_rate_limiter_tests, log_writes_summaries) {
+    root::dynamic_buffer_stream out;
+    root::writer out_writer(&out);
+    root::async_logger logger(&out_writer);
+    // A rate slow enough that no token comes back while the test runs
+    root::log_rate_limiter limiter(2, 1);
+    root::log::set_async_logger(&logger);
+    root::log::set_rate_limiter(&limiter);
+
+    for(int i = 0; i < 5; i++) {
+        root::log::e("log_rate_limiter_tests", "present failed with {}"_fmt, i);
+    }
+    root::log::flush();
+    root::log::set_rate_limiter(nullptr);
+    root::log::set_async_logger(nullptr);
+    logger.flush();
+
+    EXPECT_EQ(std::string(static_cast<const char*>(out.data()), out.size()),
+              "ERROR: log_rate_limiter_tests: present failed with 0\n"
+              "ERROR: log_rate_limiter_tests: present failed with 1\n"
+              "ERROR: log_rate_limiter_tests: suppressed 3 messages like \"present failed with {}\"\n");
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/log.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace root::literals;
+
+static_assert(root::log::compiled_in(root::log_level::error), "Errors are always compiled in");
+static_assert(root::log::compiled_in(root::MIN_LOG_LEVEL), "MIN_LOG_LEVEL itself is compiled in");
+
+class log_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        root::log::set_async_logger(&logger);
+    }
+
+    void TearDown() override {
+        root::log::set_async_logger(nullptr);
+        root::log::set_level(root::MIN_LOG_LEVEL);
+    }
+
+    auto text() -> std::string {
+        logger.flush();
+        return std::string(static_cast<const char*>(out.data()), out.size());
+    }
+
+    auto counted(const int& value) -> int {
+        evaluations++;
+        return value;
+    }
+
+    root::dynamic_buffer_stream out;
+    root::writer out_writer = root::writer(&out);
+    root::async_logger logger = root::async_logger(&out_writer);
+    int evaluations = 0;
+};
+
+TEST_F(log_tests, macro_skips_arguments_of_filtered_messages) {
+    root::log::set_level("log_tests_macro", root::log_level::warn);
+    for(int i = 0; i < 3; i++) {
+        root_log_d("log_tests_macro", "debug {}"_fmt, counted(i));
+        root_log_i("log_tests_macro", "info {}"_fmt, counted(i));
+    }
+    EXPECT_EQ(evaluations, 0);
+
+    root_log_w("log_tests_macro", "warn {}"_fmt, counted(1));
+    root_log_e("log_tests_macro", "error"_fmt);
+    EXPECT_EQ(evaluations, 1);
+    EXPECT_EQ(text(), "WARN: log_tests_macro: warn 1\nERROR: log_tests_macro: error\n");
+
+    // The level is read on every call, only the tag lookup is cached
+    root::log::set_level("log_tests_macro", root::log_level::debug);
+    root_log_d("log_tests_macro", "debug {}"_fmt, counted(2));
+    EXPECT_EQ(evaluations, 2);
+}
+
+TEST_F(log_tests, functions_filter_by_tag) {
+    root::log::set_level("log_tests_quiet", root::log_level::error);
+    root::log::d("log_tests_quiet", "hidden"_fmt);
+    root::log::w("log_tests_quiet", "hidden"_fmt);
+    root::log::e("log_tests_quiet", "shown"_fmt);
+    root::log::d("log_tests_loud", "shown {}"_fmt, 1);
+    EXPECT_EQ(text(), "ERROR: log_tests_quiet: shown\nDEBUG: log_tests_loud: shown 1\n");
+}
+
+TEST_F(log_tests, default_level_leaves_tags_with_their_own) {
+    root::log::set_level("log_tests_own", root::log_level::debug);
+    // Registered, following the default
+    root_log_i("log_tests_default", "first"_fmt);
+    root::log::set_level(root::log_level::error);
+
+    EXPECT_FALSE(root::log::enabled<root::log_level::warn>("log_tests_default"));
+    EXPECT_FALSE(root::log::enabled<root::log_level::warn>("log_tests_unseen"));
+    EXPECT_TRUE(root::log::enabled<root::log_level::error>("log_tests_unseen"));
+    EXPECT_TRUE(root::log::enabled<root::log_level::debug>("log_tests_own"));
+
+    root_log_i("log_tests_default", "second"_fmt);
+    root::log::i("log_tests_unseen", "hidden"_fmt);
+    root::log::d("log_tests_own", "shown"_fmt);
+    EXPECT_EQ(text(), "INFO: log_tests_default: first\nDEBUG: log_tests_own: shown\n");
+}
\ No newline at end of file
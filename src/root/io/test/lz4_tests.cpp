@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/lz4.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static auto round_trip(const std::vector<root::u8>& input) -> std::vector<root::u8> {
+    std::vector<root::u8> compressed(root::lz4::compress_bound(input.size()));
+    const root::u64 size = root::lz4::compress(input.data(), input.size(), compressed.data(), compressed.size());
+    EXPECT_GT(size, 0);
+    compressed.resize(size);
+    std::vector<root::u8> output(input.size());
+    EXPECT_TRUE(root::lz4::decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+    EXPECT_EQ(output, input);
+    return compressed;
+}
+
+TEST(lz4_tests, empty) {
+    round_trip({});
+}
+
+TEST(lz4_tests, short_inputs) {
+    for(root::u64 size = 1; size < 32; size++) {
+        std::vector<root::u8> input(size, 'a');
+        round_trip(input);
+    }
+}
+
+TEST(lz4_tests, zeroes_compress) {
+    std::vector<root::u8> input(1 << 20, 0);
+    std::vector<root::u8> compressed = round_trip(input);
+    EXPECT_LT(compressed.size(), input.size() / 100);
+}
+
+TEST(lz4_tests, text_compresses) {
+    const char* sentence = "The quick brown fox jumps over the lazy dog. ";
+    std::vector<root::u8> input;
+    for(int i = 0; i < 1000; i++) {
+        input.insert(input.end(), sentence, sentence + strlen(sentence));
+        input.push_back(static_cast<root::u8>('0' + i % 10));
+    }
+    std::vector<root::u8> compressed = round_trip(input);
+    EXPECT_LT(compressed.size(), input.size() / 4);
+}
+
+TEST(lz4_tests, random_data) {
+    std::vector<root::u8> input(100000);
+    for(root::u8& byte : input) {
+        byte = static_cast<root::u8>(rand());
+    }
+    std::vector<root::u8> compressed = round_trip(input);
+    EXPECT_LE(compressed.size(), root::lz4::compress_bound(input.size()));
+}
+
+TEST(lz4_tests, long_matches_and_literals) {
+    // Runs longer than 255 exercise the extra length bytes both ways
+    std::vector<root::u8> input;
+    for(int i = 0; i < 600; i++) {
+        input.push_back(static_cast<root::u8>(rand()));
+    }
+    input.insert(input.end(), 5000, 'x');
+    for(int i = 0; i < 600; i++) {
+        input.push_back(static_cast<root::u8>(rand()));
+    }
+    round_trip(input);
+}
+
+TEST(lz4_tests, too_small_destination) {
+    std::vector<root::u8> input(1000);
+    for(root::u8& byte : input) {
+        byte = static_cast<root::u8>(rand());
+    }
+    std::vector<root::u8> compressed(100);
+    EXPECT_EQ(root::lz4::compress(input.data(), input.size(), compressed.data(), compressed.size()), 0);
+}
+
+TEST(lz4_tests, rejects_malformed_input) {
+    std::vector<root::u8> input(4096, 'a');
+    std::vector<root::u8> compressed = round_trip(input);
+    std::vector<root::u8> output(input.size());
+
+    // Wrong expected size either way
+    EXPECT_FALSE(root::lz4::decompress(compressed.data(), compressed.size(), output.data(), output.size() - 1));
+    output.resize(input.size() + 1);
+    EXPECT_FALSE(root::lz4::decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+    output.resize(input.size());
+
+    // Truncated
+    for(root::u64 size = 0; size < compressed.size(); size++) {
+        EXPECT_FALSE(root::lz4::decompress(compressed.data(), size, output.data(), output.size()));
+    }
+
+    // Offset pointing before the start of the output
+    const root::u8 bad_offset[] = {0x10, 'a', 0xff, 0x00, 0x00};
+    EXPECT_FALSE(root::lz4::decompress(bad_offset, sizeof(bad_offset), output.data(), output.size()));
+
+    // Random garbage never writes out of bounds
+    for(int i = 0; i < 1000; i++) {
+        std::vector<root::u8> garbage(64);
+        for(root::u8& byte : garbage) {
+            byte = static_cast<root::u8>(rand());
+        }
+        root::lz4::decompress(garbage.data(), garbage.size(), output.data(), 256);
+    }
+}
\ No newline at end of file
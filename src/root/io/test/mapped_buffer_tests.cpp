@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/mapped_buffer.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+class mapped_buffer_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        strcpy(file_path, "/tmp/root_mapped_buffer_XXXXXX");
+        int fd = mkstemp(file_path);
+        ASSERT_GE(fd, 0);
+        for(root::u64 i = 0; i < FILE_SIZE; i++) {
+            contents[i] = static_cast<char>(rand());
+        }
+        ASSERT_EQ(write(fd, contents, FILE_SIZE), FILE_SIZE);
+        close(fd);
+    }
+
+    void TearDown() override {
+        unlink(file_path);
+    }
+
+    // Spans several pages so advice on a range has something to do
+    static constexpr root::u64 FILE_SIZE = 3 * 4096 + 17;
+    char file_path[64];
+    char contents[FILE_SIZE];
+};
+
+TEST_F(mapped_buffer_tests, maps_whole_file) {
+    root::mapped_buffer mapped(file_path);
+    ASSERT_TRUE(mapped);
+    EXPECT_EQ(mapped.size(), FILE_SIZE);
+    EXPECT_EQ(memcmp(mapped.data(), contents, FILE_SIZE), 0);
+
+    const root::buffer_slice slice = mapped;
+    EXPECT_EQ(slice.size(), FILE_SIZE);
+    EXPECT_EQ(slice.data(), mapped.data());
+}
+
+TEST_F(mapped_buffer_tests, path_need_not_be_null_terminated) {
+    char padded[sizeof(file_path) + 4];
+    const root::u64 len = strlen(file_path);
+    memcpy(padded, file_path, len);
+    memcpy(padded + len, "junk", 4);
+    root::mapped_buffer mapped(root::string_view(padded, 0, len));
+    ASSERT_TRUE(mapped);
+    EXPECT_EQ(mapped.size(), FILE_SIZE);
+}
+
+TEST_F(mapped_buffer_tests, missing_file) {
+    root::mapped_buffer mapped("/tmp/root_mapped_buffer_does_not_exist");
+    EXPECT_FALSE(mapped);
+    EXPECT_EQ(mapped.data(), nullptr);
+    EXPECT_EQ(mapped.size(), 0);
+}
+
+TEST_F(mapped_buffer_tests, empty_file) {
+    FILE* file = fopen(file_path, "w");
+    fclose(file);
+    root::mapped_buffer mapped(file_path);
+    EXPECT_FALSE(mapped);
+}
+
+TEST_F(mapped_buffer_tests, move) {
+    root::mapped_buffer mapped(file_path, root::access_pattern::random);
+    const void* data = mapped.data();
+    root::mapped_buffer moved(std::move(mapped));
+    EXPECT_FALSE(mapped);
+    EXPECT_EQ(moved.data(), data);
+
+    root::mapped_buffer assigned;
+    assigned = std::move(moved);
+    EXPECT_FALSE(moved);
+    EXPECT_EQ(assigned.data(), data);
+    EXPECT_EQ(memcmp(assigned.data(), contents, FILE_SIZE), 0);
+}
+
+TEST_F(mapped_buffer_tests, advise) {
+    root::mapped_buffer mapped(file_path);
+    EXPECT_EQ(mapped.advise(root::access_pattern::will_need), root::error::NO_ERROR);
+    EXPECT_EQ(mapped.advise(root::access_pattern::random, 4096 + 1, 4096), root::error::NO_ERROR);
+    EXPECT_EQ(mapped.advise(root::access_pattern::normal, FILE_SIZE), root::error::INVALID_OPERATION);
+
+    root::mapped_buffer invalid;
+    EXPECT_EQ(invalid.advise(root::access_pattern::normal), root::error::INVALID_OPERATION);
+}
\ No newline at end of file
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/posix_file_stream.h>
+#include <root/memory/system_allocator.h>
+#include <root/memory/test/mock_allocator.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+class posix_file_stream_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        strcpy(file_path, "/tmp/root_posix_file_stream_XXXXXX");
+        int fd = mkstemp(file_path);
+        ASSERT_GE(fd, 0);
+        for(root::u64 i = 0; i < FILE_SIZE; i++) {
+            contents[i] = static_cast<char>(rand());
+        }
+        ASSERT_EQ(write(fd, contents, FILE_SIZE), FILE_SIZE);
+        close(fd);
+    }
+
+    void TearDown() override {
+        unlink(file_path);
+    }
+
+    auto file_contents() -> std::vector<char> {
+        std::vector<char> data;
+        FILE* file = fopen(file_path, "rb");
+        char chunk[256];
+        while(root::u64 count = fread(chunk, 1, sizeof(chunk), file)) {
+            data.insert(data.end(), chunk, chunk + count);
+        }
+        fclose(file);
+        return data;
+    }
+
+    // Several direct I/O blocks plus a tail
+    static constexpr root::u64 FILE_SIZE = 5 * 4096 + 123;
+    static constexpr root::u64 SMALL_BUFFER = 512;
+    char file_path[64];
+    char contents[FILE_SIZE];
+};
+
+TEST_F(posix_file_stream_tests, reads_in_small_pieces) {
+    root::posix_file_stream stream(file_path, root::file_mode::read, SMALL_BUFFER);
+    ASSERT_TRUE(stream);
+    EXPECT_EQ(stream.size(), FILE_SIZE);
+    char data[FILE_SIZE];
+    root::u64 offset = 0;
+    while(offset < FILE_SIZE) {
+        const root::u64 len = 1 + rand() % 100;
+        const root::value_or_error<root::u64> res = stream.read(data + offset, len);
+        ASSERT_TRUE(res.has_value());
+        EXPECT_EQ(res.value(), offset + len > FILE_SIZE ? FILE_SIZE - offset : len);
+        offset += res.value();
+    }
+    EXPECT_EQ(memcmp(data, contents, FILE_SIZE), 0);
+    EXPECT_EQ(stream.read(data, 1), 0);
+}
+
+TEST_F(posix_file_stream_tests, whole_file_skips_buffer) {
+    NiceMock<root::mock_allocator> alloc;
+    root::u64 mallocs = 0;
+    ON_CALL(alloc, malloc(_, _)).WillByDefault(Invoke([&](const root::u64& bytes, const root::u64& alignment) {
+        mallocs++;
+        return root::system_allocator::universal_instance.malloc(bytes, alignment);
+    }));
+    ON_CALL(alloc, free(_)).WillByDefault(Invoke([](void* mem) {
+        root::system_allocator::universal_instance.free(mem);
+    }));
+
+    char data[FILE_SIZE];
+    {
+        root::posix_file_stream stream(file_path, root::file_mode::read, root::posix_file_stream::DEFAULT_BUFFER_SIZE, &alloc);
+        EXPECT_EQ(stream.read(data, FILE_SIZE), FILE_SIZE);
+    }
+    EXPECT_EQ(memcmp(data, contents, FILE_SIZE), 0);
+    EXPECT_EQ(mallocs, 0);
+}
+
+TEST_F(posix_file_stream_tests, seek_and_tell) {
+    root::posix_file_stream stream(file_path, root::file_mode::read, SMALL_BUFFER);
+    EXPECT_EQ(stream.tell(root::relative_to::end), FILE_SIZE);
+    EXPECT_EQ(stream.seek(-10, root::relative_to::end), root::error::NO_ERROR);
+    EXPECT_EQ(stream.tell(), FILE_SIZE - 10);
+    EXPECT_EQ(stream.tell(root::relative_to::end), 10);
+
+    char data[32];
+    EXPECT_EQ(stream.read(data, sizeof(data)), 10);
+    EXPECT_EQ(memcmp(data, contents + FILE_SIZE - 10, 10), 0);
+
+    EXPECT_EQ(stream.seek(100), root::error::NO_ERROR);
+    EXPECT_EQ(stream.seek(-50, root::relative_to::current_position), root::error::NO_ERROR);
+    EXPECT_EQ(stream.read(data, sizeof(data)), sizeof(data));
+    EXPECT_EQ(memcmp(data, contents + 50, sizeof(data)), 0);
+
+    EXPECT_EQ(stream.seek(-1), root::error::INVALID_OPERATION);
+}
+
+TEST_F(posix_file_stream_tests, writes_are_buffered_until_flush) {
+    root::posix_file_stream stream(file_path, root::file_mode::write, SMALL_BUFFER);
+    ASSERT_TRUE(stream);
+    EXPECT_EQ(stream.size(), 0);
+    EXPECT_EQ(stream.write("hello", 5), 5);
+    EXPECT_EQ(stream.write(" world", 6), 6);
+    EXPECT_EQ(stream.size(), 11);
+    EXPECT_EQ(stream.tell(root::relative_to::end), 0);
+    EXPECT_TRUE(file_contents().empty());
+
+    EXPECT_EQ(stream.flush(), root::error::NO_ERROR);
+    const std::vector<char> written = file_contents();
+    EXPECT_EQ(std::string(written.begin(), written.end()), "hello world");
+}
+
+TEST_F(posix_file_stream_tests, writes_across_buffer) {
+    {
+        root::posix_file_stream stream(file_path, root::file_mode::write, SMALL_BUFFER);
+        root::u64 offset = 0;
+        while(offset < FILE_SIZE) {
+            const root::u64 len = std::min<root::u64>(1 + rand() % (2 * SMALL_BUFFER), FILE_SIZE - offset);
+            EXPECT_EQ(stream.write(contents + offset, len), len);
+            offset += len;
+        }
+    }
+    const std::vector<char> written = file_contents();
+    ASSERT_EQ(written.size(), FILE_SIZE);
+    EXPECT_EQ(memcmp(written.data(), contents, FILE_SIZE), 0);
+}
+
+TEST_F(posix_file_stream_tests, read_write_overwrites_in_place) {
+    {
+        root::posix_file_stream stream(file_path, root::file_mode::read_write, SMALL_BUFFER);
+        char data[16];
+        EXPECT_EQ(stream.read(data, sizeof(data)), sizeof(data));
+        EXPECT_EQ(stream.seek(4), root::error::NO_ERROR);
+        EXPECT_EQ(stream.write("root", 4), 4);
+        // Reading flushes the pending write and sees it
+        EXPECT_EQ(stream.seek(0), root::error::NO_ERROR);
+        EXPECT_EQ(stream.read(data, sizeof(data)), sizeof(data));
+        EXPECT_EQ(memcmp(data + 4, "root", 4), 0);
+        EXPECT_EQ(stream.size(), FILE_SIZE);
+    }
+    memcpy(contents + 4, "root", 4);
+    const std::vector<char> written = file_contents();
+    ASSERT_EQ(written.size(), FILE_SIZE);
+    EXPECT_EQ(memcmp(written.data(), contents, FILE_SIZE), 0);
+}
+
+TEST_F(posix_file_stream_tests, writev_joins_pending_writes) {
+    {
+        root::posix_file_stream stream(file_path, root::file_mode::write, SMALL_BUFFER);
+        EXPECT_EQ(stream.write(contents, 10), 10);
+        // Small enough to be buffered
+        root::buffer_slice small[] = {root::buffer_slice(contents, 10, 20), root::buffer_slice(contents, 20, 30)};
+        EXPECT_EQ(stream.writev(small), 20);
+        EXPECT_TRUE(file_contents().empty());
+
+        // The pending 30 bytes go out ahead of the slices
+        root::buffer_slice large[] = {root::buffer_slice(contents, 30, 1000), root::buffer_slice(contents, 1000, FILE_SIZE)};
+        EXPECT_EQ(stream.writev(large), FILE_SIZE - 30);
+        EXPECT_EQ(file_contents().size(), FILE_SIZE);
+        EXPECT_EQ(stream.tell(), FILE_SIZE);
+    }
+    const std::vector<char> written = file_contents();
+    ASSERT_EQ(written.size(), FILE_SIZE);
+    EXPECT_EQ(memcmp(written.data(), contents, FILE_SIZE), 0);
+}
+
+TEST_F(posix_file_stream_tests, readv) {
+    root::posix_file_stream stream(file_path, root::file_mode::read, SMALL_BUFFER);
+    char header[16];
+    char payload[FILE_SIZE];
+    root::buffer_slice slices[] = {root::buffer_slice(header, 0, sizeof(header)), root::buffer_slice(payload, 0, sizeof(payload))};
+    EXPECT_EQ(stream.readv(slices), FILE_SIZE);
+    EXPECT_EQ(memcmp(header, contents, sizeof(header)), 0);
+    EXPECT_EQ(memcmp(payload, contents + sizeof(header), FILE_SIZE - sizeof(header)), 0);
+    EXPECT_EQ(stream.tell(root::relative_to::end), 0);
+
+    // Small ones go through the buffer
+    EXPECT_EQ(stream.seek(3), root::error::NO_ERROR);
+    root::buffer_slice small[] = {root::buffer_slice(header, 0, 4), root::buffer_slice(header, 4, 8)};
+    EXPECT_EQ(stream.readv(small), 8);
+    EXPECT_EQ(memcmp(header, contents + 3, 8), 0);
+}
+
+TEST_F(posix_file_stream_tests, read_only_rejects_writes) {
+    root::posix_file_stream stream(file_path);
+    EXPECT_EQ(stream.write("x", 1), root::error::INVALID_OPERATION);
+}
+
+TEST_F(posix_file_stream_tests, direct_read) {
+    root::posix_file_stream stream(file_path, root::file_mode::direct_read, 3 * 4096);
+    ASSERT_TRUE(stream);
+    char data[FILE_SIZE];
+    // Unaligned offset and size go through the aligned buffer
+    EXPECT_EQ(stream.seek(7), root::error::NO_ERROR);
+    EXPECT_EQ(stream.read(data, 100), 100);
+    EXPECT_EQ(memcmp(data, contents + 7, 100), 0);
+
+    // An aligned destination at an aligned offset is read into directly
+    root::buffer aligned(FILE_SIZE, root::posix_file_stream::DIRECT_ALIGNMENT);
+    EXPECT_EQ(stream.seek(0), root::error::NO_ERROR);
+    EXPECT_EQ(stream.read(aligned.data(), FILE_SIZE), FILE_SIZE);
+    EXPECT_EQ(memcmp(aligned.data(), contents, FILE_SIZE), 0);
+    EXPECT_EQ(stream.write("x", 1), root::error::INVALID_OPERATION);
+}
+
+TEST_F(posix_file_stream_tests, missing_file) {
+    root::posix_file_stream stream("/tmp/root_posix_file_stream_does_not_exist");
+    EXPECT_FALSE(stream);
+    char data[4];
+    EXPECT_EQ(stream.read(data, sizeof(data)), root::error::INVALID_OPERATION);
+    EXPECT_EQ(stream.tell(), root::error::INVALID_OPERATION);
+}
\ No newline at end of file
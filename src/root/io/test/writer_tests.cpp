@@ -62,4 +62,11 @@ TEST_F(writer_tests, write) {
     char buffer[BUFFER_SIZE];
     EXPECT_CALL(stream, write(buffer, BUFFER_SIZE)).Times(1).WillOnce(Return(root::error::NO_ERROR));
     EXPECT_EQ(writer.write(buffer, BUFFER_SIZE), root::error::NO_ERROR);
-} 
\ No newline at end of file
+} 
+
+TEST_F(writer_tests, writev) {
+    char buffer[BUFFER_SIZE];
+    root::buffer_slice slices[] = {root::buffer_slice(buffer, 0, 10), root::buffer_slice(buffer, 10, BUFFER_SIZE)};
+    EXPECT_CALL(stream, writev(::testing::_)).Times(1).WillOnce(Return(BUFFER_SIZE));
+    EXPECT_EQ(writer.writev(slices), BUFFER_SIZE);
+}
\ No newline at end of file
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/jobs/jobs.h>
+
+#include <root/core/assert.h>
+#include <root/core/mpmc_queue.h>
+#include <root/io/log.h>
+#include <root/jobs/private/work_stealing_deque.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(ROOT_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace root {
+
+namespace jobs {
+
+constexpr u64 DEQUE_CAPACITY = 4096;
+constexpr u64 INJECTION_CAPACITY = 4096;
+constexpr u32 SPINS_BEFORE_SLEEP = 64;
+constexpr u64 GRAIN_SPLITS_PER_WORKER = 4;
+
+struct worker {
+    worker(const u32& index, allocator* alloc)
+    :   m_deque(DEQUE_CAPACITY, alloc), m_index(index) {}
+
+    work_stealing_deque<job> m_deque;
+    std::thread m_thread;
+    u32 m_index;
+};
+
+struct scheduler {
+    scheduler(const u32& worker_count, allocator* alloc)
+    :   m_injected(INJECTION_CAPACITY, alloc),
+        m_workers(static_cast<worker*>(alloc->malloc(sizeof(worker) * worker_count, alignof(worker)))),
+        m_worker_count(worker_count),
+        m_allocator(alloc) {
+        for(u32 i = 0; i < worker_count; i++) {
+            new (&m_workers[i]) worker(i, alloc);
+        }
+    }
+
+    ~scheduler() {
+        for(u32 i = 0; i < m_worker_count; i++) {
+            m_workers[i].~worker();
+        }
+        m_allocator->free(m_workers);
+    }
+
+    // Jobs from threads that aren't workers
+    mpmc_queue<job*> m_injected;
+    worker* m_workers;
+    u32 m_worker_count;
+    allocator* m_allocator;
+
+    std::atomic<bool> m_running{true};
+    std::atomic<u32> m_sleeping{0};
+    std::mutex m_sleep_lock;
+    std::condition_variable m_wake;
+};
+
+static scheduler* s_scheduler = nullptr;
+static thread_local worker* t_worker = nullptr;
+static thread_local u32 t_seed = static_cast<u32>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+
+static auto random_victim(const u32& count) -> u32 {
+    // xorshift32, only needs to spread thieves around
+    t_seed ^= t_seed << 13;
+    t_seed ^= t_seed >> 17;
+    t_seed ^= t_seed << 5;
+    return t_seed % count;
+}
+
+static auto find_work(scheduler* s, worker* self) -> job* {
+    if(self) {
+        if(job* j = self->m_deque.pop()) return j;
+    }
+    job* injected;
+    if(s->m_injected.try_pop(injected)) return injected;
+    const u32 start = random_victim(s->m_worker_count);
+    for(u32 i = 0; i < s->m_worker_count; i++) {
+        worker& victim = s->m_workers[(start + i) % s->m_worker_count];
+        if(&victim == self) continue;
+        if(job* j = victim.m_deque.steal()) return j;
+    }
+    return nullptr;
+}
+
+auto execute(job* j) -> void {
+    counter* c = j->m_counter;
+    j->m_function(j);
+    if(c) {
+        // The waiter may destroy c as soon as it reaches zero
+        job* continuation = c->m_continuation;
+        if(c->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1 && continuation) {
+            run(continuation, nullptr);
+        }
+    }
+}
+
+static auto worker_loop(scheduler* s, worker* self) -> void {
+    t_worker = self;
+    u32 idle = 0;
+    while(s->m_running.load(std::memory_order_acquire)) {
+        if(job* j = find_work(s, self)) {
+            execute(j);
+            idle = 0;
+            continue;
+        }
+        if(++idle < SPINS_BEFORE_SLEEP) {
+            std::this_thread::yield();
+            continue;
+        }
+        // Timed so a wake up racing with going to sleep costs at most a millisecond
+        std::unique_lock<std::mutex> lock(s->m_sleep_lock);
+        s->m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        s->m_wake.wait_for(lock, std::chrono::milliseconds(1));
+        s->m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+    t_worker = nullptr;
+}
+
+static auto pin_to_core(std::thread& thread, const u32& core) -> void {
+#if defined(ROOT_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if(pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) != 0) {
+        log::w("jobs", "Could not pin worker to core {}"_fmt, core);
+    }
+#endif
+}
+
+auto init(const u32& worker_count, allocator* alloc) -> void {
+    root_assert(!s_scheduler);
+    const u32 hardware = std::thread::hardware_concurrency();
+    const u32 count = worker_count ? worker_count : (hardware ? hardware : 1);
+    s_scheduler = alloc->make<scheduler>(count, alloc);
+    t_worker = &s_scheduler->m_workers[0];
+    for(u32 i = 1; i < count; i++) {
+        worker& w = s_scheduler->m_workers[i];
+        w.m_thread = std::thread(worker_loop, s_scheduler, &w);
+        if(hardware) pin_to_core(w.m_thread, i % hardware);
+    }
+    log::d("jobs", "Started {} workers"_fmt, count);
+}
+
+auto deinit() -> void {
+    if(!s_scheduler) return;
+    root_assert(s_scheduler->m_workers[0].m_deque.size_hint() == 0);
+    s_scheduler->m_running.store(false, std::memory_order_release);
+    s_scheduler->m_wake.notify_all();
+    for(u32 i = 1; i < s_scheduler->m_worker_count; i++) {
+        s_scheduler->m_workers[i].m_thread.join();
+    }
+    t_worker = nullptr;
+    s_scheduler->m_allocator->del(s_scheduler);
+    s_scheduler = nullptr;
+}
+
+auto worker_count() -> u32 {
+    return s_scheduler ? s_scheduler->m_worker_count : 0;
+}
+
+auto default_grain(const u64& size) -> u64 {
+    const u64 splits = (worker_count() ? worker_count() : 1) * GRAIN_SPLITS_PER_WORKER;
+    const u64 grain = size / splits;
+    return grain ? grain : 1;
+}
+
+auto run(job* j, counter* c) -> void {
+    j->m_counter = c;
+    if(c) c->m_pending.fetch_add(1, std::memory_order_relaxed);
+    scheduler* s = s_scheduler;
+    if(!s || !s->m_running.load(std::memory_order_relaxed)) {
+        execute(j);
+        return;
+    }
+    const bool queued = t_worker ? t_worker->m_deque.push(j) : s->m_injected.try_push(j);
+    if(!queued) {
+        execute(j);
+        return;
+    }
+    if(s->m_sleeping.load(std::memory_order_seq_cst)) {
+        s->m_wake.notify_one();
+    }
+}
+
+auto wait(counter* c) -> void {
+    scheduler* s = s_scheduler;
+    while(!c->done()) {
+        job* j = s ? find_work(s, t_worker) : nullptr;
+        if(j) {
+            execute(j);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace jobs
+
+} // namespace root
\ No newline at end of file
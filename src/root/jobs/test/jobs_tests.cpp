@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <root/jobs/jobs.h>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+class jobs_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        root::jobs::init(4);
+    }
+
+    void TearDown() override {
+        root::jobs::deinit();
+    }
+};
+
+TEST_F(jobs_tests, worker_count) {
+    EXPECT_EQ(root::jobs::worker_count(), 4);
+}
+
+TEST_F(jobs_tests, fork_join) {
+    std::atomic<int> runs{0};
+    root::jobs::counter pending;
+    std::vector<root::jobs::function_job<std::function<void()>>> jobs;
+    jobs.reserve(100);
+    for(int i = 0; i < 100; i++) {
+        jobs.emplace_back([&runs]() { runs++; });
+    }
+    for(auto& j : jobs) {
+        root::jobs::run(&j, &pending);
+    }
+    root::jobs::wait(&pending);
+    EXPECT_TRUE(pending.done());
+    EXPECT_EQ(runs, 100);
+}
+
+TEST_F(jobs_tests, nested_jobs) {
+    std::atomic<int> leaves{0};
+    root::jobs::counter outer;
+    auto parent = root::jobs::make_job([&leaves]() {
+        root::jobs::counter inner;
+        auto first = root::jobs::make_job([&leaves]() { leaves++; });
+        auto second = root::jobs::make_job([&leaves]() { leaves++; });
+        root::jobs::run(&first, &inner);
+        root::jobs::run(&second, &inner);
+        root::jobs::wait(&inner);
+    });
+    root::jobs::run(&parent, &outer);
+    root::jobs::wait(&outer);
+    EXPECT_EQ(leaves, 2);
+}
+
+TEST_F(jobs_tests, continuation) {
+    std::atomic<int> runs{0};
+    std::atomic<int> runs_seen{-1};
+    auto then = root::jobs::make_job([&runs, &runs_seen]() { runs_seen = runs.load(); });
+    {
+        root::jobs::counter pending(&then);
+        auto first = root::jobs::make_job([&runs]() { runs++; });
+        auto second = root::jobs::make_job([&runs]() { runs++; });
+        root::jobs::run(&first, &pending);
+        root::jobs::run(&second, &pending);
+        root::jobs::wait(&pending);
+    }
+    while(runs_seen.load() < 0) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(runs_seen, 2);
+}
+
+TEST_F(jobs_tests, parallel_for) {
+    std::vector<root::u64> values(100000);
+    for(root::u64 i = 0; i < values.size(); i++) {
+        values[i] = i;
+    }
+    root::array_slice<root::u64> slice(values.data(), values.size());
+    root::jobs::parallel_for(slice, [](root::u64& value) {
+        value *= 2;
+    });
+    for(root::u64 i = 0; i < values.size(); i++) {
+        EXPECT_EQ(values[i], i * 2);
+    }
+}
+
+TEST_F(jobs_tests, parallel_for_grain) {
+    std::vector<int> values(1000, 1);
+    std::atomic<int> sum{0};
+    root::jobs::parallel_for(root::array_slice<int>(values.data(), values.size()), [&sum](int& value) {
+        sum += value;
+    }, 7);
+    EXPECT_EQ(sum, 1000);
+}
+
+TEST(jobs_without_workers_tests, runs_inline) {
+    EXPECT_EQ(root::jobs::worker_count(), 0);
+    int runs = 0;
+    root::jobs::counter pending;
+    auto j = root::jobs::make_job([&runs]() { runs++; });
+    root::jobs::run(&j, &pending);
+    EXPECT_EQ(runs, 1);
+    EXPECT_TRUE(pending.done());
+    std::vector<int> values(10, 1);
+    root::jobs::parallel_for(root::array_slice<int>(values.data(), values.size()), [](int& value) {
+        value++;
+    });
+    EXPECT_EQ(values[9], 2);
+}
\ No newline at end of file
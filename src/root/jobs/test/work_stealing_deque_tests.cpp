@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <root/jobs/private/work_stealing_deque.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(work_stealing_deque_tests, owner_is_lifo) {
+    root::jobs::work_stealing_deque<int> deque(8);
+    int values[3] = {0, 1, 2};
+    for(int& value : values) {
+        EXPECT_TRUE(deque.push(&value));
+    }
+    EXPECT_EQ(deque.pop(), &values[2]);
+    EXPECT_EQ(deque.pop(), &values[1]);
+    EXPECT_EQ(deque.pop(), &values[0]);
+    EXPECT_EQ(deque.pop(), nullptr);
+}
+
+TEST(work_stealing_deque_tests, thieves_are_fifo) {
+    root::jobs::work_stealing_deque<int> deque(8);
+    int values[3] = {0, 1, 2};
+    for(int& value : values) {
+        deque.push(&value);
+    }
+    EXPECT_EQ(deque.steal(), &values[0]);
+    EXPECT_EQ(deque.steal(), &values[1]);
+    EXPECT_EQ(deque.pop(), &values[2]);
+    EXPECT_EQ(deque.steal(), nullptr);
+}
+
+TEST(work_stealing_deque_tests, full) {
+    root::jobs::work_stealing_deque<int> deque(4);
+    int value = 0;
+    for(int i = 0; i < 4; i++) {
+        EXPECT_TRUE(deque.push(&value));
+    }
+    EXPECT_FALSE(deque.push(&value));
+    deque.steal();
+    EXPECT_TRUE(deque.push(&value));
+}
+
+TEST(work_stealing_deque_tests, concurrent_steals) {
+    constexpr int COUNT = 100000;
+    constexpr int THIEVES = 3;
+    root::jobs::work_stealing_deque<int> deque(1024);
+    std::vector<int> values(COUNT);
+    std::vector<std::atomic<int>> taken(COUNT);
+    std::atomic<int> total{0};
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for(int t = 0; t < THIEVES; t++) {
+        thieves.emplace_back([&]() {
+            while(!done.load() || deque.size_hint()) {
+                if(int* value = deque.steal()) {
+                    taken[value - values.data()]++;
+                    total++;
+                }
+            }
+        });
+    }
+    for(int i = 0; i < COUNT; i++) {
+        while(!deque.push(&values[i])) {
+            if(int* value = deque.pop()) {
+                taken[value - values.data()]++;
+                total++;
+            }
+        }
+        if(i % 3 == 0) {
+            if(int* value = deque.pop()) {
+                taken[value - values.data()]++;
+                total++;
+            }
+        }
+    }
+    while(int* value = deque.pop()) {
+        taken[value - values.data()]++;
+        total++;
+    }
+    done = true;
+    for(std::thread& thief : thieves) {
+        thief.join();
+    }
+    EXPECT_EQ(total, COUNT);
+    for(std::atomic<int>& count : taken) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
\ No newline at end of file
@@ -19,13 +19,47 @@
 
 #include <root/root.h>
 
+#include <root/asset/asset_manager.h>
 #include <root/graphics/graphics.h>
+#include <root/io/log.h>
+#include <root/jobs/jobs.h>
+#if defined(ROOT_DEBUG)
+#include <root/memory/tracking_allocator.h>
+#endif
 
 #if !defined(ROOT_ANDROID)
 int main(int argc, char** argv) {
+    // Logging from here on is formatted and written by a background thread
+    root::file_stream stdout_stream(stdout);
+    root::writer stdout_writer(&stdout_stream);
+    root::async_logger async_logger(&stdout_writer);
+    root::log::set_async_logger(&async_logger);
+    // An error hit every frame is written a few times a second, not every frame
+    root::log_rate_limiter rate_limiter;
+    root::log::set_rate_limiter(&rate_limiter);
+#if defined(ROOT_DEBUG)
+    // Reports what each subsystem still holds when it is torn down
+    root::tracking_allocator graphics_allocator("graphics");
+    root::tracking_allocator asset_allocator("asset_manager");
+    root::asset_manager::init(root::path::binary_location(), &asset_allocator);
+    root::jobs::init();
+    root::graphics::init(&graphics_allocator);
+#else
+    root::asset_manager::init();
+    root::jobs::init();
     root::graphics::init();
+#endif
     int res = root_main(argc, argv);
     root::graphics::deinit();
+    root::jobs::deinit();
+    root::asset_manager::deinit();
+#if defined(ROOT_DEBUG)
+    graphics_allocator.report();
+    asset_allocator.report();
+#endif
+    root::log::flush();
+    root::log::set_rate_limiter(nullptr);
+    root::log::set_async_logger(nullptr);
     return res;
 }
 #else 
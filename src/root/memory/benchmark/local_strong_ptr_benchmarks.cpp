@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <root/core/test/benchmark.h>
+#include <root/memory/local_strong_ptr.h>
+
+constexpr root::u64 ITERATIONS = 10000000;
+
+template<typename Ptr>
+inline auto copy_destroy(const Ptr& original, const char* name) -> root::u64 {
+    return root::benchmark(name, ITERATIONS, [&original](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            Ptr copy = original;
+            root::do_not_optimize(copy);
+        }
+    });
+}
+
+TEST(local_strong_ptr_benchmarks, copy_destroy) {
+    root::strong_ptr<root::u64> atomic = root::make_strong<root::u64>(42ull);
+    root::local_strong_ptr<root::u64> local = root::make_local_strong<root::u64>(42ull);
+    copy_destroy(atomic, "strong_ptr copy/destroy");
+    copy_destroy(local, "local_strong_ptr copy/destroy");
+}
+
+TEST(local_strong_ptr_benchmarks, weak_promote) {
+    root::strong_ptr<root::u64> atomic = root::make_strong<root::u64>(42ull);
+    root::local_strong_ptr<root::u64> local = root::make_local_strong<root::u64>(42ull);
+    root::weak_ptr<root::u64> atomic_weak(atomic);
+    root::local_weak_ptr<root::u64> local_weak(local);
+    root::benchmark("weak_ptr promote", ITERATIONS, [&atomic_weak](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::strong_ptr<root::u64> promoted = atomic_weak.promote();
+            root::do_not_optimize(promoted);
+        }
+    });
+    root::benchmark("local_weak_ptr promote", ITERATIONS, [&local_weak](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::local_strong_ptr<root::u64> promoted = local_weak.promote();
+            root::do_not_optimize(promoted);
+        }
+    });
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <root/core/test/benchmark.h>
+#include <root/memory/pool_allocator.h>
+#include <root/memory/strong_ptr.h>
+#include <root/memory/system_allocator.h>
+
+constexpr root::u64 ITERATIONS = 1000000;
+constexpr root::u64 BATCH = 64;
+
+static inline auto churn(root::allocator* alloc, const char* name) -> root::u64 {
+    return root::benchmark(name, ITERATIONS, [alloc](const root::u64& iterations) {
+        void* blocks[BATCH];
+        for(root::u64 i = 0; i < iterations; i += BATCH) {
+            for(root::u64 j = 0; j < BATCH; j++) {
+                blocks[j] = alloc->malloc(16 + (j % 4) * 16, 8);
+                root::do_not_optimize(blocks[j]);
+            }
+            for(root::u64 j = 0; j < BATCH; j++) {
+                alloc->free(blocks[j]);
+            }
+        }
+    });
+}
+
+TEST(pool_allocator_benchmarks, malloc_free_small) {
+    root::pool_allocator pool(&root::system_allocator::universal_instance);
+    churn(&root::system_allocator::universal_instance, "system_allocator malloc/free 16-64B");
+    churn(&pool, "pool_allocator malloc/free 16-64B");
+}
+
+TEST(pool_allocator_benchmarks, make_strong) {
+    root::pool_allocator pool(&root::system_allocator::universal_instance);
+    auto body = [](root::allocator* alloc) {
+        return [alloc](const root::u64& iterations) {
+            for(root::u64 i = 0; i < iterations; i++) {
+                root::strong_ptr<root::u64> ptr = alloc->make_strong<root::u64>(i);
+                root::do_not_optimize(ptr);
+            }
+        };
+    };
+    root::benchmark("system_allocator make_strong<u64>", ITERATIONS, body(&root::system_allocator::universal_instance));
+    root::benchmark("pool_allocator make_strong<u64>", ITERATIONS, body(&pool));
+}
\ No newline at end of file
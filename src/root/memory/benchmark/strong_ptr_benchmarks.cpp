@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <root/core/test/benchmark.h>
+#include <root/memory/strong_ptr.h>
+#include <root/memory/system_allocator.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace root::literals;
+
+constexpr root::u64 ITERATIONS = 1000000;
+constexpr root::u64 LIVE_OBJECTS = 1 << 18;
+
+struct payload {
+    root::u64 m_value;
+    root::u64 m_padding[3];
+};
+
+TEST(strong_ptr_benchmarks, creation) {
+    root::benchmark("make_strong<payload>", ITERATIONS, [](const root::u64& iterations) {
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::strong_ptr<payload> ptr = root::make_strong<payload>();
+            root::do_not_optimize(ptr);
+        }
+    });
+}
+
+/**
+ * Copying a strong_ptr touches the counter and reading through it touches the
+ * object, in random order over a working set much bigger than the caches.
+ */
+TEST(strong_ptr_benchmarks, copy_and_dereference) {
+    std::vector<root::strong_ptr<payload>> ptrs;
+    ptrs.reserve(LIVE_OBJECTS);
+    for(root::u64 i = 0; i < LIVE_OBJECTS; i++) {
+        ptrs.push_back(root::make_strong<payload>());
+        ptrs.back()->m_value = i;
+    }
+    std::shuffle(ptrs.begin(), ptrs.end(), std::mt19937_64(42));
+
+    root::cache_miss_counter misses;
+    misses.start();
+    root::benchmark("strong_ptr copy + dereference", ITERATIONS, [&ptrs](const root::u64& iterations) {
+        root::u64 sum = 0;
+        for(root::u64 i = 0; i < iterations; i++) {
+            root::strong_ptr<payload> copy = ptrs[i % LIVE_OBJECTS];
+            sum += copy->m_value;
+        }
+        root::do_not_optimize(sum);
+    });
+    const root::u64 miss_count = misses.stop();
+    if(misses.available()) {
+        root::log::i("benchmark", "strong_ptr copy + dereference: {} cache misses/op"_fmt, miss_count / (ITERATIONS + ITERATIONS / 10 + 1));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <root/core/test/benchmark.h>
+#include <root/memory/thread_cached_allocator.h>
+#include <root/memory/system_allocator.h>
+
+#include <thread>
+#include <vector>
+
+constexpr root::u64 ITERATIONS = 1000000;
+constexpr root::u64 BATCH = 64;
+constexpr root::u64 THREADS = 4;
+
+static inline auto churn(root::allocator* alloc, const char* name) -> root::u64 {
+    return root::benchmark(name, ITERATIONS, [alloc](const root::u64& iterations) {
+        std::vector<std::thread> threads;
+        for(root::u64 t = 0; t < THREADS; t++) {
+            threads.emplace_back([alloc, iterations]() {
+                void* blocks[BATCH];
+                for(root::u64 i = 0; i < iterations / THREADS; i += BATCH) {
+                    for(root::u64 j = 0; j < BATCH; j++) {
+                        blocks[j] = alloc->malloc(16 + (j % 8) * 16, 8);
+                        root::do_not_optimize(blocks[j]);
+                    }
+                    for(root::u64 j = 0; j < BATCH; j++) {
+                        alloc->free(blocks[j]);
+                    }
+                }
+            });
+        }
+        for(std::thread& thread : threads) {
+            thread.join();
+        }
+    });
+}
+
+TEST(thread_cached_allocator_benchmarks, malloc_free_small_threaded) {
+    root::thread_cached_allocator cached(&root::system_allocator::universal_instance);
+    churn(&root::system_allocator::universal_instance, "system_allocator malloc/free 16-128B x4 threads");
+    churn(&cached, "thread_cached_allocator malloc/free 16-128B x4 threads");
+}
\ No newline at end of file
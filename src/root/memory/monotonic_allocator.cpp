@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/memory/monotonic_allocator.h>
+
+#include <root/core/assert.h>
+
+namespace root {
+
+static inline auto align_up(u8* ptr, const u64& alignment) -> u8* {
+    root_assert((alignment & (alignment - 1)) == 0);
+    return reinterpret_cast<u8*>((reinterpret_cast<u64>(ptr) + alignment - 1) & ~(alignment - 1));
+}
+
+monotonic_allocator::monotonic_allocator(const u64& bytes, allocator* backing_resource)
+:   m_first(nullptr),
+    m_current(nullptr),
+    m_head(nullptr),
+    m_next_block_size(bytes),
+    m_bytes_used(0),
+    m_high_water_mark(0),
+    m_block_count(0),
+    m_backing_resource(backing_resource) {
+    m_first = make_block(bytes);
+    m_current = m_first;
+    m_head = m_first->begin();
+}
+
+auto monotonic_allocator::make_block(const u64& bytes) -> block* {
+    block* b = static_cast<block*>(m_backing_resource->malloc(sizeof(block) + bytes, alignof(block)));
+    root_assert(b);
+    b->m_next = nullptr;
+    b->m_size = bytes;
+    m_block_count++;
+    m_next_block_size = bytes * 2;
+    return b;
+}
+
+auto monotonic_allocator::malloc(const u64& bytes, const u64& alignment) -> void* {
+    u8* ptr = align_up(m_head, alignment);
+    if(ptr + bytes > m_current->end()) {
+        // Blocks kept from before a reset() are reused before asking for more
+        block* next = m_current->m_next;
+        if(!next || align_up(next->begin(), alignment) + bytes > next->end()) {
+            const u64 worst_case = bytes + alignment;
+            next = make_block(m_next_block_size > worst_case ? m_next_block_size : worst_case);
+            next->m_next = m_current->m_next;
+            m_current->m_next = next;
+        }
+        m_bytes_used += m_current->end() - m_head;
+        m_current = next;
+        m_head = m_current->begin();
+        ptr = align_up(m_head, alignment);
+    }
+    m_bytes_used += (ptr + bytes) - m_head;
+    m_head = ptr + bytes;
+    if(m_bytes_used > m_high_water_mark) m_high_water_mark = m_bytes_used;
+    return ptr;
+}
+
+auto monotonic_allocator::reset() -> void {
+    m_current = m_first;
+    m_head = m_first->begin();
+    m_bytes_used = 0;
+}
+
+monotonic_allocator::~monotonic_allocator() {
+    block* b = m_first;
+    while(b) {
+        block* next = b->m_next;
+        m_backing_resource->free(b);
+        b = next;
+    }
+}
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/memory/pool_allocator.h>
+
+#include <root/core/assert.h>
+
+namespace root {
+
+static_assert(pool_allocator::MIN_CLASS_SIZE == 16);
+static_assert(pool_allocator::MAX_CLASS_SIZE == pool_allocator::MIN_CLASS_SIZE << (pool_allocator::NUM_CLASSES - 1));
+
+/**
+ * @return index of the smallest class that fits bytes at the given alignment
+ * or NUM_CLASSES if none does. Blocks in a class are aligned to its size.
+ */
+static inline auto class_index_for(const u64& bytes, const u64& alignment) -> u64 {
+    const u64 size = bytes > alignment ? bytes : alignment;
+    if(size <= pool_allocator::MIN_CLASS_SIZE) return 0;
+    if(size > pool_allocator::MAX_CLASS_SIZE) return pool_allocator::NUM_CLASSES;
+    // ceil(log2(size)) - log2(MIN_CLASS_SIZE)
+    return 64 - __builtin_clzll(size - 1) - 4;
+}
+
+pool_allocator::pool_allocator(allocator* backing_resource)
+:   m_backing_resource(backing_resource) {}
+
+auto pool_allocator::refill(size_class& sc, const u64& class_index) -> bool {
+    u8* memory = static_cast<u8*>(m_backing_resource->malloc(SLAB_SIZE, SLAB_SIZE));
+    if(!memory) return false;
+    slab* s = reinterpret_cast<slab*>(memory);
+    s->m_next = sc.m_slabs;
+    s->m_class_index = class_index;
+    sc.m_slabs = s;
+    sc.m_slab_count++;
+
+    // The first block starts after the header so no pooled block is ever slab aligned
+    const u64 size = class_size(class_index);
+    const u64 first = ((sizeof(slab) + size - 1) / size) * size;
+    for(u64 offset = SLAB_SIZE - size; offset >= first; offset -= size) {
+        free_block* block = reinterpret_cast<free_block*>(memory + offset);
+        block->m_next = sc.m_free_list;
+        sc.m_free_list = block;
+    }
+    return true;
+}
+
+auto pool_allocator::malloc(const u64& bytes, const u64& alignment) -> void* {
+    const u64 index = class_index_for(bytes, alignment);
+    if(index == NUM_CLASSES) {
+        return m_backing_resource->malloc(bytes, alignment > SLAB_SIZE ? alignment : SLAB_SIZE);
+    }
+    size_class& sc = m_classes[index];
+    std::lock_guard<std::mutex> guard(sc.m_lock);
+    if(!sc.m_free_list && !refill(sc, index)) return nullptr;
+    free_block* block = sc.m_free_list;
+    sc.m_free_list = block->m_next;
+    return block;
+}
+
+auto pool_allocator::free(void* mem) -> void {
+    if(!mem) return;
+    const u64 address = reinterpret_cast<u64>(mem);
+    if(address % SLAB_SIZE == 0) {
+        m_backing_resource->free(mem);
+        return;
+    }
+    const slab* s = reinterpret_cast<const slab*>(address & ~(SLAB_SIZE - 1));
+    root_assert(s->m_class_index < NUM_CLASSES);
+    size_class& sc = m_classes[s->m_class_index];
+    free_block* block = static_cast<free_block*>(mem);
+    std::lock_guard<std::mutex> guard(sc.m_lock);
+    block->m_next = sc.m_free_list;
+    sc.m_free_list = block;
+}
+
+auto pool_allocator::slab_count() const -> u64 {
+    u64 count = 0;
+    for(const size_class& sc : m_classes) {
+        count += sc.m_slab_count;
+    }
+    return count;
+}
+
+pool_allocator::~pool_allocator() {
+    for(size_class& sc : m_classes) {
+        slab* s = sc.m_slabs;
+        while(s) {
+            slab* next = s->m_next;
+            m_backing_resource->free(s);
+            s = next;
+        }
+    }
+}
+
+} // namespace root
\ No newline at end of file
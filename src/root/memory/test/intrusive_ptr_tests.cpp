@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <root/memory/intrusive_ptr.h>
+#include <root/memory/test/mock_allocator.h>
+
+#include <thread>
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class intrusive_ptr_tests : public ::testing::Test {
+public:
+    class Class : public root::intrusive_ref_counted<Class> {
+    public:
+        Class(int data, int* destroyed) : m_data(data), m_destroyed(destroyed) {}
+        ~Class() { (*m_destroyed)++; }
+        int m_data;
+        int* m_destroyed;
+    };
+
+    void SetUp() override {
+        memory = ::operator new(sizeof(Class));
+        ON_CALL(allocator, malloc(sizeof(Class), alignof(Class))).WillByDefault(Return(memory));
+    }
+
+    void TearDown() override {
+        ::operator delete(memory);
+    }
+
+    int destroyed = 0;
+    void* memory;
+    NiceMock<root::mock_allocator> allocator;
+};
+
+TEST_F(intrusive_ptr_tests, single_allocation) {
+    EXPECT_CALL(allocator, malloc(sizeof(Class), alignof(Class))).Times(1);
+    EXPECT_CALL(allocator, free(memory)).Times(1);
+    root::intrusive_ptr<Class> ptr = allocator.make_intrusive<Class>(5, &destroyed);
+    EXPECT_EQ(ptr.get(), memory);
+    EXPECT_EQ(ptr->m_data, 5);
+    EXPECT_EQ(ptr->ref_count(), 1);
+    ptr.clear();
+    EXPECT_FALSE(ptr);
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST_F(intrusive_ptr_tests, copies) {
+    root::intrusive_ptr<Class> ptr = allocator.make_intrusive<Class>(5, &destroyed);
+    {
+        root::intrusive_ptr<Class> copy = ptr;
+        EXPECT_EQ(ptr->ref_count(), 2);
+        root::intrusive_ptr<Class> moved = std::move(copy);
+        EXPECT_EQ(ptr->ref_count(), 2);
+        EXPECT_FALSE(copy);
+        moved = ptr;
+        EXPECT_EQ(ptr->ref_count(), 2);
+    }
+    EXPECT_EQ(ptr->ref_count(), 1);
+    EXPECT_EQ(destroyed, 0);
+}
+
+TEST_F(intrusive_ptr_tests, from_raw_pointer) {
+    root::intrusive_ptr<Class> ptr = allocator.make_intrusive<Class>(5, &destroyed);
+    Class* raw = ptr.get();
+    root::intrusive_ptr<Class> owning(raw);
+    EXPECT_EQ(raw->ref_count(), 2);
+    EXPECT_CALL(allocator, free(memory)).Times(1);
+    ptr.clear();
+    EXPECT_EQ(destroyed, 0);
+    owning.clear();
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST_F(intrusive_ptr_tests, not_allocated_objects_are_not_freed) {
+    EXPECT_CALL(allocator, free(::testing::_)).Times(0);
+    Class object(5, &destroyed);
+    {
+        root::intrusive_ptr<Class> ptr(&object);
+        EXPECT_EQ(object.ref_count(), 1);
+    }
+    EXPECT_EQ(object.ref_count(), 0);
+    EXPECT_EQ(destroyed, 0);
+}
+
+TEST_F(intrusive_ptr_tests, multiple_concurrent_copies) {
+    constexpr int NUM_THREADS = 100;
+    root::intrusive_ptr<Class> original = allocator.make_intrusive<Class>(5, &destroyed);
+    root::intrusive_ptr<Class> copies[NUM_THREADS];
+    std::thread threads[NUM_THREADS];
+    for(int i = 0; i < NUM_THREADS; i++) {
+        threads[i] = std::thread([&copies, i, &original](){
+            copies[i] = original;
+        });
+    }
+    for(int i = 0; i < NUM_THREADS; i++) {
+        threads[i].join();
+    }
+    EXPECT_EQ(original->ref_count(), NUM_THREADS + 1);
+    original.clear();
+    EXPECT_CALL(allocator, free(memory)).Times(1);
+    for(int i = 0; i < NUM_THREADS; i++) {
+        threads[i] = std::thread([&copies, i](){
+            copies[i].clear();
+        });
+    }
+    for(int i = 0; i < NUM_THREADS; i++) {
+        threads[i].join();
+    }
+    EXPECT_EQ(destroyed, 1);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <root/memory/local_strong_ptr.h>
+#include <root/memory/private/control_block.h>
+#include <root/memory/test/mock_allocator.h>
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class local_strong_ptr_tests : public ::testing::Test {
+public:
+    class Class {
+    public:
+        Class(int data, int* destroyed) : m_data(data), m_destroyed(destroyed) {}
+        ~Class() { (*m_destroyed)++; }
+        int m_data;
+        int* m_destroyed;
+    };
+
+    using Block = root::control_block<Class, root::local_reference_counter>;
+
+    void SetUp() override {
+        block = static_cast<Block*>(::operator new(sizeof(Block)));
+        counter = &block->m_counter;
+        EXPECT_CALL(allocator, malloc(sizeof(Block), alignof(Block))).Times(1).WillOnce(Return(block));
+    }
+
+    void TearDown() override {
+        ::operator delete(block);
+    }
+
+    int destroyed = 0;
+    Block* block;
+    root::local_reference_counter* counter;
+    NiceMock<root::mock_allocator> allocator;
+};
+
+TEST_F(local_strong_ptr_tests, copies) {
+    EXPECT_CALL(allocator, free(block)).Times(1);
+    root::local_strong_ptr<Class> ptr = allocator.make_local_strong<Class>(5, &destroyed);
+    EXPECT_EQ(ptr->m_data, 5);
+    EXPECT_EQ(counter->strong_refs(), 1);
+    {
+        root::local_strong_ptr<Class> copy = ptr;
+        EXPECT_EQ(counter->strong_refs(), 2);
+        root::local_strong_ptr<Class> moved = std::move(copy);
+        EXPECT_EQ(counter->strong_refs(), 2);
+        EXPECT_FALSE(copy);
+    }
+    EXPECT_EQ(counter->strong_refs(), 1);
+    ptr.clear();
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST_F(local_strong_ptr_tests, weak_outlives_strong) {
+    root::local_strong_ptr<Class> strong = allocator.make_local_strong<Class>(5, &destroyed);
+    root::local_weak_ptr<Class> weak(strong);
+    EXPECT_EQ(counter->weak_refs(), 1);
+    {
+        root::local_strong_ptr<Class> promoted = weak.promote();
+        EXPECT_TRUE(promoted);
+        EXPECT_EQ(counter->strong_refs(), 2);
+    }
+    EXPECT_CALL(allocator, free(block)).Times(0);
+    strong.clear();
+    EXPECT_EQ(destroyed, 1);
+    // A failed promotion drops the last weak reference
+    EXPECT_CALL(allocator, free(block)).Times(1);
+    EXPECT_FALSE(weak.promote());
+    EXPECT_FALSE(weak);
+    EXPECT_EQ(destroyed, 1);
+}
\ No newline at end of file
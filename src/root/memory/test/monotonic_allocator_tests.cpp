@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <root/memory/monotonic_allocator.h>
+#include <root/memory/system_allocator.h>
+#include <root/memory/test/mock_allocator.h>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+class monotonic_allocator_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        ON_CALL(backing, malloc(_, _)).WillByDefault(Invoke([this](const root::u64& bytes, const root::u64& alignment) {
+            mallocs++;
+            return root::system_allocator::universal_instance.malloc(bytes, alignment);
+        }));
+        ON_CALL(backing, free(_)).WillByDefault(Invoke([this](void* mem) {
+            frees++;
+            root::system_allocator::universal_instance.free(mem);
+        }));
+    }
+
+    static constexpr root::u64 ARENA_SIZE = 256;
+    NiceMock<root::mock_allocator> backing;
+    root::u64 mallocs = 0;
+    root::u64 frees = 0;
+};
+
+TEST_F(monotonic_allocator_tests, alignment) {
+    root::monotonic_allocator arena(ARENA_SIZE, &backing);
+    for(root::u64 alignment = 1; alignment <= 64; alignment *= 2) {
+        arena.malloc(1, 1);
+        void* mem = arena.malloc(8, alignment);
+        EXPECT_EQ(reinterpret_cast<root::u64>(mem) % alignment, 0);
+    }
+}
+
+TEST_F(monotonic_allocator_tests, contiguous_allocations) {
+    root::monotonic_allocator arena(ARENA_SIZE, &backing);
+    root::u8* first = static_cast<root::u8*>(arena.malloc(16, 1));
+    root::u8* second = static_cast<root::u8*>(arena.malloc(16, 1));
+    EXPECT_EQ(first + 16, second);
+    EXPECT_EQ(arena.bytes_used(), 32);
+    EXPECT_EQ(arena.block_count(), 1);
+    EXPECT_EQ(mallocs, 1);
+}
+
+TEST_F(monotonic_allocator_tests, chains_blocks_on_overflow) {
+    root::monotonic_allocator arena(ARENA_SIZE, &backing);
+    arena.malloc(ARENA_SIZE - 8, 1);
+    EXPECT_EQ(arena.block_count(), 1);
+    void* overflow = arena.malloc(16, 8);
+    EXPECT_NE(overflow, nullptr);
+    EXPECT_EQ(arena.block_count(), 2);
+    EXPECT_EQ(mallocs, 2);
+
+    // Bigger than any block so far
+    void* huge = arena.malloc(ARENA_SIZE * 8, 16);
+    EXPECT_NE(huge, nullptr);
+    EXPECT_EQ(reinterpret_cast<root::u64>(huge) % 16, 0);
+    EXPECT_EQ(arena.block_count(), 3);
+    memset(huge, 0xff, ARENA_SIZE * 8);
+}
+
+TEST_F(monotonic_allocator_tests, reset_reuses_blocks) {
+    root::monotonic_allocator arena(ARENA_SIZE, &backing);
+    void* first = arena.malloc(ARENA_SIZE, 1);
+    arena.malloc(ARENA_SIZE, 1);
+    arena.malloc(ARENA_SIZE, 1);
+    const root::u64 blocks = arena.block_count();
+    const root::u64 used = arena.bytes_used();
+    EXPECT_GE(used, 3 * ARENA_SIZE);
+
+    arena.reset();
+    EXPECT_EQ(arena.bytes_used(), 0);
+    EXPECT_EQ(arena.high_water_mark(), used);
+    EXPECT_EQ(arena.malloc(ARENA_SIZE, 1), first);
+    arena.malloc(ARENA_SIZE, 1);
+    arena.malloc(ARENA_SIZE, 1);
+    EXPECT_EQ(arena.block_count(), blocks);
+    EXPECT_EQ(mallocs, blocks);
+}
+
+TEST_F(monotonic_allocator_tests, high_water_mark) {
+    root::monotonic_allocator arena(ARENA_SIZE, &backing);
+    arena.malloc(100, 1);
+    arena.reset();
+    arena.malloc(10, 1);
+    EXPECT_EQ(arena.bytes_used(), 10);
+    EXPECT_EQ(arena.high_water_mark(), 100);
+}
+
+TEST_F(monotonic_allocator_tests, releases_all_blocks) {
+    {
+        root::monotonic_allocator arena(ARENA_SIZE, &backing);
+        for(int i = 0; i < 10; i++) {
+            arena.malloc(ARENA_SIZE, 8);
+        }
+    }
+    EXPECT_GT(mallocs, 1);
+    EXPECT_EQ(mallocs, frees);
+}
\ No newline at end of file
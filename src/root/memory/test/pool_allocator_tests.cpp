@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <root/memory/pool_allocator.h>
+#include <root/memory/system_allocator.h>
+#include <root/memory/strong_ptr.h>
+#include <root/memory/test/mock_allocator.h>
+
+#include <thread>
+#include <vector>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+class pool_allocator_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        ON_CALL(backing, malloc(_, _)).WillByDefault(Invoke([this](const root::u64& bytes, const root::u64& alignment) {
+            mallocs++;
+            return root::system_allocator::universal_instance.malloc(bytes, alignment);
+        }));
+        ON_CALL(backing, free(_)).WillByDefault(Invoke([this](void* mem) {
+            frees++;
+            root::system_allocator::universal_instance.free(mem);
+        }));
+    }
+
+    NiceMock<root::mock_allocator> backing;
+    root::u64 mallocs = 0;
+    root::u64 frees = 0;
+};
+
+TEST_F(pool_allocator_tests, one_slab_serves_many_blocks) {
+    root::pool_allocator pool(&backing);
+    for(int i = 0; i < 100; i++) {
+        EXPECT_NE(pool.malloc(32, 8), nullptr);
+    }
+    EXPECT_EQ(pool.slab_count(), 1);
+    EXPECT_EQ(mallocs, 1);
+}
+
+TEST_F(pool_allocator_tests, alignment) {
+    root::pool_allocator pool(&backing);
+    for(root::u64 alignment = 1; alignment <= root::pool_allocator::MAX_CLASS_SIZE; alignment *= 2) {
+        void* mem = pool.malloc(8, alignment);
+        EXPECT_EQ(reinterpret_cast<root::u64>(mem) % alignment, 0);
+        EXPECT_NE(reinterpret_cast<root::u64>(mem) % root::pool_allocator::SLAB_SIZE, 0);
+    }
+}
+
+TEST_F(pool_allocator_tests, reuses_freed_blocks) {
+    root::pool_allocator pool(&backing);
+    void* first = pool.malloc(24, 8);
+    void* second = pool.malloc(24, 8);
+    EXPECT_NE(first, second);
+    pool.free(first);
+    EXPECT_EQ(pool.malloc(24, 8), first);
+    pool.free(second);
+    EXPECT_EQ(pool.malloc(17, 16), second);
+}
+
+TEST_F(pool_allocator_tests, large_allocations_use_backing) {
+    root::pool_allocator pool(&backing);
+    const root::u64 size = root::pool_allocator::MAX_CLASS_SIZE + 1;
+    EXPECT_CALL(backing, malloc(size, root::pool_allocator::SLAB_SIZE));
+    void* mem = pool.malloc(size, 8);
+    EXPECT_NE(mem, nullptr);
+    EXPECT_EQ(frees, 0);
+    pool.free(mem);
+    EXPECT_EQ(frees, 1);
+    EXPECT_EQ(pool.slab_count(), 0);
+}
+
+TEST_F(pool_allocator_tests, make_strong) {
+    root::pool_allocator pool(&backing);
+    {
+        root::strong_ptr<root::u64> ptr = pool.make_strong<root::u64>(42ull);
+        EXPECT_EQ(*ptr, 42);
+    }
+    root::strong_ptr<root::u64> again = pool.make_strong<root::u64>(7ull);
+    EXPECT_EQ(*again, 7);
+    EXPECT_EQ(pool.slab_count(), mallocs);
+}
+
+TEST_F(pool_allocator_tests, releases_all_slabs) {
+    {
+        root::pool_allocator pool(&backing);
+        for(root::u64 size = 1; size <= root::pool_allocator::MAX_CLASS_SIZE; size++) {
+            pool.malloc(size, 1);
+        }
+        EXPECT_GE(pool.slab_count(), root::pool_allocator::NUM_CLASSES);
+        EXPECT_EQ(pool.slab_count(), mallocs);
+    }
+    EXPECT_EQ(mallocs, frees);
+}
+
+TEST_F(pool_allocator_tests, concurrent_malloc_free) {
+    root::pool_allocator pool(&root::system_allocator::universal_instance);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; t++) {
+        threads.emplace_back([&pool, t]() {
+            std::vector<root::u64*> blocks;
+            for(int i = 0; i < 1000; i++) {
+                root::u64* mem = static_cast<root::u64*>(pool.malloc(sizeof(root::u64) * (1 + i % 8), 8));
+                *mem = t;
+                blocks.push_back(mem);
+            }
+            for(root::u64* mem : blocks) {
+                EXPECT_EQ(*mem, t);
+                pool.free(mem);
+            }
+        });
+    }
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+}
\ No newline at end of file
@@ -20,7 +20,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
-#include <root/memory/private/reference_counter.h>
+#include <root/memory/private/control_block.h>
 #include <root/memory/test/mock_allocator.h>
 #include <root/memory/strong_ptr.h>
 
@@ -35,16 +35,19 @@ public:
         int m_data;
     };
 
+    using Block = root::control_block<Class>;
+
     void SetUp() override {
-        counter = new root::reference_counter;
-        memory = new Class(0);
+        block = static_cast<Block*>(::operator new(sizeof(Block)));
+        counter = &block->m_counter;
+        memory = block->object();
     }
 
     void TearDown() override {
-        delete memory;
-        delete counter;
+        ::operator delete(block);
     }
 
+    Block* block;
     root::reference_counter* counter;
     Class* memory;
     root::mock_allocator allocator;
@@ -54,37 +57,31 @@ using ::testing::Return;
 using ::testing::Sequence;
 
 TEST_F(strong_ptr_tests, creation_and_destruction) {
-    Sequence s_ref, s_class;
-    EXPECT_CALL(allocator, malloc(sizeof(Class), alignof(Class))).Times(1).InSequence(s_class).WillOnce(Return(memory));
-    EXPECT_CALL(allocator, malloc(sizeof(root::reference_counter), alignof(root::reference_counter))).Times(1).InSequence(s_ref).WillOnce(Return(counter));
+    Sequence s_ref;
+    EXPECT_CALL(allocator, malloc(sizeof(Block), alignof(Block))).Times(1).InSequence(s_ref).WillOnce(Return(block));
     auto _ = allocator.make_strong<Class>(5);
     EXPECT_EQ(counter->strong_refs(), 1);
     EXPECT_EQ(counter->weak_refs(), 0);
-    EXPECT_CALL(allocator, free(memory)).Times(1).InSequence(s_class);
-    EXPECT_CALL(allocator, free(counter)).Times(1).InSequence(s_ref);
+    EXPECT_CALL(allocator, free(block)).Times(1).InSequence(s_ref);
 }
 
 TEST_F(strong_ptr_tests, validity) {
-    Sequence s_ref, s_class;
-    EXPECT_CALL(allocator, malloc(sizeof(Class), alignof(Class))).Times(1).InSequence(s_class).WillOnce(Return(memory));
-    EXPECT_CALL(allocator, malloc(sizeof(root::reference_counter), alignof(root::reference_counter))).Times(1).InSequence(s_ref).WillOnce(Return(counter));
+    Sequence s_ref;
+    EXPECT_CALL(allocator, malloc(sizeof(Block), alignof(Block))).Times(1).InSequence(s_ref).WillOnce(Return(block));
     auto ptr = allocator.make_strong<Class>(5);
     EXPECT_EQ(counter->strong_refs(), 1);
     EXPECT_EQ(counter->weak_refs(), 0);
     EXPECT_TRUE(ptr);
-    EXPECT_CALL(allocator, free(memory)).Times(1).InSequence(s_class);
-    EXPECT_CALL(allocator, free(counter)).Times(1).InSequence(s_ref);
+    EXPECT_CALL(allocator, free(block)).Times(1).InSequence(s_ref);
 }
 
 TEST_F(strong_ptr_tests, clear) {
-    Sequence s_ref, s_class;
-    EXPECT_CALL(allocator, malloc(sizeof(Class), alignof(Class))).Times(1).InSequence(s_class).WillOnce(Return(memory));
-    EXPECT_CALL(allocator, malloc(sizeof(root::reference_counter), alignof(root::reference_counter))).Times(1).InSequence(s_ref).WillOnce(Return(counter));
+    Sequence s_ref;
+    EXPECT_CALL(allocator, malloc(sizeof(Block), alignof(Block))).Times(1).InSequence(s_ref).WillOnce(Return(block));
     auto ptr = allocator.make_strong<Class>(5);
     EXPECT_EQ(counter->strong_refs(), 1);
     EXPECT_EQ(counter->weak_refs(), 0);
-    EXPECT_CALL(allocator, free(memory)).Times(1).InSequence(s_class);
-    EXPECT_CALL(allocator, free(counter)).Times(1).InSequence(s_ref);
+    EXPECT_CALL(allocator, free(block)).Times(1).InSequence(s_ref);
     ptr.clear();
     EXPECT_EQ(counter->strong_refs(), 0);
     EXPECT_EQ(counter->weak_refs(), 0);
@@ -92,9 +89,8 @@ TEST_F(strong_ptr_tests, clear) {
 }
 
 TEST_F(strong_ptr_tests, single_sequential_copy) {
-    Sequence s_ref, s_class;
-    EXPECT_CALL(allocator, malloc(sizeof(Class), alignof(Class))).Times(1).InSequence(s_class).WillOnce(Return(memory));
-    EXPECT_CALL(allocator, malloc(sizeof(root::reference_counter), alignof(root::reference_counter))).Times(1).InSequence(s_ref).WillOnce(Return(counter));
+    Sequence s_ref;
+    EXPECT_CALL(allocator, malloc(sizeof(Block), alignof(Block))).Times(1).InSequence(s_ref).WillOnce(Return(block));
     auto original = allocator.make_strong<Class>(5);
     {
         auto copy = original;
@@ -110,15 +106,13 @@ TEST_F(strong_ptr_tests, single_sequential_copy) {
     EXPECT_EQ(counter->strong_refs(), 1);
     EXPECT_EQ(counter->weak_refs(), 0);
     EXPECT_FALSE(second_copy);
-    EXPECT_CALL(allocator, free(memory)).Times(1).InSequence(s_class);
-    EXPECT_CALL(allocator, free(counter)).Times(1).InSequence(s_ref);
+    EXPECT_CALL(allocator, free(block)).Times(1).InSequence(s_ref);
 }
 
 TEST_F(strong_ptr_tests, multiple_concurrent_copies){
     constexpr int NUM_THREADS = 100;
-    Sequence s_ref, s_class;
-    EXPECT_CALL(allocator, malloc(sizeof(Class), alignof(Class))).Times(1).InSequence(s_class).WillOnce(Return(memory));
-    EXPECT_CALL(allocator, malloc(sizeof(root::reference_counter), alignof(root::reference_counter))).Times(1).InSequence(s_ref).WillOnce(Return(counter));
+    Sequence s_ref;
+    EXPECT_CALL(allocator, malloc(sizeof(Block), alignof(Block))).Times(1).InSequence(s_ref).WillOnce(Return(block));
     auto original = allocator.make_strong<Class>(5);
     root::strong_ptr<Class> copies[NUM_THREADS];
     std::thread threads[NUM_THREADS];
@@ -135,8 +129,7 @@ TEST_F(strong_ptr_tests, multiple_concurrent_copies){
     original = root::strong_ptr<Class>();;
     EXPECT_EQ(counter->strong_refs(), NUM_THREADS);
     EXPECT_EQ(counter->weak_refs(), 0);
-    EXPECT_CALL(allocator, free(memory)).Times(1).InSequence(s_class);
-    EXPECT_CALL(allocator, free(counter)).Times(1).InSequence(s_ref);
+    EXPECT_CALL(allocator, free(block)).Times(1).InSequence(s_ref);
     for(int i = 0; i < NUM_THREADS; i++) {
         threads[i] = std::thread([&copies, i](){
             copies[i] = root::strong_ptr<Class>();
@@ -150,13 +143,12 @@ TEST_F(strong_ptr_tests, multiple_concurrent_copies){
 }
 
 TEST_F(strong_ptr_tests, dereference) {
-    Sequence s_ref, s_class;
+    Sequence s_ref;
     constexpr int INITIAL_VALUE = 5;
     constexpr int SECOND_VALUE = 42;
     constexpr int THIRD_VALUE = 7;
     constexpr int LAST_VALUE = 360;
-    EXPECT_CALL(allocator, malloc(sizeof(Class), alignof(Class))).Times(1).InSequence(s_class).WillOnce(Return(memory));
-    EXPECT_CALL(allocator, malloc(sizeof(root::reference_counter), alignof(root::reference_counter))).Times(1).InSequence(s_ref).WillOnce(Return(counter));
+    EXPECT_CALL(allocator, malloc(sizeof(Block), alignof(Block))).Times(1).InSequence(s_ref).WillOnce(Return(block));
     auto ptr = allocator.make_strong<Class>(5);
     EXPECT_EQ(counter->strong_refs(), 1);
     EXPECT_EQ(counter->weak_refs(), 0);
@@ -174,6 +166,14 @@ TEST_F(strong_ptr_tests, dereference) {
     EXPECT_EQ(LAST_VALUE, ptr->m_data);
     EXPECT_EQ(LAST_VALUE, (*ptr).m_data);
     EXPECT_EQ(LAST_VALUE, memory->m_data);
-    EXPECT_CALL(allocator, free(memory)).Times(1).InSequence(s_class);
-    EXPECT_CALL(allocator, free(counter)).Times(1).InSequence(s_ref);
+    EXPECT_CALL(allocator, free(block)).Times(1).InSequence(s_ref);
+}
+
+TEST_F(strong_ptr_tests, single_allocation) {
+    EXPECT_CALL(allocator, malloc(sizeof(Block), alignof(Block))).Times(1).WillOnce(Return(block));
+    auto ptr = allocator.make_strong<Class>(5);
+    EXPECT_EQ(ptr.get(), memory);
+    EXPECT_EQ(static_cast<void*>(counter), static_cast<void*>(block));
+    EXPECT_EQ(reinterpret_cast<root::u64>(ptr.get()) % alignof(Class), 0);
+    EXPECT_CALL(allocator, free(block)).Times(1);
 }
\ No newline at end of file
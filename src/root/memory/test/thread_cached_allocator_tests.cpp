@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <root/memory/thread_cached_allocator.h>
+#include <root/memory/system_allocator.h>
+#include <root/memory/test/mock_allocator.h>
+#include <root/core/array.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+class thread_cached_allocator_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        ON_CALL(backing, malloc(_, _)).WillByDefault(Invoke([this](const root::u64& bytes, const root::u64& alignment) {
+            mallocs++;
+            return root::system_allocator::universal_instance.malloc(bytes, alignment);
+        }));
+        ON_CALL(backing, free(_)).WillByDefault(Invoke([this](void* mem) {
+            frees++;
+            root::system_allocator::universal_instance.free(mem);
+        }));
+    }
+
+    NiceMock<root::mock_allocator> backing;
+    std::atomic<root::u64> mallocs{0};
+    std::atomic<root::u64> frees{0};
+};
+
+TEST_F(thread_cached_allocator_tests, refills_in_batches) {
+    root::thread_cached_allocator cached(&backing);
+    void* mem = cached.malloc(24, 8);
+    EXPECT_NE(mem, nullptr);
+    EXPECT_EQ(mallocs, root::thread_cached_allocator::BATCH_SIZE);
+    for(root::u64 i = 1; i < root::thread_cached_allocator::BATCH_SIZE; i++) {
+        cached.malloc(24, 8);
+    }
+    EXPECT_EQ(mallocs, root::thread_cached_allocator::BATCH_SIZE);
+}
+
+TEST_F(thread_cached_allocator_tests, reuses_freed_blocks) {
+    root::thread_cached_allocator cached(&backing);
+    void* first = cached.malloc(100, 8);
+    cached.free(first);
+    EXPECT_EQ(cached.malloc(120, 16), first);
+    const root::u64 before = mallocs;
+    for(int i = 0; i < 1000; i++) {
+        cached.free(cached.malloc(100, 8));
+    }
+    EXPECT_EQ(mallocs, before);
+    EXPECT_EQ(frees, 0);
+}
+
+TEST_F(thread_cached_allocator_tests, alignment) {
+    root::thread_cached_allocator cached(&backing);
+    for(root::u64 alignment = 1; alignment <= 4096; alignment *= 2) {
+        void* mem = cached.malloc(8, alignment);
+        EXPECT_EQ(reinterpret_cast<root::u64>(mem) % alignment, 0);
+        cached.free(mem);
+    }
+}
+
+TEST_F(thread_cached_allocator_tests, large_allocations_use_backing) {
+    root::thread_cached_allocator cached(&backing);
+    void* mem = cached.malloc(root::thread_cached_allocator::MAX_CLASS_SIZE + 1, 8);
+    EXPECT_EQ(mallocs, 1);
+    memset(mem, 0xff, root::thread_cached_allocator::MAX_CLASS_SIZE + 1);
+    cached.free(mem);
+    EXPECT_EQ(frees, 1);
+}
+
+TEST_F(thread_cached_allocator_tests, cross_thread_free) {
+    root::thread_cached_allocator cached(&backing);
+    std::vector<void*> blocks;
+    for(int i = 0; i < 1000; i++) {
+        blocks.push_back(cached.malloc(32, 8));
+    }
+    std::thread consumer([&cached, &blocks]() {
+        for(void* mem : blocks) {
+            cached.free(mem);
+        }
+    });
+    consumer.join();
+
+    // The consumer flushed its magazines to the depot when it exited
+    const root::u64 before = mallocs;
+    for(int i = 0; i < 1000; i++) {
+        cached.malloc(32, 8);
+    }
+    EXPECT_EQ(mallocs, before);
+}
+
+TEST_F(thread_cached_allocator_tests, concurrent_malloc_free) {
+    root::thread_cached_allocator cached(&backing);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; t++) {
+        threads.emplace_back([&cached, t]() {
+            std::vector<root::u64*> blocks;
+            for(int i = 0; i < 1000; i++) {
+                root::u64* mem = static_cast<root::u64*>(cached.malloc(sizeof(root::u64) * (1 + i % 32), 8));
+                *mem = t;
+                blocks.push_back(mem);
+            }
+            for(root::u64* mem : blocks) {
+                EXPECT_EQ(*mem, t);
+                cached.free(mem);
+            }
+        });
+    }
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+TEST_F(thread_cached_allocator_tests, releases_everything) {
+    {
+        root::thread_cached_allocator cached(&backing);
+        std::thread worker([&cached]() {
+            for(root::u64 size = 1; size < 2048; size++) {
+                cached.free(cached.malloc(size, 8));
+            }
+        });
+        worker.join();
+        for(root::u64 size = 1; size < 2048; size++) {
+            cached.free(cached.malloc(size, 8));
+        }
+    }
+    EXPECT_GT(mallocs, 0);
+    EXPECT_EQ(mallocs, frees);
+}
+
+TEST_F(thread_cached_allocator_tests, as_default_allocator) {
+    root::allocator* previous = root::allocator::get_default();
+    {
+        root::thread_cached_allocator cached(&backing);
+        root::allocator::set_default(&cached);
+        {
+            root::array<root::u64> values(16);
+            values[15] = 42;
+            EXPECT_EQ(values[15], 42);
+        }
+        root::allocator::set_default(previous);
+    }
+    EXPECT_GT(mallocs, 0);
+    EXPECT_EQ(mallocs, frees);
+}
\ No newline at end of file
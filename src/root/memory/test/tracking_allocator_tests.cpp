@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <root/memory/tracking_allocator.h>
+#include <root/memory/system_allocator.h>
+#include <root/memory/test/mock_allocator.h>
+
+#include <thread>
+#include <vector>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+class tracking_allocator_tests : public ::testing::Test {
+public:
+    void SetUp() override {
+        ON_CALL(backing, malloc(_, _)).WillByDefault(Invoke([this](const root::u64& bytes, const root::u64& alignment) {
+            mallocs++;
+            return root::system_allocator::universal_instance.malloc(bytes, alignment);
+        }));
+        ON_CALL(backing, free(_)).WillByDefault(Invoke([this](void* mem) {
+            frees++;
+            root::system_allocator::universal_instance.free(mem);
+        }));
+    }
+
+    NiceMock<root::mock_allocator> backing;
+    std::atomic<root::u64> mallocs{0};
+    std::atomic<root::u64> frees{0};
+};
+
+TEST_F(tracking_allocator_tests, live_and_peak_bytes) {
+    root::tracking_allocator tracker("test", &backing);
+    void* first = tracker.malloc(100, 8);
+    void* second = tracker.malloc(50, 8);
+    EXPECT_EQ(tracker.live_bytes(), 150);
+    EXPECT_EQ(tracker.live_allocations(), 2);
+    tracker.free(first);
+    EXPECT_EQ(tracker.live_bytes(), 50);
+    EXPECT_EQ(tracker.peak_bytes(), 150);
+    tracker.free(second);
+    EXPECT_EQ(tracker.live_bytes(), 0);
+    EXPECT_EQ(tracker.live_allocations(), 0);
+    EXPECT_EQ(tracker.total_allocations(), 2);
+    EXPECT_EQ(mallocs, 2);
+    EXPECT_EQ(frees, 2);
+}
+
+TEST_F(tracking_allocator_tests, alignment) {
+    root::tracking_allocator tracker("test", &backing);
+    for(root::u64 alignment = 1; alignment <= 4096; alignment *= 2) {
+        void* mem = tracker.malloc(8, alignment);
+        EXPECT_EQ(reinterpret_cast<root::u64>(mem) % alignment, 0);
+        tracker.free(mem);
+    }
+    EXPECT_EQ(mallocs, frees);
+}
+
+TEST_F(tracking_allocator_tests, histogram) {
+    root::tracking_allocator tracker("test", &backing);
+    tracker.free(tracker.malloc(1, 1));
+    tracker.free(tracker.malloc(16, 1));
+    tracker.free(tracker.malloc(17, 1));
+    tracker.free(tracker.malloc(1 << 30, 1));
+    EXPECT_EQ(tracker.histogram(0), 2);
+    EXPECT_EQ(tracker.histogram(1), 1);
+    EXPECT_EQ(tracker.histogram(root::tracking_allocator::NUM_BUCKETS - 1), 1);
+}
+
+TEST_F(tracking_allocator_tests, tags) {
+    root::tracking_allocator tracker("test", &backing);
+    root::tracking_allocator::tag textures = tracker.tagged("textures");
+    root::tracking_allocator::tag meshes = tracker.tagged("meshes");
+    void* texture = textures.malloc(1024, 16);
+    void* mesh = meshes.malloc(256, 16);
+    void* again = tracker.tagged("textures").malloc(1024, 16);
+    EXPECT_EQ(tracker.live_bytes(), 2304);
+    EXPECT_EQ(tracker.tag_stats("textures")->m_live_bytes, 2048);
+    EXPECT_EQ(tracker.tag_stats("meshes")->m_live_bytes, 256);
+    EXPECT_EQ(tracker.tag_stats("sounds"), nullptr);
+
+    // Memory can be freed through the tag or the tracker
+    textures.free(texture);
+    tracker.free(again);
+    meshes.free(mesh);
+    EXPECT_EQ(tracker.tag_stats("textures")->m_live_bytes, 0);
+    EXPECT_EQ(tracker.tag_stats("textures")->m_peak_bytes, 2048);
+    EXPECT_EQ(tracker.tag_stats("textures")->m_total_allocations, 2);
+    EXPECT_EQ(tracker.live_bytes(), 0);
+}
+
+TEST_F(tracking_allocator_tests, leaks_are_not_freed) {
+    void* leaked;
+    {
+        root::tracking_allocator tracker("leaky", &backing);
+        tracker.free(tracker.malloc(32, 8));
+        leaked = tracker.malloc(64, 8);
+        tracker.report();
+    }
+    EXPECT_EQ(mallocs, 2);
+    EXPECT_EQ(frees, 1);
+    backing.free(static_cast<root::u8*>(leaked) - 32);
+}
+
+TEST_F(tracking_allocator_tests, concurrent_malloc_free) {
+    root::tracking_allocator tracker("test", &backing);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; t++) {
+        threads.emplace_back([&tracker]() {
+            std::vector<void*> blocks;
+            for(int i = 0; i < 1000; i++) {
+                blocks.push_back(tracker.malloc(1 + i % 64, 8));
+            }
+            for(void* mem : blocks) {
+                tracker.free(mem);
+            }
+        });
+    }
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(tracker.live_bytes(), 0);
+    EXPECT_EQ(tracker.total_allocations(), 4000);
+    EXPECT_EQ(mallocs, frees);
+}
\ No newline at end of file
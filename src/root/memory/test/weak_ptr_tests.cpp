@@ -20,7 +20,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
-#include <root/memory/private/reference_counter.h>
+#include <root/memory/private/control_block.h>
 #include <root/memory/test/mock_allocator.h>
 #include <root/memory/strong_ptr.h>
 #include <root/memory/weak_ptr.h>
@@ -35,25 +35,30 @@ class weak_ptr_tests : public Test {
 public:
     class Class {
     public:
-        Class(int data) : m_data(data) {}
+        Class(int data, int* destroyed) : m_data(data), m_destroyed(destroyed) {}
+        ~Class() { (*m_destroyed)++; }
         int m_data;
+        int* m_destroyed;
     };
 
+    using Block = root::control_block<Class>;
+
     void SetUp() override {
-        counter = new root::reference_counter;
-        memory = new Class(0);
-        ON_CALL(allocator, malloc(sizeof(Class), alignof(Class))).WillByDefault(Return(memory));
-        ON_CALL(allocator, malloc(sizeof(root::reference_counter), alignof(Class))).WillByDefault(Return(counter));
-        strong = allocator.make_strong<Class>(data);
+        block = static_cast<Block*>(::operator new(sizeof(Block)));
+        counter = &block->m_counter;
+        memory = block->object();
+        ON_CALL(allocator, malloc(sizeof(Block), alignof(Block))).WillByDefault(Return(block));
+        strong = allocator.make_strong<Class>(data, &destroyed);
     }
 
     void TearDown() override {
         strong.clear();
-        delete memory;
-        delete counter;
+        ::operator delete(block);
     }
 
     int data = 5;
+    int destroyed = 0;
+    Block* block;
     root::reference_counter* counter;
     Class* memory;
     root::strong_ptr<Class> strong;
@@ -81,12 +86,14 @@ TEST_F(weak_ptr_tests, destroy_strong_first) {
     root::weak_ptr<Class> weak(strong);
     EXPECT_EQ(counter->strong_refs(), 1);
     EXPECT_EQ(counter->weak_refs(), 1);
-    EXPECT_CALL(allocator, free(memory)).Times(1);
+    EXPECT_CALL(allocator, free(block)).Times(0);
     strong = root::strong_ptr<Class>();
     EXPECT_EQ(counter->strong_refs(), 0);
     EXPECT_EQ(counter->weak_refs(), 1);
-    EXPECT_CALL(allocator, free(counter)).Times(1);
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_CALL(allocator, free(block)).Times(1);
     weak.clear();
+    EXPECT_EQ(destroyed, 1);
     EXPECT_EQ(counter->strong_refs(), 0);
     EXPECT_EQ(counter->weak_refs(), 0);
 }
@@ -125,15 +132,15 @@ TEST_F(weak_ptr_tests, multithread_release) {
     EXPECT_EQ(counter->strong_refs(), 1);
     EXPECT_EQ(counter->weak_refs(), NUM_THREADS);
 
-    EXPECT_CALL(allocator, free(memory)).Times(1);
+    EXPECT_CALL(allocator, free(block)).Times(0);
 
     strong.clear();
 
     EXPECT_EQ(counter->strong_refs(), 0);
     EXPECT_EQ(counter->weak_refs(), NUM_THREADS);
+    EXPECT_EQ(destroyed, 1);
 
-
-    EXPECT_CALL(allocator, free(counter)).Times(1);
+    EXPECT_CALL(allocator, free(block)).Times(1);
 
     for(int i = 0; i < NUM_THREADS; i++) {
         threads[i] = std::thread([&weaks, i](){
@@ -179,8 +186,7 @@ TEST_F(weak_ptr_tests, multithread_interleaved_release) {
     EXPECT_EQ(counter->strong_refs(), NUM_THREADS/2);
     EXPECT_EQ(counter->weak_refs(), NUM_THREADS/2);
 
-    EXPECT_CALL(allocator, free(memory)).Times(1);
-    EXPECT_CALL(allocator, free(counter)).Times(1);
+    EXPECT_CALL(allocator, free(block)).Times(1);
 
     for(int i = 0; i < NUM_THREADS; i++) {
         threads[i] = std::thread([&weaks, &strongs, i](){
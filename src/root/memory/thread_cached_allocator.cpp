@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/memory/thread_cached_allocator.h>
+
+#include <root/core/assert.h>
+
+#include <atomic>
+#include <vector>
+
+namespace root {
+
+constexpr u64 LARGE_CLASS = thread_cached_allocator::NUM_CLASSES;
+
+static_assert(thread_cached_allocator::MIN_CLASS_SIZE == 16);
+static_assert(thread_cached_allocator::MAX_CLASS_SIZE == thread_cached_allocator::MIN_CLASS_SIZE << (thread_cached_allocator::NUM_CLASSES - 1));
+
+struct block_header {
+    void* m_base;
+    u64 m_class_index;
+};
+
+static_assert(sizeof(block_header) == thread_cached_allocator::HEADER_SIZE);
+
+static inline auto header_of(void* mem) -> block_header* {
+    return reinterpret_cast<block_header*>(static_cast<u8*>(mem) - sizeof(block_header));
+}
+
+/**
+ * Blocks from the classes are only guaranteed HEADER_SIZE alignment, anything
+ * stricter is handled as a large allocation.
+ */
+static inline auto class_index_for(const u64& bytes, const u64& alignment) -> u64 {
+    if(alignment > thread_cached_allocator::HEADER_SIZE) return LARGE_CLASS;
+    if(bytes <= thread_cached_allocator::MIN_CLASS_SIZE) return 0;
+    if(bytes > thread_cached_allocator::MAX_CLASS_SIZE) return LARGE_CLASS;
+    return 64 - __builtin_clzll(bytes - 1) - 4;
+}
+
+/**
+ * Guards the links between allocators and thread caches. Only taken when a
+ * thread first uses an allocator, on thread exit and on allocator destruction.
+ */
+static auto registry_lock() -> std::mutex& {
+    static std::mutex lock;
+    return lock;
+}
+
+static std::atomic<u64> s_next_id{1};
+
+/**
+ * Per thread list of caches, one for every allocator the thread has used.
+ * Caches whose allocator is gone stay here with a null owner until thread exit.
+ */
+struct thread_cache_list {
+    std::vector<thread_cached_allocator::thread_cache*> m_caches;
+    thread_cached_allocator::thread_cache* m_last{nullptr};
+
+    ~thread_cache_list();
+};
+
+static thread_local thread_cache_list t_caches;
+static thread_local bool t_caches_destroyed = false;
+
+thread_cache_list::~thread_cache_list() {
+    t_caches_destroyed = true;
+    std::lock_guard<std::mutex> guard(registry_lock());
+    for(thread_cached_allocator::thread_cache* cache : m_caches) {
+        if(cache->m_owner) cache->m_owner->flush(cache);
+        delete cache;
+    }
+}
+
+thread_cached_allocator::thread_cached_allocator(allocator* backing_resource)
+:   m_caches(nullptr),
+    m_id(s_next_id.fetch_add(1, std::memory_order_relaxed)),
+    m_backing_resource(backing_resource) {}
+
+auto thread_cached_allocator::local_cache() -> thread_cache* {
+    if(t_caches_destroyed) return nullptr;
+    thread_cache* last = t_caches.m_last;
+    if(last && last->m_owner_id == m_id) return last;
+    for(thread_cache* cache : t_caches.m_caches) {
+        if(cache->m_owner_id == m_id) {
+            t_caches.m_last = cache;
+            return cache;
+        }
+    }
+
+    thread_cache* cache = new thread_cache{this, m_id, nullptr, nullptr, {}};
+    {
+        std::lock_guard<std::mutex> guard(registry_lock());
+        cache->m_next = m_caches;
+        if(m_caches) m_caches->m_prev = cache;
+        m_caches = cache;
+    }
+    t_caches.m_caches.push_back(cache);
+    t_caches.m_last = cache;
+    return cache;
+}
+
+auto thread_cached_allocator::make_block(const u64& class_index) -> free_block* {
+    block_header* header = static_cast<block_header*>(m_backing_resource->malloc(HEADER_SIZE + class_size(class_index), HEADER_SIZE));
+    if(!header) return nullptr;
+    header->m_base = header;
+    header->m_class_index = class_index;
+    return reinterpret_cast<free_block*>(header + 1);
+}
+
+auto thread_cached_allocator::refill(magazine& mag, const u64& class_index, const u64& count) -> bool {
+    depot& d = m_depots[class_index];
+    {
+        std::lock_guard<std::mutex> guard(d.m_lock);
+        while(d.m_blocks.m_head && mag.m_count < count) {
+            free_block* block = d.m_blocks.m_head;
+            d.m_blocks.m_head = block->m_next;
+            d.m_blocks.m_count--;
+            block->m_next = mag.m_head;
+            mag.m_head = block;
+            mag.m_count++;
+        }
+    }
+    while(mag.m_count < count) {
+        free_block* block = make_block(class_index);
+        if(!block) break;
+        block->m_next = mag.m_head;
+        mag.m_head = block;
+        mag.m_count++;
+    }
+    return mag.m_head;
+}
+
+auto thread_cached_allocator::drain(magazine& mag, const u64& class_index, const u64& count) -> void {
+    depot& d = m_depots[class_index];
+    free_block* overflow = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(d.m_lock);
+        for(u64 i = 0; i < count && mag.m_head; i++) {
+            free_block* block = mag.m_head;
+            mag.m_head = block->m_next;
+            mag.m_count--;
+            if(d.m_blocks.m_count < DEPOT_LIMIT) {
+                block->m_next = d.m_blocks.m_head;
+                d.m_blocks.m_head = block;
+                d.m_blocks.m_count++;
+            } else {
+                block->m_next = overflow;
+                overflow = block;
+            }
+        }
+    }
+    // The backing allocator is called outside the depot lock
+    while(overflow) {
+        free_block* next = overflow->m_next;
+        m_backing_resource->free(header_of(overflow));
+        overflow = next;
+    }
+}
+
+auto thread_cached_allocator::malloc(const u64& bytes, const u64& alignment) -> void* {
+    const u64 class_index = class_index_for(bytes, alignment);
+    if(class_index == LARGE_CLASS) {
+        const u64 offset = alignment > HEADER_SIZE ? alignment : HEADER_SIZE;
+        u8* base = static_cast<u8*>(m_backing_resource->malloc(offset + bytes, offset));
+        if(!base) return nullptr;
+        block_header* header = header_of(base + offset);
+        header->m_base = base;
+        header->m_class_index = LARGE_CLASS;
+        return base + offset;
+    }
+
+    thread_cache* cache = local_cache();
+    if(!cache) {
+        magazine single;
+        return refill(single, class_index, 1) ? single.m_head : nullptr;
+    }
+    magazine& mag = cache->m_magazines[class_index];
+    if(!mag.m_head && !refill(mag, class_index, BATCH_SIZE)) return nullptr;
+    free_block* block = mag.m_head;
+    mag.m_head = block->m_next;
+    mag.m_count--;
+    return block;
+}
+
+auto thread_cached_allocator::free(void* mem) -> void {
+    if(!mem) return;
+    block_header* header = header_of(mem);
+    const u64 class_index = header->m_class_index;
+    if(class_index == LARGE_CLASS) {
+        m_backing_resource->free(header->m_base);
+        return;
+    }
+    root_assert(class_index < NUM_CLASSES);
+
+    free_block* block = static_cast<free_block*>(mem);
+    thread_cache* cache = local_cache();
+    if(!cache) {
+        block->m_next = nullptr;
+        magazine single{block, 1};
+        drain(single, class_index, 1);
+        return;
+    }
+    magazine& mag = cache->m_magazines[class_index];
+    if(mag.m_count == MAGAZINE_SIZE) drain(mag, class_index, BATCH_SIZE);
+    block->m_next = mag.m_head;
+    mag.m_head = block;
+    mag.m_count++;
+}
+
+auto thread_cached_allocator::flush(thread_cache* cache) -> void {
+    for(u64 class_index = 0; class_index < NUM_CLASSES; class_index++) {
+        magazine& mag = cache->m_magazines[class_index];
+        const u64 count = mag.m_count;
+        drain(mag, class_index, count);
+    }
+    if(cache->m_prev) cache->m_prev->m_next = cache->m_next;
+    else m_caches = cache->m_next;
+    if(cache->m_next) cache->m_next->m_prev = cache->m_prev;
+    cache->m_owner = nullptr;
+}
+
+thread_cached_allocator::~thread_cached_allocator() {
+    {
+        std::lock_guard<std::mutex> guard(registry_lock());
+        while(m_caches) {
+            flush(m_caches);
+        }
+    }
+    for(u64 class_index = 0; class_index < NUM_CLASSES; class_index++) {
+        free_block* block = m_depots[class_index].m_blocks.m_head;
+        while(block) {
+            free_block* next = block->m_next;
+            m_backing_resource->free(header_of(block));
+            block = next;
+        }
+    }
+}
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/memory/tracking_allocator.h>
+
+#include <root/core/assert.h>
+#include <root/io/log.h>
+
+namespace root {
+
+constexpr u64 MAX_REPORTED_LEAKS = 16;
+
+static inline auto bucket_for(const u64& bytes) -> u64 {
+    if(bytes <= 16) return 0;
+    const u64 bucket = 64 - __builtin_clzll(bytes - 1) - 4;
+    return bucket < tracking_allocator::NUM_BUCKETS ? bucket : tracking_allocator::NUM_BUCKETS - 1;
+}
+
+tracking_allocator::tag::tag(tracking_allocator* parent, const u32& index)
+:   m_parent(parent), m_index(index) {}
+
+auto tracking_allocator::tag::malloc(const u64& bytes, const u64& alignment) -> void* {
+    return m_parent->tracked_malloc(bytes, alignment, m_index);
+}
+
+auto tracking_allocator::tag::free(void* mem) -> void {
+    m_parent->free(mem);
+}
+
+tracking_allocator::tracking_allocator(const string_view& name, allocator* backing_resource)
+:   m_name(name),
+    m_backing_resource(backing_resource),
+    m_histogram{},
+    m_tag_count(1),
+    m_live(nullptr) {}
+
+auto tracking_allocator::tagged(const string_view& name) -> tag {
+    std::lock_guard<std::mutex> guard(m_lock);
+    for(u32 index = 1; index < m_tag_count; index++) {
+        if(m_tag_names[index] == name) return tag(this, index);
+    }
+    if(m_tag_count > MAX_TAGS) return tag(this, UNTAGGED);
+    m_tag_names[m_tag_count] = name;
+    return tag(this, m_tag_count++);
+}
+
+auto tracking_allocator::tag_stats(const string_view& name) const -> const stats* {
+    std::lock_guard<std::mutex> guard(m_lock);
+    for(u32 index = 1; index < m_tag_count; index++) {
+        if(m_tag_names[index] == name) return &m_stats[index];
+    }
+    return nullptr;
+}
+
+auto tracking_allocator::record(stats& s, const i64& bytes, const i64& count) -> void {
+    const u64 live = s.m_live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    s.m_live_allocations.fetch_add(count, std::memory_order_relaxed);
+    if(count > 0) {
+        s.m_total_allocations.fetch_add(1, std::memory_order_relaxed);
+        u64 peak = s.m_peak_bytes.load(std::memory_order_relaxed);
+        while(live > peak && !s.m_peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+}
+
+auto tracking_allocator::malloc(const u64& bytes, const u64& alignment) -> void* {
+    return tracked_malloc(bytes, alignment, UNTAGGED);
+}
+
+auto tracking_allocator::tracked_malloc(const u64& bytes, const u64& alignment, const u32& tag_index) -> void* {
+    // The header goes right before the returned pointer, keeping its alignment
+    const u64 align = alignment > alignof(header) ? alignment : alignof(header);
+    const u64 offset = ((sizeof(header) + align - 1) / align) * align;
+    u8* base = static_cast<u8*>(m_backing_resource->malloc(offset + bytes, align));
+    if(!base) return nullptr;
+    header* h = reinterpret_cast<header*>(base + offset) - 1;
+    h->m_size = bytes;
+    h->m_tag = tag_index;
+    h->m_offset = static_cast<u32>(offset);
+    h->m_prev = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        h->m_next = m_live;
+        if(m_live) m_live->m_prev = h;
+        m_live = h;
+    }
+    record(m_stats[UNTAGGED], bytes, 1);
+    if(tag_index != UNTAGGED) record(m_stats[tag_index], bytes, 1);
+    m_histogram[bucket_for(bytes)].fetch_add(1, std::memory_order_relaxed);
+    return base + offset;
+}
+
+auto tracking_allocator::free(void* mem) -> void {
+    if(!mem) return;
+    header* h = static_cast<header*>(mem) - 1;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if(h->m_prev) h->m_prev->m_next = h->m_next;
+        else m_live = h->m_next;
+        if(h->m_next) h->m_next->m_prev = h->m_prev;
+    }
+    const i64 bytes = static_cast<i64>(h->m_size);
+    record(m_stats[UNTAGGED], -bytes, -1);
+    if(h->m_tag != UNTAGGED) record(m_stats[h->m_tag], -bytes, -1);
+    m_backing_resource->free(static_cast<u8*>(mem) - h->m_offset);
+}
+
+auto tracking_allocator::report() const -> void {
+    log::i("tracking_allocator", "{}: {} bytes in {} allocations live, {} bytes peak, {} allocations total"_fmt,
+           m_name, live_bytes(), live_allocations(), peak_bytes(), total_allocations());
+    std::lock_guard<std::mutex> guard(m_lock);
+    for(u32 index = 1; index < m_tag_count; index++) {
+        const stats& s = m_stats[index];
+        log::i("tracking_allocator", "{}/{}: {} bytes in {} allocations live, {} bytes peak, {} allocations total"_fmt,
+               m_name, m_tag_names[index], s.m_live_bytes.load(), s.m_live_allocations.load(),
+               s.m_peak_bytes.load(), s.m_total_allocations.load());
+    }
+    for(u64 bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+        const u64 count = histogram(bucket);
+        if(!count) continue;
+        if(bucket == NUM_BUCKETS - 1) {
+            log::i("tracking_allocator", "{}: >{} bytes: {}"_fmt, m_name, 16ull << (bucket - 1), count);
+        } else {
+            log::i("tracking_allocator", "{}: <={} bytes: {}"_fmt, m_name, 16ull << bucket, count);
+        }
+    }
+}
+
+tracking_allocator::~tracking_allocator() {
+    if(!live_allocations()) return;
+    log::w("tracking_allocator", "{}: leaked {} bytes in {} allocations"_fmt, m_name, live_bytes(), live_allocations());
+    u64 reported = 0;
+    for(const header* h = m_live; h && reported < MAX_REPORTED_LEAKS; h = h->m_next, reported++) {
+        const u8* mem = reinterpret_cast<const u8*>(h + 1);
+        if(h->m_tag != UNTAGGED) {
+            log::w("tracking_allocator", "{}: leaked {} bytes at {} ({})"_fmt, m_name, h->m_size, mem, m_tag_names[h->m_tag]);
+        } else {
+            log::w("tracking_allocator", "{}: leaked {} bytes at {}"_fmt, m_name, h->m_size, mem);
+        }
+    }
+    if(live_allocations() > reported) {
+        log::w("tracking_allocator", "{}: ... and {} more"_fmt, m_name, live_allocations() - reported);
+    }
+}
+
+} // namespace root
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/io/binary_log_decoder.h>
+#include <root/io/file_stream.h>
+#include <root/io/mapped_buffer.h>
+
+#include <cstdio>
+#include <cstring>
+
+/**
+ * root_logdecode <log file>
+ *
+ * Prints the messages in a file written by binary_logger as text, oldest
+ * first.
+ */
+int main(int argc, char** argv) {
+    if(argc != 2) {
+        fprintf(stderr, "Usage: %s <log file>\n", argv[0]);
+        return 1;
+    }
+    const char* path = argv[1];
+    root::mapped_buffer log_file(root::string_view(path, 0, strlen(path)));
+    if(!log_file) {
+        fprintf(stderr, "Could not open %s\n", path);
+        return 1;
+    }
+    root::file_stream stream(stdout);
+    root::writer out(&stream);
+    if(root::binary_log::decode(log_file.data(), log_file.size(), out) != root::error::NO_ERROR) {
+        fprintf(stderr, "%s is not a binary log\n", path);
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020  Fernando Escribano Macias 
+ *
+ * This file is part of the Root Engine.
+ * 
+ * The Root Engine is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Root Engine is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with The Root Engine.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <root/asset/archive.h>
+#include <root/asset/archive_builder.h>
+#include <root/io/file_stream.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+/**
+ * root_pack [--compress] <asset directory> <archive>
+ *
+ * Packs every file under the asset directory into an archive, with ids being
+ * the paths relative to that directory. With --compress every asset that
+ * shrinks is stored compressed.
+ */
+int main(int argc, char** argv) {
+    const bool compress = argc == 4 && strcmp(argv[1], "--compress") == 0;
+    if(argc != 3 && !compress) {
+        fprintf(stderr, "Usage: %s [--compress] <asset directory> <archive>\n", argv[0]);
+        return 1;
+    }
+    const char* directory = argv[argc - 2];
+    const char* archive_path = argv[argc - 1];
+    const std::filesystem::path root_dir(directory);
+    root::archive_builder builder;
+    for(const auto& item : std::filesystem::recursive_directory_iterator(root_dir)) {
+        if(!item.is_regular_file()) continue;
+        // Ids always use forward slashes, whatever the host uses
+        const std::string id = item.path().lexically_relative(root_dir).generic_string();
+        const root::u64 size = item.file_size();
+        root::buffer data;
+        if(size) {
+            FILE* file = fopen(item.path().string().c_str(), "rb");
+            if(!file) {
+                fprintf(stderr, "Could not open %s\n", item.path().string().c_str());
+                return 1;
+            }
+            data = root::buffer(size);
+            root::file_stream stream(file);
+            root::value_or_error<root::u64> read = stream.read(data, size);
+            fclose(file);
+            if(!read.has_value() || read.value() != size) {
+                fprintf(stderr, "Could not read %s\n", item.path().string().c_str());
+                return 1;
+            }
+        }
+        builder.add(root::string_view(id.c_str(), 0, id.size()), std::move(data), compress);
+    }
+
+    FILE* out = fopen(archive_path, "wb");
+    if(!out) {
+        fprintf(stderr, "Could not create %s\n", archive_path);
+        return 1;
+    }
+    root::file_stream stream(out);
+    const root::error result = builder.write(stream);
+    fclose(out);
+    if(result != root::error::NO_ERROR) {
+        fprintf(stderr, "Could not write %s\n", archive_path);
+        return 1;
+    }
+
+    root::archive packed(root::string_view(archive_path, 0, strlen(archive_path)));
+    if(!packed || !packed.verify()) {
+        fprintf(stderr, "%s failed verification\n", archive_path);
+        return 1;
+    }
+    printf("Packed %llu assets into %s, %llu bytes of data\n", builder.count(), archive_path, builder.stored_size());
+    return 0;
+}
\ No newline at end of file
@@ -3,7 +3,9 @@
 
 #include <root/io/log.h>
 
+using namespace root::literals;
+
 void root_main(struct android_app* state){
-    root::log::d("root_main", "Test");
+    root::log::d("root_main", "Test"_fmt);
     root::graphics::init();
 }
\ No newline at end of file
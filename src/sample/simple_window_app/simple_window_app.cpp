@@ -44,8 +44,10 @@
 #include <GLFW/glfw3.h>
 #endif
 
+using namespace root::literals;
+
 int root_main(int arg_c, char** arg_v) {
-    root::log::d("", "swapchain created viewport {} scissor {}", root::graphics::swapchain::get_default()->viewport(), root::graphics::swapchain::get_default()->scissor());
+    root::log::d("", "swapchain created viewport {} scissor {}"_fmt, root::graphics::swapchain::get_default()->viewport(), root::graphics::swapchain::get_default()->scissor());
 
     root::graphics::shader_module vert(*root::graphics::device::get_default(), "vert.spv");
     root::graphics::shader_module frag(*root::graphics::device::get_default(), "frag.spv");
@@ -77,7 +79,7 @@ int root_main(int arg_c, char** arg_v) {
                 root::graphics::swapchain::get_default()->extent()
             )
         );
-        root::log::d("", "Framebuffer[{}] extent {} ", i, framebuffers[i].entent());
+        root::log::d("", "Framebuffer[{}] extent {} "_fmt, i, framebuffers[i].entent());
     }
 
     root::graphics::command_pool command_pool(*root::graphics::device::get_default());
@@ -111,7 +113,7 @@ int root_main(int arg_c, char** arg_v) {
         submit_info.pSignalSemaphores = &(present_s.handle());
         VkResult submit_result = vkQueueSubmit(root::graphics::device::get_default()->get_graphics_queue(), 1, &submit_info, VK_NULL_HANDLE);
         if (submit_result != VK_SUCCESS) {
-            root::log::e("simple_window_app", "vkQueueSubmit failed with {}", submit_result);
+            root::log::e("simple_window_app", "vkQueueSubmit failed with {}"_fmt, submit_result);
             abort();
         }
         root::graphics::swapchain::get_default()->present(root::array_slice<root::graphics::semaphore>(&present_s, 1), image);